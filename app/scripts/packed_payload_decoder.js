@@ -0,0 +1,220 @@
+/*
+Packed Payload Decoder
+Decodes LoRaWAN uplinks encoded with the PACKED_BINARY encoding level. It can be used
+as an uplink payload formatter in The Things Stack and as a codec in ChirpStack.
+
+Each uplink joins one or more frames, one after the other. Every frame starts with a
+byte holding its data type, as in enum DataType (abstraction_service.h). Sensor frames
+follow it with the timestamp as a varint: groups of 7 bits, least significant first,
+where the highest bit of each byte is set if another one follows. The fields of each
+data type come next, in little-endian fixed-point. Text frames have no timestamp,
+only a byte with the text length followed by the text. BMI160 batch frames follow
+the timestamp with the milliseconds of the first sample and the sample period in
+microseconds, 2 bytes each, the number of samples in 1 byte and the samples, laid
+out as the fields of BMI160 frames. Summary frames follow the timestamp with the
+summarized data type and field, 1 byte each, the number of readings in 2 bytes, and
+the minimum, maximum, mean and standard deviation of the field in 4 bytes each.
+*/
+
+var TEXT_DATA = 0;
+var BMI160_BATCH_DATA = 1;
+var SUMMARY_DATA = 2;
+
+// Fields of each sensor data type, in the order they are encoded,
+// with size in bytes, signedness and scale
+var FRAME_FIELDS = {
+  1: { name: "bmi160_batch" },
+  2: { name: "summary" },
+  5: {
+    name: "bme280",
+    fields: [
+      { name: "pressure_kpa", size: 3, signed: false, scale: 1000 },
+      { name: "temperature_c", size: 2, signed: true, scale: 100 },
+      { name: "humidity_rh", size: 2, signed: false, scale: 100 },
+    ],
+  },
+  6: {
+    name: "bmi160",
+    fields: [
+      { name: "acceleration_x_ms2", size: 2, signed: true, scale: 100 },
+      { name: "acceleration_y_ms2", size: 2, signed: true, scale: 100 },
+      { name: "acceleration_z_ms2", size: 2, signed: true, scale: 100 },
+      { name: "rotation_x_rads", size: 2, signed: true, scale: 500 },
+      { name: "rotation_y_rads", size: 2, signed: true, scale: 500 },
+      { name: "rotation_z_rads", size: 2, signed: true, scale: 500 },
+    ],
+  },
+  7: {
+    name: "si1133",
+    fields: [
+      { name: "light_lux", size: 3, signed: false, scale: 1 },
+      { name: "infrared_lux", size: 3, signed: false, scale: 1 },
+      { name: "uv", size: 2, signed: false, scale: 1 },
+      { name: "uv_index", size: 2, signed: false, scale: 100 },
+    ],
+  },
+  8: {
+    name: "vbatt",
+    fields: [{ name: "voltage_v", size: 2, signed: false, scale: 1000 }],
+  },
+  9: {
+    name: "scd30",
+    fields: [
+      { name: "co2_ppm", size: 2, signed: false, scale: 1 },
+      { name: "temperature_c", size: 2, signed: true, scale: 100 },
+      { name: "humidity_rh", size: 2, signed: false, scale: 100 },
+    ],
+  },
+  10: {
+    name: "gnss",
+    fields: [
+      { name: "latitude", size: 4, signed: true, scale: 10000000 },
+      { name: "longitude", size: 4, signed: true, scale: 10000000 },
+      { name: "bearing", size: 2, signed: false, scale: 100 },
+      { name: "speed_ms", size: 2, signed: false, scale: 100 },
+      { name: "altitude_m", size: 4, signed: true, scale: 100 },
+      { name: "utc_hour", size: 1, signed: false, scale: 1 },
+      { name: "utc_minute", size: 1, signed: false, scale: 1 },
+      { name: "utc_second", size: 1, signed: false, scale: 1 },
+      { name: "utc_day", size: 1, signed: false, scale: 1 },
+      { name: "utc_month", size: 1, signed: false, scale: 1 },
+      { name: "utc_year", size: 1, signed: false, scale: 1 },
+    ],
+  },
+};
+
+function readInteger(bytes, offset, size, signed) {
+  var value = 0;
+  for (var i = size - 1; i >= 0; i--) {
+    value = value * 256 + bytes[offset + i];
+  }
+  if (signed && value >= Math.pow(2, 8 * size - 1)) {
+    value -= Math.pow(2, 8 * size);
+  }
+  return value;
+}
+
+// Returns the frames of an uplink, or throws if it is malformed
+function decodeFrames(bytes) {
+  var frames = [];
+  var offset = 0;
+
+  while (offset < bytes.length) {
+    var dataType = bytes[offset++];
+
+    if (dataType === TEXT_DATA) {
+      var length = bytes[offset++];
+      if (length === undefined || offset + length > bytes.length) {
+        throw new Error("Truncated text frame at byte " + (offset - 1));
+      }
+      frames.push({
+        type: "text",
+        text: String.fromCharCode.apply(null, bytes.slice(offset, offset + length)),
+      });
+      offset += length;
+      continue;
+    }
+
+    var format = FRAME_FIELDS[dataType];
+    if (format === undefined) {
+      throw new Error("Unknown data type " + dataType + " at byte " + (offset - 1));
+    }
+    var frame = { type: format.name, timestamp: 0 };
+    var shift = 1;
+    var varintByte;
+    do {
+      varintByte = bytes[offset++];
+      if (varintByte === undefined) {
+        throw new Error("Truncated timestamp of " + format.name + " frame");
+      }
+      frame.timestamp += (varintByte & 0x7f) * shift;
+      shift *= 128;
+    } while (varintByte & 0x80);
+
+    if (dataType === BMI160_BATCH_DATA) {
+      offset = decodeBatch(bytes, offset, frame);
+    } else if (dataType === SUMMARY_DATA) {
+      offset = decodeSummary(bytes, offset, frame);
+    } else {
+      offset = decodeFields(bytes, offset, format, frame);
+    }
+    frames.push(frame);
+  }
+  return frames;
+}
+
+// Reads the fields of format into frame, returning the offset after them
+function decodeFields(bytes, offset, format, frame) {
+  for (var i = 0; i < format.fields.length; i++) {
+    var field = format.fields[i];
+    if (offset + field.size > bytes.length) {
+      throw new Error("Truncated " + format.name + " frame");
+    }
+    frame[field.name] = readInteger(bytes, offset, field.size, field.signed) / field.scale;
+    offset += field.size;
+  }
+  return offset;
+}
+
+// Reads the statistics of a summary into frame, named and scaled
+// as the summarized field, returning the offset after them
+function decodeSummary(bytes, offset, frame) {
+  if (offset + 20 > bytes.length) {
+    throw new Error("Truncated summary frame");
+  }
+  var source = FRAME_FIELDS[bytes[offset]];
+  var field = source && source.fields ? source.fields[bytes[offset + 1]] : undefined;
+  if (field === undefined) {
+    throw new Error("Unknown summarized field at byte " + offset);
+  }
+
+  frame.source = source.name;
+  frame.field = field.name;
+  frame.count = readInteger(bytes, offset + 2, 2, false);
+  frame.min = readInteger(bytes, offset + 4, 4, true) / field.scale;
+  frame.max = readInteger(bytes, offset + 8, 4, true) / field.scale;
+  frame.mean = readInteger(bytes, offset + 12, 4, true) / field.scale;
+  frame.std_dev = readInteger(bytes, offset + 16, 4, false) / field.scale;
+  return offset + 20;
+}
+
+// Reads the samples of a BMI160 batch into frame, each with its own timestamp
+// in seconds, returning the offset after them
+function decodeBatch(bytes, offset, frame) {
+  if (offset + 5 > bytes.length) {
+    throw new Error("Truncated bmi160_batch frame");
+  }
+  var firstSampleMs = readInteger(bytes, offset, 2, false);
+  var periodUs = readInteger(bytes, offset + 2, 2, false);
+  var numSamples = bytes[offset + 4];
+  offset += 5;
+
+  frame.sample_period_us = periodUs;
+  frame.samples = [];
+  for (var i = 0; i < numSamples; i++) {
+    var sample = {
+      timestamp: frame.timestamp + (firstSampleMs + (i * periodUs) / 1000) / 1000,
+    };
+    offset = decodeFields(bytes, offset, FRAME_FIELDS[6], sample);
+    frame.samples.push(sample);
+  }
+  return offset;
+}
+
+// The Things Stack uplink payload formatter
+function decodeUplink(input) {
+  try {
+    return { data: { frames: decodeFrames(input.bytes) } };
+  } catch (error) {
+    return { errors: [error.message] };
+  }
+}
+
+// ChirpStack v3 codec
+function Decode(fPort, bytes) {
+  return { frames: decodeFrames(bytes) };
+}
+
+if (typeof module !== "undefined") {
+  module.exports = { decodeFrames: decodeFrames, decodeUplink: decodeUplink };
+}
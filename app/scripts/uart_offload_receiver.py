@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Receives the binary frames of the UART channel and writes their records as CSV.
+
+Reads the output of a node built with CONFIG_UART_CHANNEL_FRAMES from a serial
+port, until interrupted or until no data arrives for the idle timeout, or from a
+capture file. Frames are delimited by zero bytes and encoded with COBS. Each holds
+a sequence number, records and a CRC-16/CCITT, as described in uart_frame.h.
+Records are decoded by data type, as in enum DataType (abstraction_service.h),
+and written to one CSV file per data type, with a header and values in SI units.
+Logs printed on the same UART, corrupted frames and gaps in the sequence numbers
+are counted and reported.
+
+    uart_offload_receiver.py --port /dev/ttyACM0 --baudrate 115200 --output offload
+    uart_offload_receiver.py --input capture.bin --output offload
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+TEXT_DATA = 0
+BMI160_BATCH_DATA = 1
+SUMMARY_DATA = 2
+BMI160_MODEL = 6
+
+# Raw layout of the model of each data type, little-endian, with the padding of
+# the C structs, and its fields with the scale of each one
+MODELS = {
+    BMI160_BATCH_DATA: ("bmi160_batch", "<IHHBx24h2x", []),
+    SUMMARY_DATA: ("summary", "<IBBHiiiI", []),
+    5: ("bme280", "<IihH", [
+        ("timestamp", 1), ("pressure_kpa", 1000), ("temperature_c", 100),
+        ("humidity_rh", 100)]),
+    6: ("bmi160", "<I6h", [
+        ("timestamp", 1), ("acceleration_x_ms2", 100), ("acceleration_y_ms2", 100),
+        ("acceleration_z_ms2", 100), ("rotation_x_rads", 500), ("rotation_y_rads", 500),
+        ("rotation_z_rads", 500)]),
+    7: ("si1133", "<IiiHH", [
+        ("timestamp", 1), ("light_lux", 1), ("infrared_lux", 1), ("uv", 1),
+        ("uv_index", 100)]),
+    8: ("vbatt", "<iiI", []),
+    9: ("scd30", "<IHhH2x", [
+        ("timestamp", 1), ("co2_ppm", 1), ("temperature_c", 100), ("humidity_rh", 100)]),
+    10: ("gnss", "<qqIIi4xBBHBBBxI4x", []),
+}
+
+# Fields of each sensor in the order of its binary frame, which summaries refer
+# to, with the scale of each one
+FRAME_FIELDS = {
+    5: [("pressure_kpa", 1000), ("temperature_c", 100), ("humidity_rh", 100)],
+    6: [("acceleration_x_ms2", 100), ("acceleration_y_ms2", 100),
+        ("acceleration_z_ms2", 100), ("rotation_x_rads", 500), ("rotation_y_rads", 500),
+        ("rotation_z_rads", 500)],
+    7: [("light_lux", 1), ("infrared_lux", 1), ("uv", 1), ("uv_index", 100)],
+    8: [("voltage_v", 1000)],
+    9: [("co2_ppm", 1), ("temperature_c", 100), ("humidity_rh", 100)],
+    10: [("latitude", 10000000), ("longitude", 10000000), ("bearing", 100),
+         ("speed_ms", 100), ("altitude_m", 100)],
+}
+
+
+def crc16_ccitt(seed, data):
+    """CRC-16/CCITT as computed by Zephyr's crc16_ccitt()."""
+    crc = seed
+    for byte in data:
+        e = (crc ^ byte) & 0xFF
+        f = (e ^ (e << 4)) & 0xFF
+        crc = ((crc >> 8) ^ (f << 8) ^ (f << 3) ^ (f >> 4)) & 0xFFFF
+    return crc
+
+
+def cobs_decode(encoded):
+    """Returns the decoded bytes, or None if the encoding is invalid."""
+    decoded = bytearray()
+    i = 0
+    while i < len(encoded):
+        code = encoded[i]
+        if code == 0 or i + code > len(encoded):
+            return None
+        decoded += encoded[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(encoded):
+            decoded.append(0)
+    return bytes(decoded)
+
+
+def scaled(value, scale):
+    """Keeps integers without a scale, such as timestamps, as integers."""
+    return value if scale == 1 else value / scale
+
+
+def decode_record(data_type, raw):
+    """Returns the data type name and the rows of a record."""
+    if data_type == TEXT_DATA:
+        return "text", [{"text": raw.split(b"\0", 1)[0].decode("utf-8", "replace")}]
+    if data_type not in MODELS:
+        raise ValueError(f"unknown data type {data_type}")
+    name, layout, fields = MODELS[data_type]
+    values = struct.unpack_from(layout, raw)
+
+    if data_type == BMI160_BATCH_DATA:
+        # Samples share the timestamp of the batch, in seconds
+        timestamp, first_sample_ms, period_us, num_samples = values[:4]
+        rows = []
+        for i in range(min(num_samples, 4)):
+            row = {"timestamp": timestamp + (first_sample_ms + i * period_us / 1000) / 1000}
+            for j, (field, scale) in enumerate(MODELS[BMI160_MODEL][2][1:]):
+                row[field] = values[4 + i * 6 + j] / scale
+            rows.append(row)
+        return name, rows
+    if data_type == SUMMARY_DATA:
+        timestamp, source_type, field, count, minimum, maximum, mean, std_dev = values
+        source = FRAME_FIELDS.get(source_type, [])
+        field_name, scale = source[field] if field < len(source) else (str(field), 1)
+        source_name = MODELS[source_type][0] if source_type in MODELS else str(source_type)
+        return name, [{"timestamp": timestamp, "source": source_name, "field": field_name,
+                       "count": count, "min": scaled(minimum, scale),
+                       "max": scaled(maximum, scale), "mean": scaled(mean, scale),
+                       "std_dev": scaled(std_dev, scale)}]
+    if name == "vbatt":
+        val1, val2, timestamp = values
+        return name, [{"timestamp": timestamp, "voltage_v": round(val1 + val2 / 1e6, 6)}]
+    if name == "gnss":
+        (latitude, longitude, bearing, speed, altitude, hour, minute, millisecond,
+         month_day, month, century_year, timestamp) = values
+        return name, [{"timestamp": timestamp, "latitude": latitude / 1e9,
+                       "longitude": longitude / 1e9, "bearing": bearing / 1000,
+                       "speed_ms": speed / 1000, "altitude_m": altitude / 1000,
+                       "utc": f"20{century_year:02d}-{month:02d}-{month_day:02d}T"
+                              f"{hour:02d}:{minute:02d}:{millisecond / 1000:06.3f}Z"}]
+    return name, [{field: scaled(value, scale) for (field, scale), value in zip(fields, values)}]
+
+
+class Receiver:
+    def __init__(self, output):
+        self.output = output
+        self.writers = {}
+        self.files = []
+        self.sequence = None
+        self.frames = 0
+        self.records = 0
+        self.bytes = 0
+        self.discarded = 0
+        self.corrupted = 0
+        self.lost = 0
+
+    def write(self, name, row):
+        if name not in self.writers:
+            csv_file = open(os.path.join(self.output, name + ".csv"), "w", newline="",
+                            encoding="utf-8")
+            self.files.append(csv_file)
+            self.writers[name] = csv.DictWriter(csv_file, fieldnames=list(row))
+            self.writers[name].writeheader()
+        self.writers[name].writerow(row)
+
+    def handle_frame(self, encoded):
+        self.bytes += len(encoded) + 1
+        frame = cobs_decode(encoded)
+        # Text, such as logs, isn't valid COBS or is too short for a frame
+        if frame is None or len(frame) < 4:
+            self.discarded += 1
+            return
+        if crc16_ccitt(0xFFFF, frame[:-2]) != struct.unpack_from("<H", frame[-2:])[0]:
+            self.corrupted += 1
+            return
+
+        sequence = struct.unpack_from("<H", frame)[0]
+        if self.sequence is not None:
+            self.lost += (sequence - self.sequence - 1) & 0xFFFF
+        self.sequence = sequence
+        self.frames += 1
+
+        offset = 2
+        while offset + 2 <= len(frame) - 2:
+            data_type, size = frame[offset], frame[offset + 1]
+            raw = frame[offset + 2:offset + 2 + size]
+            offset += 2 + size
+            try:
+                name, rows = decode_record(data_type, raw)
+            except (ValueError, struct.error) as error:
+                print(f"frame {sequence}: {error}", file=sys.stderr)
+                continue
+            for row in rows:
+                self.write(name, row)
+            self.records += 1
+
+    def close(self):
+        for csv_file in self.files:
+            csv_file.close()
+        print(f"{self.frames} frames, {self.records} records, {self.bytes} bytes, "
+              f"{self.lost} frames lost, {self.corrupted} corrupted, "
+              f"{self.discarded} discarded")
+
+
+def read_chunks(args):
+    if args.input:
+        with open(args.input, "rb") as capture:
+            while chunk := capture.read(4096):
+                yield chunk
+        return
+
+    import serial  # pyserial, only needed to read from a port
+
+    with serial.Serial(args.port, args.baudrate, timeout=args.idle_timeout) as port:
+        while chunk := port.read(max(port.in_waiting, 1)):
+            yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port of the node")
+    source.add_argument("--input", help="file with the captured output of the node")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--idle-timeout", type=float, default=5.0,
+                        help="seconds without data after which reading stops "
+                             "(default: %(default)s)")
+    parser.add_argument("--output", default=".", help="directory of the CSV files")
+    args = parser.parse_args()
+
+    os.makedirs(args.output, exist_ok=True)
+    receiver = Receiver(args.output)
+    pending = bytearray()
+    try:
+        for chunk in read_chunks(args):
+            pending += chunk
+            *frames, pending = pending.split(b"\0")
+            for encoded in frames:
+                if encoded:
+                    receiver.handle_frame(encoded)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        receiver.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
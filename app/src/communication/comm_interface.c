@@ -1,6 +1,9 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <communication/comm_interface.h>
+#if defined(CONFIG_ENCODE_CACHE)
+#include <communication/encode_cache/encode_cache.h>
+#endif /* CONFIG_ENCODE_CACHE */
 #include <communication/uart/uart_interface.h>
 #include <communication/lorawan/lorawan_interface.h>
 
@@ -10,27 +13,58 @@ LOG_MODULE_REGISTER(comm_interface, CONFIG_APP_LOG_LEVEL);
  * DEFINITIONS
  */
 
-struct k_sem data_ready_sem[MAX_CHANNELS];
-struct k_sem data_processed;
-CommunicationUnit data_unit;
+// Semaphores that wake up channels when there is new data for them
+static struct k_sem data_ready_sem[MAX_CHANNELS];
 // List of registered communication APIs
 static ChannelAPI *channel_apis[MAX_CHANNELS] = {0};
+// Reading cursor of each registered channel in the application buffer
+static int channel_cursors[MAX_CHANNELS];
 // Stack of reading buffer thread
 static K_THREAD_STACK_DEFINE(read_buffer_thread_stack_area, READ_BUFFER_THREAD_STACK_SIZE);
 // Thread control block - metadata
 static struct k_thread read_buffer_thread_data;
 static k_tid_t read_buffer_thread_id;
-// Time between transmissions
-// #TODO: Make it configurable from module that receives commands
-// #TODO: Make it configurable per communication channel
+// Default time between transmissions
 static int current_transmission_interval = CONFIG_TRANSMISSION_INTERVAL;
 
+// When each channel is woken up, from the triggers it declared
+typedef struct
+{
+    int transmission_interval;
+    uint32_t batch_trigger_words;
+    int max_latency;
+    // Uptime of the next transmission at the interval
+    int64_t next_transmission;
+    // Uptime when unread data was first found for the channel, or 0 if there is none
+    int64_t pending_since;
+} ChannelSchedule;
+
+static ChannelSchedule channel_schedules[MAX_CHANNELS];
+// Guards the schedules, which the shell changes while the reading thread follows them
+static struct k_spinlock schedules_lock;
+
+#if defined(CONFIG_BUFFER_COMPRESSION)
+// Records of a compressed block are got all at once by a channel
+BUILD_ASSERT(CONFIG_TRANSMISSION_BATCH_SIZE >= CONFIG_BUFFER_COMPRESSION_BLOCK_RECORDS,
+             "TRANSMISSION_BATCH_SIZE must fit the records of a compressed block");
+#endif /* CONFIG_BUFFER_COMPRESSION */
+
+#if !defined(CONFIG_ENCODE_CACHE)
+// Encoding each channel got last, aligned so it can be stored as 32-bit words
+static uint8_t channel_encoded_data[MAX_CHANNELS][CONFIG_ENCODE_CACHE_ITEM_SIZE] __aligned(4);
+#endif /* !CONFIG_ENCODE_CACHE */
+
 // Initializes all registered channels and synchronization structures
 static int init_channels();
 // Starts communication work - getting from buffer and waking up channels
 static void start_communication();
 // Retrieves data from buffer and handles synchronization
 static void read_and_notify(void *, void *, void *);
+// Returns the uptime when the reading thread must next check the channels,
+// or INT64_MAX if there are none
+static int64_t get_next_wake_up(int64_t now);
+// Wakes up the channels whose interval expired or whose triggers fired
+static void notify_channels(int64_t now);
 
 /**
  * IMPLEMENTATIONS
@@ -48,6 +82,17 @@ int register_comm_callbacks()
     channel_apis[LORAWAN] = register_lorawan_callbacks();
 #endif /* CONFIG_SEND_LORAWAN */
 
+#if defined(CONFIG_ENCODE_CACHE)
+    // Records are only cached for the encoding levels channels share
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (channel_apis[i] != NULL)
+        {
+            register_cache_holder(i, channel_apis[i]->encoding);
+        }
+    }
+#endif /* CONFIG_ENCODE_CACHE */
+
     return 0;
 }
 
@@ -65,9 +110,7 @@ int init_communication()
 int init_channels()
 {
     LOG_DBG("Initializing communication channels");
-    // Counts registered channels so reading buffer thread can know when
-    // all of them have already processed the data
-    int registered_comm_channels = 0, error = 0;
+    int error = 0;
     // Calls init channel function for each registered API
     for (int i = 0; i < MAX_CHANNELS; i++)
     {
@@ -80,16 +123,32 @@ int init_channels()
                 LOG_ERR("Failed to initialize data ready semaphore: %d", error);
                 return error;
             }
-            channel_apis[i]->init_channel();
-            registered_comm_channels++;
+            // Each channel consumes the buffer at its own pace
+            channel_cursors[i] = register_buffer_cursor();
+            if (channel_cursors[i] < 0)
+            {
+                LOG_ERR("Failed to register buffer cursor: %d", channel_cursors[i]);
+                return channel_cursors[i];
+            }
+            channel_schedules[i] = (ChannelSchedule){
+                .transmission_interval = channel_apis[i]->transmission_interval > 0
+                                             ? channel_apis[i]->transmission_interval
+                                             : current_transmission_interval,
+                .batch_trigger_words = channel_apis[i]->batch_trigger_words,
+                .max_latency = channel_apis[i]->max_latency,
+            };
+            channel_schedules[i].next_transmission =
+                k_uptime_get() + channel_schedules[i].transmission_interval;
+            error = channel_apis[i]->init_channel();
+            // A cursor nobody reads would hold every item in the buffer
+            if (error)
+            {
+                LOG_ERR("Failed to initialize channel %d: %d", i, error);
+                unregister_buffer_cursor(channel_cursors[i]);
+                channel_apis[i] = NULL;
+            }
         }
     }
-    error = k_sem_init(&data_processed, 0, registered_comm_channels);
-    if (error)
-    {
-        LOG_ERR("Failed to initialize data processed semaphore: %d", error);
-        return error;
-    }
 
     return 0;
 }
@@ -118,40 +177,147 @@ static void read_and_notify(void *param0, void *param1, void *param2)
 
     while (1)
     {
-        // Waits for specified time
-        k_sleep(K_MSEC(current_transmission_interval));
-        // After waking up, transmits until buffer is empty
-        while (buffer_is_empty(&app_buffer) == false)
+        // Waits until the next channel is due, merging producers' lanes
+        // earlier whenever one of them is filling up
+        int64_t wake_up = get_next_wake_up(k_uptime_get());
+        merge_buffer_lanes(wake_up == INT64_MAX ? K_FOREVER : K_TIMEOUT_ABS_MS(wake_up));
+        notify_channels(k_uptime_get());
+    }
+}
+
+static int64_t get_next_wake_up(int64_t now)
+{
+    int64_t wake_up = INT64_MAX;
+    k_spinlock_key_t key = k_spin_lock(&schedules_lock);
+
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        ChannelSchedule *schedule = &channel_schedules[i];
+
+        if (channel_apis[i] == NULL)
+        {
+            continue;
+        }
+        wake_up = MIN(wake_up, schedule->next_transmission);
+        if (schedule->max_latency > 0)
+        {
+            // Lanes are merged at least this often, so data waiting for the channel is seen
+            wake_up = MIN(wake_up, schedule->pending_since > 0
+                                       ? schedule->pending_since + schedule->max_latency
+                                       : now + schedule->max_latency);
+        }
+    }
+    k_spin_unlock(&schedules_lock, key);
+    return wake_up;
+}
+
+static void notify_channels(int64_t now)
+{
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        ChannelSchedule *schedule = &channel_schedules[i];
+        bool interval_expired, notify = false;
+        uint32_t unread_words;
+        k_spinlock_key_t key;
+
+        if (channel_apis[i] == NULL)
+        {
+            continue;
+        }
+        unread_words = get_cursor_unread_words(channel_cursors[i]);
+        key = k_spin_lock(&schedules_lock);
+        interval_expired = now >= schedule->next_transmission;
+        if (unread_words == 0)
         {
-            if (get_from_buffer(&app_buffer, data_unit.data_words, &data_unit.data_type, NULL) == 0)
+            schedule->pending_since = 0;
+            if (interval_expired)
             {
-                // Notifies each registered channel that a new data unit is ready
-                for (int i = 0; i < MAX_CHANNELS; i++)
-                {
-                    if (channel_apis[i] != NULL)
-                    {
-                        k_sem_give(&data_ready_sem[i]);
-                    }
-                }
-
-                // Waits until all registered channels have processed the data unit
-                for (int i = 0; i < MAX_CHANNELS; i++)
-                {
-                    if (channel_apis[i] != NULL)
-                    {
-                        k_sem_take(&data_processed, K_FOREVER);
-                    }
-                }
+                schedule->next_transmission = now + schedule->transmission_interval;
             }
+            k_spin_unlock(&schedules_lock, key);
+            continue;
+        }
+        if (schedule->pending_since == 0)
+        {
+            schedule->pending_since = now;
+        }
+
+        if (interval_expired ||
+            (schedule->batch_trigger_words > 0 &&
+             unread_words >= schedule->batch_trigger_words) ||
+            (schedule->max_latency > 0 &&
+             now - schedule->pending_since >= schedule->max_latency))
+        {
+            // Channel transmits until its cursor reaches the end of the buffer,
+            // and its interval restarts
+            notify = true;
+            schedule->pending_since = 0;
+            schedule->next_transmission = now + schedule->transmission_interval;
+        }
+        k_spin_unlock(&schedules_lock, key);
+        if (notify)
+        {
+            k_sem_give(&data_ready_sem[i]);
         }
     }
 }
 
+int get_channel_data(enum ChannelType channel, CommunicationUnit *units, int max_units)
+{
+    int num_units;
+    // Waits for the reading thread if the channel has already read everything
+    while ((num_units = peek_buffer_items(channel_cursors[channel], units, max_units)) == 0)
+    {
+        k_sem_take(&data_ready_sem[channel], K_FOREVER);
+    }
+    return num_units;
+}
+
+int get_encoded_unit(enum ChannelType channel, CommunicationUnit *unit,
+                     const uint8_t **encoded_data)
+{
+#if defined(CONFIG_ENCODE_CACHE)
+    return get_cached_encoding(unit, channel_apis[channel]->encoding, channel, encoded_data);
+#else
+    int encoded_size = encode_data(unit->data_words, unit->data_type,
+                                   channel_apis[channel]->encoding, channel_encoded_data[channel],
+                                   sizeof(channel_encoded_data[channel]));
+
+    if (encoded_size >= (int)sizeof(channel_encoded_data[channel]))
+    {
+        LOG_ERR("Encoding of %d bytes doesn't fit in channel buffer", encoded_size);
+        return -ENOMEM;
+    }
+    if (encoded_size >= 0)
+    {
+        *encoded_data = channel_encoded_data[channel];
+    }
+    return encoded_size;
+#endif /* CONFIG_ENCODE_CACHE */
+}
+
+void release_channel_data(enum ChannelType channel)
+{
+#if defined(CONFIG_ENCODE_CACHE)
+    release_cached_encoding(channel);
+#endif /* CONFIG_ENCODE_CACHE */
+    release_buffer_items(channel_cursors[channel]);
+}
+
 // Set the interval in milliseconds between transmissions
-void set_transmission_interval(int new_interval)
+int set_transmission_interval(int new_interval)
 {
+    if (new_interval <= 0)
+    {
+        return -EINVAL;
+    }
     current_transmission_interval = new_interval;
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        set_channel_transmission_interval(i, new_interval);
+    }
     LOG_DBG("Transmission interval set to %dms", new_interval);
+    return 0;
 }
 
 // Get the interval in milliseconds between transmissions
@@ -159,3 +325,37 @@ int get_transmission_interval()
 {
     return current_transmission_interval;
 }
+
+int set_channel_transmission_interval(enum ChannelType channel, int new_interval)
+{
+    if (channel >= MAX_CHANNELS || new_interval <= 0)
+    {
+        return -EINVAL;
+    }
+    if (channel_apis[channel] == NULL)
+    {
+        return -ENODEV;
+    }
+    ChannelSchedule *schedule = &channel_schedules[channel];
+    k_spinlock_key_t key = k_spin_lock(&schedules_lock);
+    schedule->transmission_interval = new_interval;
+    // A shorter interval brings the next transmission forward, a longer one applies after it
+    schedule->next_transmission = MIN(schedule->next_transmission, k_uptime_get() + new_interval);
+    k_spin_unlock(&schedules_lock, key);
+    // Reading thread may be waiting for the transmission at the previous interval
+    wake_buffer_reader();
+    LOG_DBG("Transmission interval of channel %d set to %dms", channel, new_interval);
+    return 0;
+}
+
+int get_channel_transmission_interval(enum ChannelType channel)
+{
+    if (channel >= MAX_CHANNELS || channel_apis[channel] == NULL)
+    {
+        return -ENODEV;
+    }
+    k_spinlock_key_t key = k_spin_lock(&schedules_lock);
+    int interval = channel_schedules[channel].transmission_interval;
+    k_spin_unlock(&schedules_lock, key);
+    return interval;
+}
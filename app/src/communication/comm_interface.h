@@ -23,23 +23,24 @@ enum ChannelType
 // API that all communication channels must implement
 typedef struct
 {
-    // Initializes channel and starts communication
-    void (*init_channel)();
+    // Initializes channel and starts communication. Returns 0 on success, or a negative
+    // error code if the channel can't be used, in which case it doesn't read the buffer
+    int (*init_channel)();
+    // Level the channel encodes records at, shared with the channels using the same one
+    enum EncodingLevel encoding;
+    // Milliseconds between transmissions of the channel
+    int transmission_interval;
+    // Words of unread data in the buffer that wake the channel before its interval,
+    // or 0 to only wake it at the interval
+    uint32_t batch_trigger_words;
+    // Milliseconds data can wait in the buffer before the channel is woken,
+    // or 0 to only wake it at the interval
+    int max_latency;
 } ChannelAPI;
 
 // Data unit that will be served to communication channels
 // will consist on the content and in the data type
-typedef struct
-{
-    uint32_t data_words[MAX_32_WORDS];
-    enum DataType data_type;
-} CommunicationUnit;
-
-// Semaphores to guarantee every registered channel
-// will receive and process the data unit
-extern struct k_sem data_ready_sem[MAX_CHANNELS];
-extern struct k_sem data_processed;
-extern CommunicationUnit data_unit;
+typedef BufferItem CommunicationUnit;
 
 // Initializes synchronization structures and
 // communication for all registered channels
@@ -47,9 +48,27 @@ int init_communication();
 // Registers callbacks for the used communication channels
 int register_comm_callbacks();
 
-// Get the interval in milliseconds between transmissions
+// Waits until there is data for the channel and gets up to `max_units` data units,
+// pointing directly to the application buffer. Each channel reads at its own pace
+int get_channel_data(enum ChannelType channel, CommunicationUnit *units, int max_units);
+// Gets a data unit encoded at the level the channel declared, encoded only once for all
+// channels using that level when ENCODE_CACHE is enabled. Returns the encoded size and points `encoded_data` to the
+// encoding, which must not be changed and is valid until the channel gets another one
+// or releases its data
+int get_encoded_unit(enum ChannelType channel, CommunicationUnit *unit,
+                     const uint8_t **encoded_data);
+// Releases the data units got by the channel after it processed them
+void release_channel_data(enum ChannelType channel);
+
+// Get the default interval in milliseconds between transmissions
 int get_transmission_interval();
-// Set the `interval` in milliseconds between transmissions
-void set_transmission_interval(int interval);
+// Set the `interval` in milliseconds between transmissions of every channel
+int set_transmission_interval(int interval);
+// Set the `interval` in milliseconds between transmissions of a channel. The next
+// transmission is brought forward if it was due later than `interval` from now
+int set_channel_transmission_interval(enum ChannelType channel, int interval);
+// Get the interval in milliseconds between transmissions of a channel,
+// or -ENODEV if it isn't registered
+int get_channel_transmission_interval(enum ChannelType channel);
 
 #endif /* COMM_INTERFACE_H */
\ No newline at end of file
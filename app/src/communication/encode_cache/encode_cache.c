@@ -0,0 +1,286 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <communication/comm_interface.h>
+#include <communication/encode_cache/encode_cache.h>
+
+LOG_MODULE_REGISTER(encode_cache, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+// Every channel holding an encoding still leaves one to be replaced
+BUILD_ASSERT(CONFIG_ENCODE_CACHE_ENTRIES > MAX_CHANNELS,
+             "ENCODE_CACHE_ENTRIES must be larger than the number of channels");
+
+#define NO_ENTRY -1
+
+// Record encoded at a level, identified by its content, since encoders depend only on it
+typedef struct
+{
+    uint32_t data_words[MAX_32_WORDS];
+    // Aligned, so channels can store the encoding as 32-bit words
+    uint8_t encoded_data[CONFIG_ENCODE_CACHE_ITEM_SIZE] __aligned(4);
+    int encoded_size;
+    // Hash of the content, compared before the content itself
+    uint32_t hash;
+    enum DataType data_type;
+    enum EncodingLevel encoding;
+    uint8_t num_words;
+    // Number of holders using the entry, which can only be replaced when there are none
+    uint8_t holders;
+    // Whether the entry can be found by later records with the same content
+    bool reusable;
+    // Whether a holder is encoding the record out of the mutex, so others wait for it
+    bool encoding_in_progress;
+    // Time the entry was last got, so the least recently used one is replaced
+    uint32_t last_used;
+} EncodeCacheEntry;
+
+static EncodeCacheEntry cache_entries[CONFIG_ENCODE_CACHE_ENTRIES];
+// Entry held by each holder
+static int held_entries[MAX_CHANNELS] = {[0 ... MAX_CHANNELS - 1] = NO_ENTRY};
+// Level each holder declared, and whether it did
+static enum EncodingLevel holder_encodings[MAX_CHANNELS];
+static bool registered_holders[MAX_CHANNELS];
+// Encodings of records that aren't cached, which only their holder uses
+static uint8_t holder_encoded_data[MAX_CHANNELS][CONFIG_ENCODE_CACHE_ITEM_SIZE] __aligned(4);
+static uint32_t use_count;
+static EncodeCacheStats cache_stats;
+// Guards the entries, which records are encoded into out of it
+static K_MUTEX_DEFINE(cache_mutex);
+// Signaled when an entry finishes encoding, so concurrent requests
+// for a record encode it only once
+static K_CONDVAR_DEFINE(encoded_condvar);
+
+// FNV-1a hash of the data type and content of a record
+static uint32_t hash_record(BufferItem *data_unit);
+// Returns whether two or more holders get encodings at `encoding`
+static bool is_encoding_shared(enum EncodingLevel encoding);
+// Returns the entry with the record encoded, or being encoded, at `encoding`, or NO_ENTRY
+static int find_entry(BufferItem *data_unit, enum EncodingLevel encoding, uint32_t hash);
+// Returns the least recently used entry no holder is using, or NO_ENTRY
+static int find_free_entry();
+// Encodes the record in an entry no holder is using, with the mutex taken and
+// released while encoding. Returns the entry, or NO_ENTRY if all are in use
+static int encode_in_free_entry(BufferItem *data_unit, enum EncodingLevel encoding,
+                                uint32_t hash);
+// Encodes the record in the buffer of `holder`, without caching it
+static int encode_for_holder(BufferItem *data_unit, enum EncodingLevel encoding, int holder,
+                             const uint8_t **encoded_data);
+// Releases the entry held by `holder`, with the mutex taken
+static void release_held_entry(int holder);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+static uint32_t hash_record(BufferItem *data_unit)
+{
+    const uint8_t *bytes = (const uint8_t *)data_unit->data_words;
+    uint32_t hash = 2166136261U ^ data_unit->data_type;
+
+    hash *= 16777619U;
+    for (size_t i = 0; i < SIZE_32_BIT_WORDS_TO_BYTES(data_unit->num_words); i++)
+    {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash;
+}
+
+void register_cache_holder(int holder, enum EncodingLevel encoding)
+{
+    holder_encodings[holder] = encoding;
+    registered_holders[holder] = true;
+}
+
+static bool is_encoding_shared(enum EncodingLevel encoding)
+{
+    int holders = 0;
+
+    for (int i = 0; i < MAX_CHANNELS; i++)
+    {
+        if (registered_holders[i] && holder_encodings[i] == encoding)
+        {
+            holders++;
+        }
+    }
+    return holders >= 2;
+}
+
+static int find_entry(BufferItem *data_unit, enum EncodingLevel encoding, uint32_t hash)
+{
+    for (int i = 0; i < CONFIG_ENCODE_CACHE_ENTRIES; i++)
+    {
+        EncodeCacheEntry *entry = &cache_entries[i];
+
+        if ((entry->reusable || entry->encoding_in_progress) && entry->hash == hash &&
+            entry->encoding == encoding && entry->data_type == data_unit->data_type &&
+            entry->num_words == data_unit->num_words &&
+            memcmp(entry->data_words, data_unit->data_words,
+                   SIZE_32_BIT_WORDS_TO_BYTES(data_unit->num_words)) == 0)
+        {
+            return i;
+        }
+    }
+    return NO_ENTRY;
+}
+
+static int find_free_entry()
+{
+    int free_entry = NO_ENTRY;
+
+    for (int i = 0; i < CONFIG_ENCODE_CACHE_ENTRIES; i++)
+    {
+        if (cache_entries[i].holders == 0 &&
+            (free_entry == NO_ENTRY ||
+             (int32_t)(cache_entries[i].last_used - cache_entries[free_entry].last_used) < 0))
+        {
+            free_entry = i;
+        }
+    }
+    return free_entry;
+}
+
+int get_cached_encoding(BufferItem *data_unit, enum EncodingLevel encoding, int holder,
+                        const uint8_t **encoded_data)
+{
+    // Records too large to be compared are encoded every time
+    if (!is_encoding_shared(encoding) || data_unit->num_words > MAX_32_WORDS)
+    {
+        return encode_for_holder(data_unit, encoding, holder, encoded_data);
+    }
+    uint32_t hash = hash_record(data_unit);
+    EncodeCacheEntry *entry;
+    int entry_index;
+
+    k_mutex_lock(&cache_mutex, K_FOREVER);
+    release_held_entry(holder);
+
+    entry_index = find_entry(data_unit, encoding, hash);
+    while (entry_index != NO_ENTRY && cache_entries[entry_index].encoding_in_progress)
+    {
+        // Entry may be replaced or fail to encode while waiting, so it's looked up again
+        k_condvar_wait(&encoded_condvar, &cache_mutex, K_FOREVER);
+        entry_index = find_entry(data_unit, encoding, hash);
+    }
+    if (entry_index != NO_ENTRY)
+    {
+        cache_stats.hits++;
+    }
+    else
+    {
+        entry_index = encode_in_free_entry(data_unit, encoding, hash);
+    }
+    if (entry_index == NO_ENTRY)
+    {
+        k_mutex_unlock(&cache_mutex);
+        LOG_WRN("No free entry in encode cache");
+        return encode_for_holder(data_unit, encoding, holder, encoded_data);
+    }
+    entry = &cache_entries[entry_index];
+    entry->last_used = use_count++;
+
+    if (entry->encoded_size >= (int)sizeof(entry->encoded_data))
+    {
+        LOG_ERR("Encoding of %d bytes doesn't fit in cache entry", entry->encoded_size);
+        k_mutex_unlock(&cache_mutex);
+        return -ENOMEM;
+    }
+    if (entry->encoded_size < 0)
+    {
+        k_mutex_unlock(&cache_mutex);
+        return entry->encoded_size;
+    }
+    entry->holders++;
+    held_entries[holder] = entry_index;
+    *encoded_data = entry->encoded_data;
+    k_mutex_unlock(&cache_mutex);
+    return entry->encoded_size;
+}
+
+static int encode_in_free_entry(BufferItem *data_unit, enum EncodingLevel encoding,
+                                uint32_t hash)
+{
+    int entry_index = find_free_entry();
+    EncodeCacheEntry *entry;
+
+    if (entry_index == NO_ENTRY)
+    {
+        return NO_ENTRY;
+    }
+    entry = &cache_entries[entry_index];
+    entry->hash = hash;
+    entry->data_type = data_unit->data_type;
+    entry->encoding = encoding;
+    entry->num_words = data_unit->num_words;
+    memcpy(entry->data_words, data_unit->data_words,
+           SIZE_32_BIT_WORDS_TO_BYTES(data_unit->num_words));
+    // Held while encoding, so the entry isn't replaced, and found by
+    // requests for the same record, which wait for it
+    entry->reusable = false;
+    entry->encoding_in_progress = true;
+    entry->holders++;
+    k_mutex_unlock(&cache_mutex);
+
+    entry->encoded_size = encode_data(data_unit->data_words, data_unit->data_type, encoding,
+                                      entry->encoded_data, sizeof(entry->encoded_data));
+
+    k_mutex_lock(&cache_mutex, K_FOREVER);
+    entry->holders--;
+    entry->encoding_in_progress = false;
+    // Records that failed are encoded every time
+    entry->reusable = entry->encoded_size >= 0 &&
+                      entry->encoded_size < sizeof(entry->encoded_data);
+    cache_stats.misses++;
+    k_condvar_broadcast(&encoded_condvar);
+    return entry_index;
+}
+
+static int encode_for_holder(BufferItem *data_unit, enum EncodingLevel encoding, int holder,
+                             const uint8_t **encoded_data)
+{
+    int encoded_size;
+
+    k_mutex_lock(&cache_mutex, K_FOREVER);
+    release_held_entry(holder);
+    cache_stats.uncached++;
+    k_mutex_unlock(&cache_mutex);
+
+    encoded_size = encode_data(data_unit->data_words, data_unit->data_type, encoding,
+                               holder_encoded_data[holder], sizeof(holder_encoded_data[holder]));
+    if (encoded_size >= (int)sizeof(holder_encoded_data[holder]))
+    {
+        LOG_ERR("Encoding of %d bytes doesn't fit in cache entry", encoded_size);
+        return -ENOMEM;
+    }
+    if (encoded_size >= 0)
+    {
+        *encoded_data = holder_encoded_data[holder];
+    }
+    return encoded_size;
+}
+
+static void release_held_entry(int holder)
+{
+    if (held_entries[holder] != NO_ENTRY)
+    {
+        cache_entries[held_entries[holder]].holders--;
+        held_entries[holder] = NO_ENTRY;
+    }
+}
+
+void release_cached_encoding(int holder)
+{
+    k_mutex_lock(&cache_mutex, K_FOREVER);
+    release_held_entry(holder);
+    k_mutex_unlock(&cache_mutex);
+}
+
+void get_encode_cache_stats(EncodeCacheStats *stats)
+{
+    k_mutex_lock(&cache_mutex, K_FOREVER);
+    *stats = cache_stats;
+    k_mutex_unlock(&cache_mutex);
+}
\ No newline at end of file
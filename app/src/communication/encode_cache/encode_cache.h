@@ -0,0 +1,32 @@
+#ifndef ENCODE_CACHE_H
+#define ENCODE_CACHE_H
+
+#include <integration/data_buffer/buffer_service.h>
+
+// Encodings of the records read by the channels, kept so each record is encoded
+// once for every channel using the same encoding level. Each holder, a channel,
+// holds at most one encoding at a time, which isn't replaced until released
+
+// How often records were found encoded, were encoded in the cache, or were
+// encoded for a single holder without being cached
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t uncached;
+} EncodeCacheStats;
+
+// Declares the level `holder` gets encodings at. Records are only cached for
+// levels shared by two or more holders, since no other holder would find them
+void register_cache_holder(int holder, enum EncodingLevel encoding);
+// Gets `data_unit` encoded at `encoding`, encoding it only if it isn't cached.
+// Returns the encoded size and points `encoded_data` to the encoding, which must
+// not be changed and is valid until `holder` gets another one or releases it
+int get_cached_encoding(BufferItem *data_unit, enum EncodingLevel encoding, int holder,
+                        const uint8_t **encoded_data);
+// Releases the encoding held by `holder`, if any
+void release_cached_encoding(int holder);
+// Gets how often records were found in the cache since boot
+void get_encode_cache_stats(EncodeCacheStats *stats);
+
+#endif /* ENCODE_CACHE_H */
\ No newline at end of file
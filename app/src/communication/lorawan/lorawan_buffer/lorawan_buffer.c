@@ -8,71 +8,216 @@ LOG_MODULE_REGISTER(lorawan_buffer, CONFIG_APP_LOG_LEVEL);
  * Declarations
  */
 
-// Defines the internal buffer for used to store data while waiting a previous package to be sent
-RING_BUF_ITEM_DECLARE(lorawan_internal_buffer, LORAWAN_BUFFER_SIZE);
+// Size in 32-bit words of the internal buffer of each retention class
+#define LORAWAN_CLASS_BUFFER_SIZE (LORAWAN_BUFFER_SIZE / MAX_RETENTION_CLASSES)
+// Words before the encoded data of an item, holding the uptime it was inserted at
+#define ITEM_TIME_WORDS 1
+
+// Define the internal buffers used to store data while waiting a previous package to be sent.
+// Each retention class has its own, so packages can be filled by priority, and items in
+// each of them are in the order they were read, so the oldest is always the next one
+RING_BUF_ITEM_DECLARE(lorawan_bulk_buffer, LORAWAN_CLASS_BUFFER_SIZE);
+RING_BUF_ITEM_DECLARE(lorawan_normal_buffer, LORAWAN_CLASS_BUFFER_SIZE);
+RING_BUF_ITEM_DECLARE(lorawan_critical_buffer, LORAWAN_CLASS_BUFFER_SIZE);
+static struct ring_buf *lorawan_internal_buffers[MAX_RETENTION_CLASSES] = {
+    [RETENTION_BULK] = &lorawan_bulk_buffer,
+    [RETENTION_NORMAL] = &lorawan_normal_buffer,
+    [RETENTION_CRITICAL] = &lorawan_critical_buffer,
+};
+// Protects the internal buffers, as the processing thread drops their oldest
+// items when they are full, while the sending thread reads them
+static struct k_spinlock lorawan_buffer_lock;
+// Bytes the items stored in the internal buffers will occupy in packages
+static atomic_t buffered_bytes = ATOMIC_INIT(0);
+// Items dropped because the internal buffer of their class was full
+static atomic_t dropped_items = ATOMIC_INIT(0);
+
+// Peeks into buffer to return size in bytes and uptime of insertion of its oldest item.
+// Must be called with lorawan_buffer_lock held
+static int peek_item(struct ring_buf *buffer, uint8_t *item_size, uint32_t *insertion_time);
+// Returns the class whose oldest item goes next in a package with `free_space` bytes
+// left: the class holding the oldest item past the maximum age, or else the most
+// critical one. Discards items larger than `max_package_size`, which never fit.
+// Returns -ENODATA if no item fits. Must be called with lorawan_buffer_lock held
+static int select_class_to_pack(uint8_t free_space, uint8_t max_package_size);
+// Removes the oldest item of buffer, copying it to `encoded_data` if not NULL.
+// Must be called with lorawan_buffer_lock held
+static int take_item(struct ring_buf *buffer, uint8_t *encoded_data, uint8_t *encoded_size);
 
 /**
  * Definitions
  */
 
-int encode_and_insert(CommunicationUnit data_unit)
+int encode_and_insert(CommunicationUnit *data_unit)
 {
     LOG_DBG("Encoding data item");
-    int error = 0, encoded_size = 0;
-    uint8_t encoded_data[256] = {0};
+    int encoded_size = 0;
+    const uint8_t *encoded_data;
+    uint32_t item_words[ITEM_TIME_WORDS + SIZE_BYTES_TO_32_BIT_WORDS(LORAWAN_MAX_ITEM_SIZE)];
+    uint8_t dropped_size;
+    struct ring_buf *buffer;
+    k_spinlock_key_t key;
 
-    // Encoding data to raw bytes
-    encoded_size = encode_data(data_unit.data_words, data_unit.data_type, MINIMALIST,
-                               encoded_data, sizeof(encoded_data));
+    // Encoding data to binary frames, which are self-delimiting, so they can be joined
+    encoded_size = get_encoded_unit(LORAWAN, data_unit, &encoded_data);
     if (encoded_size < 0)
     {
         LOG_ERR("Could not encode data");
         return encoded_size;
     }
+    if (encoded_size > LORAWAN_MAX_ITEM_SIZE)
+    {
+        LOG_ERR("Encoded data of %dB doesn't fit in LoRaWAN buffer item", encoded_size);
+        return -ENOMEM;
+    }
     LOG_DBG("Encoded LoRa data starting with '0x%X' and size %dB",
             encoded_data[0], encoded_size);
 
-    // Put bytes in internal buffer, casting it to 32-bit words
-    error = insert_in_buffer(&lorawan_internal_buffer, (uint32_t *)encoded_data,
-                             data_unit.data_type, 0, SIZE_BYTES_TO_32_BIT_WORDS(encoded_size));
-    return error;
+    // Put bytes in the buffer of the item's class, after the time they were inserted at,
+    // keeping the exact size in the item header, so padding bytes aren't sent
+    item_words[0] = k_uptime_get_32();
+    memcpy(&item_words[ITEM_TIME_WORDS], encoded_data, encoded_size);
+    buffer = lorawan_internal_buffers[get_data_api(data_unit->data_type)->retention_class];
+    key = k_spin_lock(&lorawan_buffer_lock);
+    while (ring_buf_item_put(buffer, data_unit->data_type, encoded_size, item_words,
+                             ITEM_TIME_WORDS + SIZE_BYTES_TO_32_BIT_WORDS(encoded_size)) != 0)
+    {
+        // Removes oldest items of the same class until new item fits
+        LOG_ERR("Failed to insert data in LoRaWAN buffer, dropping oldest item");
+        if (take_item(buffer, NULL, &dropped_size) != 0)
+        {
+            k_spin_unlock(&lorawan_buffer_lock, key);
+            return -ENOMEM;
+        }
+        atomic_inc(&dropped_items);
+    }
+    atomic_add(&buffered_bytes, encoded_size);
+    k_spin_unlock(&lorawan_buffer_lock, key);
+    return 0;
 }
 
 // Returns how many bytes the data currently stored in internal buffer would occupy in a package
-int get_buffer_to_package_size(int buffered_items)
+int get_buffer_to_package_size()
+{
+	return atomic_get(&buffered_bytes);
+}
+
+int pack_lorawan_items(uint8_t *package, uint8_t max_package_size, uint8_t *num_records)
 {
-	int internal_buffer_used_size = ring_buf_size_get(&lorawan_internal_buffer);
-	// Each item in the buffer has a 32-bit word header, which will be removed
-	internal_buffer_used_size -= SIZE_32_BIT_WORDS_TO_BYTES(buffered_items);
-	return internal_buffer_used_size;
+	k_spinlock_key_t key = k_spin_lock(&lorawan_buffer_lock);
+	uint8_t package_size = 0, item_size;
+	int retention_class;
+
+	*num_records = 0;
+	// Takes one item at a time, choosing the class again after each one, so less
+	// critical items only fill the space left unless they waited too long
+	while ((retention_class = select_class_to_pack(max_package_size - package_size,
+												   max_package_size)) >= 0)
+	{
+		take_item(lorawan_internal_buffers[retention_class], &package[package_size], &item_size);
+		package_size += item_size;
+		(*num_records)++;
+	}
+	k_spin_unlock(&lorawan_buffer_lock, key);
+
+	LOG_DBG("Packed %d items in %d of %d B", *num_records, package_size, max_package_size);
+	return package_size;
 }
 
-int get_item_word_size(uint8_t *item_size)
+int select_class_to_pack(uint8_t free_space, uint8_t max_package_size)
 {
-	// Size of item header in bytes
-	int header_size = 4;
-	uint8_t header_bytes[header_size];
-	memset(header_bytes, 0, sizeof(header_bytes));
-	// Peek into the ring buffer to get next item size
-	int peeked_size = ring_buf_peek(&lorawan_internal_buffer, header_bytes, header_size);
-	if (peeked_size != header_size)
+	uint32_t now = k_uptime_get_32(), insertion_time, age, selected_age = 0;
+	int selected_class = -ENODATA;
+	bool overdue, selected_overdue = false;
+	uint8_t item_size;
+
+	for (int i = MAX_RETENTION_CLASSES - 1; i >= 0; i--)
 	{
-		LOG_ERR("Failed to get item size");
-		return -1;
+		struct ring_buf *buffer = lorawan_internal_buffers[i];
+
+		// Item wouldn't fit even in an empty package
+		while (peek_item(buffer, &item_size, &insertion_time) == 0 &&
+			   item_size > max_package_size)
+		{
+			LOG_WRN("Item with %d B doesn't fit in package, discarding it", item_size);
+			take_item(buffer, NULL, &item_size);
+		}
+		if (ring_buf_is_empty(buffer) || item_size > free_space)
+		{
+			continue;
+		}
+		// Items past the maximum age go first, from the oldest, so a steady flow
+		// of critical items doesn't hold back the others forever
+		age = now - insertion_time;
+		overdue = CONFIG_LORAWAN_MAX_ITEM_AGE > 0 && age >= CONFIG_LORAWAN_MAX_ITEM_AGE;
+		if (selected_class < 0 || (overdue && (!selected_overdue || age > selected_age)))
+		{
+			selected_class = i;
+			selected_age = age;
+			selected_overdue = overdue;
+		}
 	}
-	// Copies size byte into item_size
-	*item_size = header_bytes[2];
+	return selected_class;
+}
+
+int peek_item(struct ring_buf *buffer, uint8_t *item_size, uint32_t *insertion_time)
+{
+	// Size of item header and insertion time in bytes
+	int peek_size = 8;
+	uint8_t peeked_bytes[peek_size];
+	memset(peeked_bytes, 0, sizeof(peeked_bytes));
+	// Peek into the ring buffer to get next item size and time
+	int peeked_size = ring_buf_peek(buffer, peeked_bytes, peek_size);
+	if (peeked_size != peek_size)
+	{
+		return -ENODATA;
+	}
+	// Copies the value byte, which holds the encoded size, into item_size
+	*item_size = peeked_bytes[3];
+	memcpy(insertion_time, &peeked_bytes[4], sizeof(*insertion_time));
 
 	return 0;
 }
 
+uint32_t get_lorawan_dropped_items()
+{
+    return atomic_get(&dropped_items);
+}
+
 bool lorawan_buffer_empty()
 {
-    return buffer_is_empty(&lorawan_internal_buffer);
+    return atomic_get(&buffered_bytes) == 0;
 }
 
-int get_lorawan_item(uint32_t *data_words, uint8_t *num_words)
+int get_lorawan_item(uint8_t *encoded_data, uint8_t *encoded_size)
 {
-    enum DataType data_type;
-    return get_from_buffer(&lorawan_internal_buffer, data_words, &data_type, num_words);
+    k_spinlock_key_t key = k_spin_lock(&lorawan_buffer_lock);
+    // Every item fits, so none is discarded
+    int error = select_class_to_pack(UINT8_MAX, UINT8_MAX);
+
+    if (error >= 0)
+    {
+        error = take_item(lorawan_internal_buffers[error], encoded_data, encoded_size);
+    }
+    k_spin_unlock(&lorawan_buffer_lock, key);
+    return error;
+}
+
+int take_item(struct ring_buf *buffer, uint8_t *encoded_data, uint8_t *encoded_size)
+{
+    uint32_t data_words[ITEM_TIME_WORDS + SIZE_BYTES_TO_32_BIT_WORDS(LORAWAN_MAX_ITEM_SIZE)];
+    uint16_t data_type;
+    uint8_t num_words = ARRAY_SIZE(data_words);
+    int error = ring_buf_item_get(buffer, &data_type, encoded_size, data_words, &num_words);
+    if (error)
+    {
+        LOG_ERR("Failed to get item from LoRaWAN buffer: %d", error);
+        return error;
+    }
+    atomic_sub(&buffered_bytes, *encoded_size);
+    if (encoded_data != NULL)
+    {
+        bytecpy(encoded_data, &data_words[ITEM_TIME_WORDS], *encoded_size);
+    }
+    return 0;
 }
@@ -3,18 +3,27 @@
 
 #include <communication/comm_interface.h>
 
-// Create an internal buffer to be able to send multiple data readings in one packet
+// Create internal buffers to be able to send multiple data readings in one packet,
+// with size in 32-bit words shared among the retention classes
 #define LORAWAN_BUFFER_SIZE 2048
+// Maximum size in bytes of an encoded item, which is kept in the 8-bit value of its header
+#define LORAWAN_MAX_ITEM_SIZE 252
 
 // Encodes data and inserts it into the internal buffer
-int encode_and_insert(CommunicationUnit data_unit);
+int encode_and_insert(CommunicationUnit *data_unit);
 // Returns how many bytes the data currently stored in internal buffer would occupy in a package
-int get_buffer_to_package_size(int buffered_items);
-// Peeks into buffer to return size of item in 32-bit words
-int get_item_word_size(uint8_t *item_size);
+int get_buffer_to_package_size();
+// Joins buffered items into `package` until no other fits in `max_package_size` bytes,
+// taking items of more critical retention classes first and the oldest items of each
+// class first, except for items older than LORAWAN_MAX_ITEM_AGE, which go before any
+// other. Returns the package size in bytes and the number of records packed
+int pack_lorawan_items(uint8_t *package, uint8_t max_package_size, uint8_t *num_records);
+// Returns how many items were dropped because the internal buffers were full
+uint32_t get_lorawan_dropped_items();
 // Checks if LoRaWAN buffer is empty
 bool lorawan_buffer_empty();
-// Gets an item from LoRaWAN internal buffer
-int get_lorawan_item(uint32_t *data_words, uint8_t *num_words);
+// Gets the next encoded item, in the order items are packed, and its size in
+// bytes from LoRaWAN internal buffers, discarding it if `encoded_data` is NULL
+int get_lorawan_item(uint8_t *encoded_data, uint8_t *encoded_size);
 
 #endif /* LORAWAN_BUFFER_H */
\ No newline at end of file
@@ -16,14 +16,16 @@ The order in which everything happens is the following:
 		It will also get the internal structures ready for use, such as the thread that process data from
 		data module buffer and the thread that will effectively send the data via LoRaWAN.
 
-	2 - Immediately after being created, the Process Data Thread is started. It will check for the signal that a data
-		item was read on the data module buffer. When data is available, the thread will encode it minimally,
-		using few characters. The encoded data is stored on the Internal Buffer for later transmission, so the
+	2 - Immediately after being created, the Process Data Thread is started. It will check for the signal that a batch of data
+		items was read on the data module buffer. When data is available, the thread will encode each item into
+		a compact binary frame, decoded on the network server by app/scripts/packed_payload_decoder.js.
+		The encoded data is stored on the Internal Buffer for later transmission, so the
 		LoRaWAN thread doesn't delay other transmissions because of its synchronous communication. Then,
-		the thread signals for the data module that the data was processed so it can continue reading other items.
+		the thread releases the items it read, so the data module can reclaim their space.
 
 	3 - The Send Data Thread is wakened up by the Process Data Thread, and will asynchronously
-		execute the actual transmission via Zephyr's send_lorawan() function.
+		execute the actual transmission via Zephyr's send_lorawan() function. Packages wait for
+		the duty-cycle budget, estimated from their time on air, and are retried when sending fails.
 
 */
 #include <zephyr/kernel.h>
@@ -31,6 +33,7 @@ The order in which everything happens is the following:
 #include <zephyr/sys/ring_buffer.h>
 #include <communication/lorawan/lorawan_interface.h>
 #include <communication/lorawan/lorawan_buffer/lorawan_buffer.h>
+#include <communication/lorawan/lorawan_scheduler/lorawan_scheduler.h>
 
 LOG_MODULE_REGISTER(lorawan_interface, CONFIG_APP_LOG_LEVEL);
 
@@ -50,31 +53,25 @@ static k_tid_t lorawan_thread_id;
 static K_THREAD_STACK_DEFINE(lorawan_send_thread_stack_area, LORAWAN_SEND_THREAD_STACK_SIZE);
 static struct k_thread lorawan_send_thread_data;
 static k_tid_t lorawan_send_thread_id;
+// Metrics of how well packages are filled
+static LoRaWANPackingStats packing_stats;
 
 // Initializes and starts thread to send data via LoRaWAN
-static void lorawan_init_channel();
+static int lorawan_init_channel();
 // Functions that receives data from application buffer and
 // inserts it in LoRaWAN internal buffer
 static void lorawan_process_data(void *, void *, void *);
-// Sends LoRaWAN package and handles errors
-static void send_package(uint8_t *package, uint8_t package_size);
+// Sends LoRaWAN package and counts it in the packing metrics
+static void send_package(uint8_t *package, uint8_t package_size, uint8_t max_payload_size,
+						 uint8_t num_records);
 // This is the function executed by the thread that actually sends the data
 static void lorawan_send_data(void *, void *, void *);
-#ifdef CONFIG_LORAWAN_JOIN_PACKET
-// Resets variables used to join packets into package
-static void reset_join_variables(uint8_t *max_payload_size, uint8_t *insert_index,
-								 uint8_t *available_package_size, uint8_t *joined_data);
-// Adds data item from buffer to package
-static void add_item_to_package(uint8_t encoded_data_word_size, uint8_t max_payload_size,
-								uint8_t *available_package_size, uint8_t *joined_data,
-								uint8_t *insert_index, uint32_t *encoded_data);
-#endif // CONFIG_LORAWAN_JOIN_PACKET
 
 /**
  * Definitions
  */
 
-static void lorawan_init_channel()
+static int lorawan_init_channel()
 {
 	LOG_DBG("Initializing LoRaWAN channel");
 	int error = 0;
@@ -109,10 +106,10 @@ static void lorawan_init_channel()
 	}
 
 return_clause:
-	return;
+	// Processing thread reads the buffer even if sending isn't set up
+	return 0;
 }
 
-int buffered_items = 0;
 // Encoding and buffering Data thread
 void lorawan_process_data(void *param0, void *param1, void *param2)
 {
@@ -122,38 +119,35 @@ void lorawan_process_data(void *param0, void *param1, void *param2)
 	ARG_UNUSED(param2);
 	uint8_t max_payload_size;
 	uint8_t unused_arg;
-
-	int error = 0;
+	CommunicationUnit data_units[CONFIG_TRANSMISSION_BATCH_SIZE];
+	int num_units;
 
 	while (1)
 	{
 		// Waits for data to be ready
-		k_sem_take(&data_ready_sem[LORAWAN], K_FOREVER);
+		num_units = get_channel_data(LORAWAN, data_units, CONFIG_TRANSMISSION_BATCH_SIZE);
 		// Maximum payload size determined by datarate and region
 		lorawan_get_payload_sizes(&unused_arg, &max_payload_size);
-		// Encodes data item to be sent and inserts the encoded data in the internal buffer
-		error = encode_and_insert(data_unit);
-		if (error)
-			continue;
-		else
-			buffered_items++;
+		// Encodes data items to be sent and inserts the encoded data in the internal buffer
+		for (int i = 0; i < num_units; i++)
+		{
+			encode_and_insert(&data_units[i]);
+		}
+		// Signals for the Communication Interface that Lorawan processing is complete
+		release_channel_data(LORAWAN);
 
 #ifdef CONFIG_LORAWAN_JOIN_PACKET
 		// If the application is joining packets into a larger package,
 		// it waits longer to wake up the sending thread, until a package with
 		// maximum payload size can be assembled
-		if (get_buffer_to_package_size(buffered_items) < max_payload_size)
+		if (get_buffer_to_package_size() < max_payload_size)
 		{
 			LOG_DBG("Joining more data");
-			// Signals for the Communication Interface that Lorawan processing is complete
-			k_sem_give(&data_processed);
 			continue;
 		}
 #endif
 		LOG_DBG("Waking up sending thread");
 		k_wakeup(lorawan_send_thread_id);
-		// Signals for the Communication Interface that Lorawan processing is complete
-		k_sem_give(&data_processed);
 	}
 }
 
@@ -165,77 +159,30 @@ void lorawan_send_data(void *param0, void *param1, void *param2)
 	ARG_UNUSED(param1);
 	ARG_UNUSED(param2);
 
-	uint8_t max_payload_size, insert_index, available_package_size, error = 0;
+	uint8_t max_payload_size, unused_arg, num_records;
 	// Maximum LoRaWAN package size won't surpass 256 B
-	uint8_t joined_data[256];
-	reset_join_variables(&max_payload_size, &insert_index, &available_package_size, joined_data);
+	uint8_t package[256];
+	int package_size;
 
 	while (1)
 	{
-		// After waking up, transmits until buffer is empty
-		while (!lorawan_buffer_empty())
+		// Maximum payload size may change with the datarate between packages
+		lorawan_get_payload_sizes(&unused_arg, &max_payload_size);
+		// After waking up, transmits while there is data to fill a package,
+		// keeping what is left to be joined with the next items
+		while (get_buffer_to_package_size() >= max_payload_size)
 		{
-			LOG_DBG("Resetting data item variables");
-			error = 0;
-			uint8_t encoded_data_word_size;
-			uint32_t encoded_data[MAX_32_WORDS];
-			memset(encoded_data, 0, sizeof(encoded_data));
-			// Peeking the size of the next item in the buffer
-			error = get_item_word_size(&encoded_data_word_size);
-			if (error)
-			{
-				encoded_data_word_size = MAX_32_WORDS;
-			}
-
-			// Sends package as the new item wouldn't fit in it and resets package variables to form a new one
-			if (available_package_size - SIZE_32_BIT_WORDS_TO_BYTES(encoded_data_word_size) < 0)
+			package_size = pack_lorawan_items(package, max_payload_size, &num_records);
+			if (package_size > 0)
 			{
-				send_package(joined_data, max_payload_size - available_package_size);
-				reset_join_variables(&max_payload_size, &insert_index,
-									 &available_package_size, joined_data);
-				continue;
+				send_package(package, package_size, max_payload_size, num_records);
 			}
-			// Get the next packet from the internal buffer
-			error = get_lorawan_item(encoded_data, &encoded_data_word_size);
-			if (error)
-			{
-				continue;
-			}
-			buffered_items--;
-			add_item_to_package(encoded_data_word_size, max_payload_size,
-								&available_package_size, joined_data,
-								&insert_index, encoded_data);
+			lorawan_get_payload_sizes(&unused_arg, &max_payload_size);
 		}
-		LOG_DBG("Buffer is empty, sleeping");
+		LOG_DBG("Not enough data to fill a package, sleeping");
 		k_sleep(K_FOREVER);
 	}
 }
-
-void reset_join_variables(uint8_t *max_payload_size, uint8_t *insert_index,
-						  uint8_t *available_package_size, uint8_t *joined_data)
-{
-	LOG_DBG("Resetting join variables");
-	uint8_t unused_arg;
-	*insert_index = 0;
-	// Resetting join package variables after last send
-	memset(joined_data, 0, 256);
-	lorawan_get_payload_sizes(&unused_arg, max_payload_size);
-	*available_package_size = *max_payload_size;
-	LOG_DBG("Maximum payload size for current datarate: %d B", *available_package_size);
-}
-
-void add_item_to_package(uint8_t encoded_data_word_size, uint8_t max_payload_size,
-						 uint8_t *available_package_size, uint8_t *joined_data,
-						 uint8_t *insert_index, uint32_t *encoded_data)
-{
-	uint8_t encoded_data_size = SIZE_32_BIT_WORDS_TO_BYTES(encoded_data_word_size);
-	// Adds packet to package
-	LOG_DBG("Adding item with size %d B to package with %d available bytes",
-			encoded_data_size, *available_package_size);
-	*insert_index = max_payload_size - *available_package_size;
-	bytecpy(joined_data + *insert_index, encoded_data, encoded_data_size);
-	*available_package_size -= encoded_data_size;
-}
 #else  // CONFIG_LORAWAN_JOIN_PACKET
 void lorawan_send_data(void *param0, void *param1, void *param2)
 {
@@ -244,27 +191,36 @@ void lorawan_send_data(void *param0, void *param1, void *param2)
 	ARG_UNUSED(param1);
 	ARG_UNUSED(param2);
 	int error;
+	uint8_t max_payload_size, unused_arg, num_records;
+	// Maximum LoRaWAN package size won't surpass 256 B
+	uint8_t package[256];
+	int package_size;
 
 	while (1)
 	{
 		// After waking up, transmits until buffer is empty
 		while (!lorawan_buffer_empty())
 		{
-			LOG_DBG("Resetting data item variables");
-			error = 0;
-			uint8_t encoded_data_size, encoded_data_word_size;
-			uint32_t encoded_data[MAX_32_WORDS];
-
-			memset(encoded_data, 0, sizeof(encoded_data));
-			encoded_data_word_size = MAX_32_WORDS;
+			lorawan_get_payload_sizes(&unused_arg, &max_payload_size);
+			// Items are joined while the duty-cycle budget doesn't allow sending them
+			// one by one, so the overhead of each uplink is paid for fewer of them
+			if (!is_airtime_available(max_payload_size))
+			{
+				package_size = pack_lorawan_items(package, max_payload_size, &num_records);
+				if (package_size > 0)
+				{
+					send_package(package, package_size, max_payload_size, num_records);
+				}
+				continue;
+			}
+			uint8_t encoded_data_size;
 			// Get the next packet from the internal buffer
-			error = get_lorawan_item(encoded_data, &encoded_data_word_size);
+			error = get_lorawan_item(package, &encoded_data_size);
 			if (error)
 			{
 				continue;
 			}
-			encoded_data_size = SIZE_32_BIT_WORDS_TO_BYTES(encoded_data_word_size);
-			send_package((uint8_t *)encoded_data, encoded_data_size);
+			send_package(package, encoded_data_size, max_payload_size, 1);
 		}
 		LOG_DBG("Buffer is empty, sleeping");
 		k_sleep(K_FOREVER);
@@ -272,16 +228,26 @@ void lorawan_send_data(void *param0, void *param1, void *param2)
 }
 #endif // CONFIG_LORAWAN_JOIN_PACKET
 
-void send_package(uint8_t *package, uint8_t package_size)
+void send_package(uint8_t *package, uint8_t package_size, uint8_t max_payload_size,
+				  uint8_t num_records)
 {
-	int error = lorawan_send(1, package, package_size, LORAWAN_MSG_UNCONFIRMED);
-	// Send using Zephyr's subsystem and check if the transmission was successful
-	if (error)
+	// Send using Zephyr's subsystem when the duty-cycle allows, retrying on failures
+	if (send_scheduled_package(package, package_size) != 0)
 	{
-		LOG_ERR("lorawan_send failed: %d.", error);
+		packing_stats.lost_packages++;
+		packing_stats.lost_records += num_records;
 		return;
 	}
-	LOG_INF("lorawan_send successful");
+	packing_stats.packages++;
+	packing_stats.records += num_records;
+	packing_stats.payload_bytes += package_size;
+	packing_stats.capacity_bytes += max_payload_size;
+	LOG_DBG("Sent %d records in %d of %d B", num_records, package_size, max_payload_size);
+}
+
+void get_lorawan_packing_stats(LoRaWANPackingStats *stats)
+{
+	*stats = packing_stats;
 }
 
 // Register channels to the Communication Module
@@ -289,5 +255,9 @@ ChannelAPI *register_lorawan_callbacks()
 {
 	LOG_DBG("Initializing lorawan callbacks");
 	lorawan_api.init_channel = lorawan_init_channel;
+	lorawan_api.encoding = PACKED_BINARY;
+	lorawan_api.transmission_interval = CONFIG_LORAWAN_TRANSMISSION_INTERVAL;
+	lorawan_api.batch_trigger_words = CONFIG_LORAWAN_BATCH_TRIGGER_WORDS;
+	lorawan_api.max_latency = CONFIG_LORAWAN_MAX_LATENCY;
 	return &lorawan_api;
 }
\ No newline at end of file
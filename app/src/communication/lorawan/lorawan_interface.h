@@ -35,9 +35,26 @@
 // The selected region must also be set in prj.conf so the correct parameters are compiled
 #define LORAWAN_SELECTED_REGION LORAWAN_REGION_LA915
 
+// Metrics of the packages sent since boot
+typedef struct
+{
+    uint32_t packages;
+    // Records joined in the packages
+    uint32_t records;
+    // Bytes sent and maximum payload sizes of the packages, whose ratio is how full they were
+    uint32_t payload_bytes;
+    uint32_t capacity_bytes;
+    // Packages, and the records in them, that couldn't be sent
+    uint32_t lost_packages;
+    uint32_t lost_records;
+} LoRaWANPackingStats;
+
 // Register lorawan callbacks
 ChannelAPI *register_lorawan_callbacks();
 
+// Gets the metrics of the packages sent
+void get_lorawan_packing_stats(LoRaWANPackingStats *stats);
+
 // Configures and initializes lorawan connection, joining the network
 int lorawan_setup_connection();
 
@@ -0,0 +1,185 @@
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <communication/lorawan/lorawan_interface.h>
+#include <communication/lorawan/lorawan_scheduler/lorawan_scheduler.h>
+
+LOG_MODULE_REGISTER(lorawan_scheduler, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * Declarations
+ */
+
+// Airtime in microseconds that can be saved up for bursts
+#define MAX_AIRTIME_CREDIT_US ((int64_t)LORAWAN_DUTY_CYCLE_WINDOW_MS * CONFIG_LORAWAN_DUTY_CYCLE)
+// Preamble symbols sent before each uplink
+#define PREAMBLE_SYMBOLS 8
+// Coding rate 4/5, with one redundancy bit for every 4 data bits
+#define CODING_RATE 1
+
+// Datarate of the next uplinks, changed by the network when ADR is on
+static enum lorawan_datarate current_datarate = LORAWAN_DR;
+// Airtime in microseconds that can be used without exceeding the duty-cycle,
+// which grows with time as a token bucket
+static int64_t airtime_credit_us = MAX_AIRTIME_CREDIT_US;
+static int64_t last_refill_time = 0;
+static LoRaWANSchedulerStats scheduler_stats;
+
+// Gets spreading factor and bandwidth of datarate in the selected region
+static void get_datarate_parameters(enum lorawan_datarate datarate, uint8_t *spreading_factor,
+                                    uint32_t *bandwidth_hz);
+// Adds to the budget the airtime earned since the last refill
+static void refill_airtime_budget();
+// Sleeps until the budget has `time_on_air` microseconds of airtime
+static void wait_for_airtime(uint32_t time_on_air);
+// Sleeps until uptime reaches `deadline` in milliseconds
+static void sleep_until(int64_t deadline);
+
+/**
+ * Definitions
+ */
+
+void set_scheduler_datarate(enum lorawan_datarate datarate)
+{
+    current_datarate = datarate;
+}
+
+void get_datarate_parameters(enum lorawan_datarate datarate, uint8_t *spreading_factor,
+                             uint32_t *bandwidth_hz)
+{
+    *bandwidth_hz = 125000;
+    switch (LORAWAN_SELECTED_REGION)
+    {
+    case LORAWAN_REGION_US915:
+        // DR0 to DR3 are SF10 to SF7, and DR4 is SF8 at 500 kHz
+        *spreading_factor = datarate <= LORAWAN_DR_3 ? 10 - datarate : 8;
+        *bandwidth_hz = datarate <= LORAWAN_DR_3 ? 125000 : 500000;
+        break;
+    case LORAWAN_REGION_EU868:
+    case LORAWAN_REGION_EU433:
+    case LORAWAN_REGION_CN779:
+    case LORAWAN_REGION_IN865:
+    case LORAWAN_REGION_KR920:
+    case LORAWAN_REGION_RU864:
+    case LORAWAN_REGION_AS923:
+        // DR0 to DR5 are SF12 to SF7, and DR6 is SF7 at 250 kHz
+        *spreading_factor = datarate <= LORAWAN_DR_5 ? 12 - datarate : 7;
+        *bandwidth_hz = datarate <= LORAWAN_DR_5 ? 125000 : 250000;
+        break;
+    default:
+        // AU915 and LA915: DR0 to DR5 are SF12 to SF7, and DR6 is SF8 at 500 kHz
+        *spreading_factor = datarate <= LORAWAN_DR_5 ? 12 - datarate : 8;
+        *bandwidth_hz = datarate <= LORAWAN_DR_5 ? 125000 : 500000;
+        break;
+    }
+}
+
+// Follows Semtech's LoRa modem designer's guide (AN1200.13), for uplinks with
+// explicit header and CRC on
+uint32_t get_time_on_air(uint8_t payload_size)
+{
+    uint8_t spreading_factor;
+    uint32_t bandwidth_hz;
+    get_datarate_parameters(current_datarate, &spreading_factor, &bandwidth_hz);
+
+    uint32_t symbol_us = BIT(spreading_factor) * USEC_PER_SEC / bandwidth_hz;
+    // Symbols are long enough to need low datarate optimization
+    int low_datarate = spreading_factor >= 11 && bandwidth_hz == 125000;
+    int payload_bits = 8 * (payload_size + LORAWAN_FRAME_OVERHEAD) - 4 * spreading_factor + 28 + 16;
+    uint32_t payload_symbols = 8;
+
+    if (payload_bits > 0)
+    {
+        payload_symbols += DIV_ROUND_UP(payload_bits, 4 * (spreading_factor - 2 * low_datarate)) *
+                           (CODING_RATE + 4);
+    }
+    // Preamble is followed by 4.25 symbols of synchronization
+    return (4 * PREAMBLE_SYMBOLS + 17) * symbol_us / 4 + payload_symbols * symbol_us;
+}
+
+bool is_airtime_available(uint8_t payload_size)
+{
+    refill_airtime_budget();
+    return airtime_credit_us >= get_time_on_air(payload_size);
+}
+
+int send_scheduled_package(uint8_t *package, uint8_t package_size)
+{
+    uint32_t time_on_air = get_time_on_air(package_size);
+    uint32_t retry_delay = LORAWAN_MIN_RETRY_DELAY_MS;
+    int error, attempts = 0;
+
+    while (true)
+    {
+        wait_for_airtime(time_on_air);
+        error = lorawan_send(1, package, package_size, LORAWAN_MSG_UNCONFIRMED);
+        if (error == 0)
+        {
+            airtime_credit_us -= time_on_air;
+            scheduler_stats.airtime_ms += time_on_air / USEC_PER_MSEC;
+            LOG_INF("lorawan_send successful, %d B in %d ms", package_size,
+                    time_on_air / USEC_PER_MSEC);
+            return 0;
+        }
+
+        // The stack is waiting for its own duty-cycle restriction, so the
+        // package is deferred without giving up on it
+        if (error == -EAGAIN)
+        {
+            scheduler_stats.restricted_attempts++;
+        }
+        else if (++attempts >= CONFIG_LORAWAN_SEND_ATTEMPTS)
+        {
+            scheduler_stats.failed_packages++;
+            LOG_ERR("lorawan_send failed: %d, dropping package after %d attempts", error, attempts);
+            return error;
+        }
+        else
+        {
+            scheduler_stats.retried_attempts++;
+        }
+        LOG_WRN("lorawan_send failed: %d, trying again in %d ms", error, retry_delay);
+        sleep_until(k_uptime_get() + retry_delay);
+        retry_delay = MIN(retry_delay * 2, LORAWAN_MAX_RETRY_DELAY_MS);
+    }
+}
+
+void refill_airtime_budget()
+{
+    int64_t now = k_uptime_get();
+
+    // Each millisecond earns the duty-cycle share of it, in thousandths
+    airtime_credit_us = MIN(airtime_credit_us + (now - last_refill_time) * CONFIG_LORAWAN_DUTY_CYCLE,
+                            MAX_AIRTIME_CREDIT_US);
+    last_refill_time = now;
+}
+
+void wait_for_airtime(uint32_t time_on_air)
+{
+    uint32_t wait_time;
+
+    refill_airtime_budget();
+    if (airtime_credit_us >= time_on_air)
+    {
+        return;
+    }
+    wait_time = DIV_ROUND_UP(time_on_air - airtime_credit_us, CONFIG_LORAWAN_DUTY_CYCLE);
+    LOG_INF("Waiting %d ms for duty-cycle budget", wait_time);
+    scheduler_stats.deferred_ms += wait_time;
+    sleep_until(k_uptime_get() + wait_time);
+    refill_airtime_budget();
+}
+
+void sleep_until(int64_t deadline)
+{
+    // Sending thread is also woken up when there is new data, so it sleeps again
+    while (k_uptime_get() < deadline)
+    {
+        k_sleep(K_TIMEOUT_ABS_MS(deadline));
+    }
+}
+
+void get_lorawan_scheduler_stats(LoRaWANSchedulerStats *stats)
+{
+    *stats = scheduler_stats;
+    stats->available_airtime_ms = MAX(airtime_credit_us, 0) / USEC_PER_MSEC;
+}
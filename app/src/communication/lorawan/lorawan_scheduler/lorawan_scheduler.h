@@ -0,0 +1,45 @@
+#ifndef LORAWAN_SCHEDULER_H
+#define LORAWAN_SCHEDULER_H
+
+#include <zephyr/lorawan/lorawan.h>
+
+// LoRaWAN header, port and integrity code added to each application payload, in bytes
+#define LORAWAN_FRAME_OVERHEAD 13
+// Window over which the duty-cycle is measured, which limits airtime bursts
+#define LORAWAN_DUTY_CYCLE_WINDOW_MS (3600 * MSEC_PER_SEC)
+// Delays before sending a package again after a failure, doubled on each attempt
+#define LORAWAN_MIN_RETRY_DELAY_MS (1 * MSEC_PER_SEC)
+#define LORAWAN_MAX_RETRY_DELAY_MS (64 * MSEC_PER_SEC)
+
+// Metrics of the airtime used since boot
+typedef struct
+{
+    // Time on air of the packages sent
+    uint32_t airtime_ms;
+    // Time packages waited for the duty-cycle budget
+    uint32_t deferred_ms;
+    // Attempts rejected by the LoRaWAN stack because of its own duty-cycle
+    // restriction, which are retried without counting against the limit
+    uint32_t restricted_attempts;
+    // Attempts that failed for other reasons and were retried
+    uint32_t retried_attempts;
+    // Packages dropped after failing on every attempt
+    uint32_t failed_packages;
+    // Airtime that could be used at once when the budget was last updated
+    uint32_t available_airtime_ms;
+} LoRaWANSchedulerStats;
+
+// Updates the datarate used to estimate the time on air
+void set_scheduler_datarate(enum lorawan_datarate datarate);
+// Returns the time on air in microseconds of an uplink
+// with `payload_size` application bytes at the current datarate
+uint32_t get_time_on_air(uint8_t payload_size);
+// Checks if the duty-cycle budget allows sending `payload_size` bytes now
+bool is_airtime_available(uint8_t payload_size);
+// Sends package as an unconfirmed uplink, waiting for the duty-cycle budget and
+// retrying on failure. Returns an error if every attempt failed
+int send_scheduled_package(uint8_t *package, uint8_t package_size);
+// Gets the metrics of the airtime used
+void get_lorawan_scheduler_stats(LoRaWANSchedulerStats *stats);
+
+#endif /* LORAWAN_SCHEDULER_H */
@@ -12,6 +12,7 @@
 */
 #include <communication/lorawan/lorawan_keys_example.h>
 #include <communication/lorawan/lorawan_interface.h>
+#include <communication/lorawan/lorawan_scheduler/lorawan_scheduler.h>
 #include <integration/timestamp/timestamp_service.h>
 
 LOG_MODULE_REGISTER(lorawan_setup, CONFIG_APP_LOG_LEVEL);
@@ -134,6 +135,8 @@ void downlink_callback(uint8_t port, uint8_t flags, int16_t rssi, int8_t snr, ui
 void dr_changed_callback(enum lorawan_datarate new_dr)
 {
     LOG_INF("Datarate changed to DR_%d", (int)new_dr);
+    // Time on air depends on the datarate
+    set_scheduler_datarate(new_dr);
 }
 
 // Set security configuration parameters for joining network
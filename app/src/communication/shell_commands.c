@@ -1,7 +1,24 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/shell/shell.h>
 #include <communication/uart/uart_interface.h>
+#if defined(CONFIG_ENCODE_CACHE)
+#include <communication/encode_cache/encode_cache.h>
+#endif /* CONFIG_ENCODE_CACHE */
+#if defined(CONFIG_SEND_LORAWAN)
+#include <communication/lorawan/lorawan_interface.h>
+#include <communication/lorawan/lorawan_buffer/lorawan_buffer.h>
+#include <communication/lorawan/lorawan_scheduler/lorawan_scheduler.h>
+#endif /* CONFIG_SEND_LORAWAN */
 #include <sensors/sensors_interface.h>
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+#include <integration/data_buffer/flash_spill/flash_spill.h>
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+#if defined(CONFIG_SEND_ON_DELTA)
+#include <integration/data_aggregation/deadband_filter.h>
+#endif /* CONFIG_SEND_ON_DELTA */
+#if defined(CONFIG_SCD30)
+#include <drivers/scd30.h>
+#endif /* CONFIG_SCD30 */
 
 LOG_MODULE_REGISTER(shell_commands, CONFIG_APP_LOG_LEVEL);
 
@@ -13,11 +30,27 @@ LOG_MODULE_REGISTER(shell_commands, CONFIG_APP_LOG_LEVEL);
 
 #define HELP_READ_SENSOR "Read sensors and store values in the application buffer."
 #define HELP_SAMPLING_INTERVAL "Get or set sensor interface's sampling interval in milliseconds."
-#define HELP_SAMPLING_INTERVAL_GET "Get sensor sampling interval. Usage: \"sampling_interval get\"."
-#define HELP_SAMPLING_INTERVAL_SET "Set sensor sampling interval. Usage: \"sampling_interval set <INTERVAL>\"."
+#define HELP_SAMPLING_INTERVAL_GET "Get sampling interval of every sensor or of the given one. " \
+                                   "Usage: \"sampling_interval get [SENSOR]\"."
+#define HELP_SAMPLING_INTERVAL_SET "Set sampling interval of every sensor or of the given one. " \
+                                   "Usage: \"sampling_interval set <INTERVAL> [SENSOR]\"."
+#define HELP_SAMPLING_STATS "Show how late sensor readings started relative to their deadlines."
+// Names of sensors in commands, in the order of SensorType enum
+static const char *sensor_names[MAX_SENSORS] = {
+    [BME280] = "bme280",
+    [BMI160] = "bmi160",
+    [SI1133] = "si1133",
+    [VBATT] = "vbatt",
+    [SCD30] = "scd30",
+    [L86_M33] = "gps",
+};
+
+// Returns sensor with the given name, or -1 if there is none
+static enum SensorType get_sensor_type(const char *sensor_name);
 // Time (`argv[1]`) is in millisenconds
 static int set_sampling_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv);
 static int get_sampling_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+static int sampling_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
 static int read_sensors_cmd_handler(const struct shell *sh, size_t argc, char **argv);
 
 SHELL_CMD_REGISTER(read_sensor, NULL, HELP_READ_SENSOR, read_sensors_cmd_handler);
@@ -27,15 +60,52 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sampling_interval_subcmds,
                                SHELL_CMD(get, NULL, HELP_SAMPLING_INTERVAL_GET, get_sampling_interval_cmd_handler),
                                SHELL_SUBCMD_SET_END);
 SHELL_CMD_REGISTER(sampling_interval, &sampling_interval_subcmds, HELP_SAMPLING_INTERVAL, NULL);
+SHELL_CMD_REGISTER(sampling_stats, NULL, HELP_SAMPLING_STATS, sampling_stats_cmd_handler);
+#if defined(CONFIG_SEND_ON_DELTA)
+#define HELP_DEADBAND "Get or set how far sensor measurements must move to be stored."
+#define HELP_DEADBAND_GET "Get deadband of each measurement of the sensor, in the order of " \
+                          "its binary frame. Usage: \"deadband get <SENSOR>\"."
+#define HELP_DEADBAND_SET "Set deadband of a measurement of the sensor, in its fixed-point scale " \
+                          "and in thousandths of the last stored value. A measurement with both 0 " \
+                          "has no deadband. Usage: \"deadband set <SENSOR> <FIELD> <ABSOLUTE> [RELATIVE]\"."
+#define HELP_DEADBAND_STATS "Show how many sensor readings were stored and suppressed by their deadband."
+static int set_deadband_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+static int get_deadband_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+static int deadband_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+// Registers get and set as subcommands of deadband
+SHELL_STATIC_SUBCMD_SET_CREATE(deadband_subcmds,
+                               SHELL_CMD(set, NULL, HELP_DEADBAND_SET, set_deadband_cmd_handler),
+                               SHELL_CMD(get, NULL, HELP_DEADBAND_GET, get_deadband_cmd_handler),
+                               SHELL_SUBCMD_SET_END);
+SHELL_CMD_REGISTER(deadband, &deadband_subcmds, HELP_DEADBAND, NULL);
+SHELL_CMD_REGISTER(deadband_stats, NULL, HELP_DEADBAND_STATS, deadband_stats_cmd_handler);
+#endif /* CONFIG_SEND_ON_DELTA */
+#if defined(CONFIG_SCD30)
+#define HELP_SCD30_STATS "Show I2C transactions of SCD30 reads and how fast its RDY interrupts were handled."
+static int scd30_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+SHELL_CMD_REGISTER(scd30_stats, NULL, HELP_SCD30_STATS, scd30_stats_cmd_handler);
+#endif /* CONFIG_SCD30 */
 
 // ** Trasmission command handlers **
 
 #define HELP_FORWARD_DATA "Insert a text item in the application buffer."
 #define HELP_TRANSMISSION_INTERVAL "Get or set communication interface's transmission interval in milliseconds."
-#define HELP_TRANSMISSION_INTERVAL_GET "Get communication interface's transmission interval. " \
-                                       "Usage: \"transmission_interval get\"."
-#define HELP_TRANSMISSION_INTERVAL_SET "Set communication interface's transmission interval. " \
-                                       "Usage: \"transmission_interval set <INTERVAL>\"."
+#define HELP_TRANSMISSION_INTERVAL_GET "Get transmission interval of every channel or of the given one. " \
+                                       "Usage: \"transmission_interval get [CHANNEL]\"."
+#define HELP_TRANSMISSION_INTERVAL_SET "Set transmission interval of every channel or of the given one. " \
+                                       "Usage: \"transmission_interval set <INTERVAL> [CHANNEL]\"."
+// Names of channels in commands, in the order of ChannelType enum
+static const char *channel_names[MAX_CHANNELS] = {
+    [UART] = "uart",
+    [BLE] = "ble",
+    [LORAWAN] = "lorawan",
+    [LORAP2P] = "lorap2p",
+};
+
+// Returns channel with the given name, or -1 if there is none
+static enum ChannelType get_channel_type(const char *channel_name);
 // Time (`argv[1]`) is in millisenconds
 static int set_transmission_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv);
 static int get_transmission_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv);
@@ -49,6 +119,31 @@ SHELL_STATIC_SUBCMD_SET_CREATE(transmission_interval_subcmds,
                                SHELL_SUBCMD_SET_END);
 SHELL_CMD_REGISTER(transmission_interval, &transmission_interval_subcmds,
                    HELP_TRANSMISSION_INTERVAL, NULL);
+#if defined(CONFIG_ENCODE_CACHE)
+#define HELP_ENCODE_CACHE_STATS "Show how often records were found encoded for another channel."
+static int encode_cache_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+SHELL_CMD_REGISTER(encode_cache_stats, NULL, HELP_ENCODE_CACHE_STATS, encode_cache_stats_cmd_handler);
+#endif /* CONFIG_ENCODE_CACHE */
+#if defined(CONFIG_SEND_LORAWAN)
+#define HELP_LORAWAN_STATS "Show how LoRaWAN packages were filled, the airtime they used and how many were lost."
+static int lorawan_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+SHELL_CMD_REGISTER(lorawan_stats, NULL, HELP_LORAWAN_STATS, lorawan_stats_cmd_handler);
+#endif /* CONFIG_SEND_LORAWAN */
+
+// ** Buffer command handlers **
+
+#define HELP_DROPPED_ITEMS "Show how many items of each data type were dropped from the application buffer."
+static int dropped_items_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+SHELL_CMD_REGISTER(dropped_items, NULL, HELP_DROPPED_ITEMS, dropped_items_cmd_handler);
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+#define HELP_SPILL_STATS "Show usage and wear of the flash where buffer items are moved when it fills up."
+static int spill_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv);
+
+SHELL_CMD_REGISTER(spill_stats, NULL, HELP_SPILL_STATS, spill_stats_cmd_handler);
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
 
 /**
  * IMPLEMENTATIONS
@@ -56,10 +151,22 @@ SHELL_CMD_REGISTER(transmission_interval, &transmission_interval_subcmds,
 
 // Sensors command handlers
 
+static enum SensorType get_sensor_type(const char *sensor_name)
+{
+    for (enum SensorType sensor = 0; sensor < MAX_SENSORS; sensor++)
+    {
+        if (!strcmp(sensor_name, sensor_names[sensor]))
+        {
+            return sensor;
+        }
+    }
+    return -1;
+}
+
 static int set_sampling_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv)
 {
     // Returns if there are not enough arguments
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
     {
         shell_error(sh, "Too few arguments.\n%s", HELP_SAMPLING_INTERVAL_SET);
         return -EINVAL;
@@ -74,18 +181,179 @@ static int set_sampling_interval_cmd_handler(const struct shell *sh, size_t argc
         return -EINVAL;
     }
 
-    set_sampling_interval(interval);
+    if (argc == 3)
+    {
+        enum SensorType sensor = get_sensor_type(argv[2]);
+        if (sensor == -1)
+        {
+            shell_error(sh, "Unknown sensor %s", argv[2]);
+            return -EINVAL;
+        }
+        error = set_sensor_sampling_interval(sensor, interval);
+    }
+    else
+    {
+        error = set_sampling_interval(interval);
+    }
+    if (error)
+    {
+        shell_error(sh, "Invalid interval.");
+        return error;
+    }
 
     return 0;
 }
 
 static int get_sampling_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv)
 {
+    if (argc == 2)
+    {
+        enum SensorType sensor = get_sensor_type(argv[1]);
+        if (sensor == -1)
+        {
+            shell_error(sh, "Unknown sensor %s", argv[1]);
+            return -EINVAL;
+        }
+        shell_print(sh, "Sampling interval of %s is %d milliseconds", argv[1],
+                    get_sensor_sampling_interval(sensor));
+        return 0;
+    }
+
     shell_print(sh, "Sampling interval is %d milliseconds", get_sampling_interval());
+    for (enum SensorType sensor = 0; sensor < MAX_SENSORS; sensor++)
+    {
+        if (sensor_apis[sensor] != NULL)
+        {
+            shell_print(sh, "  %s: %d milliseconds", sensor_names[sensor],
+                        get_sensor_sampling_interval(sensor));
+        }
+    }
 
     return 0;
 }
 
+static int sampling_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    SamplingStats stats;
+
+    for (enum SensorType sensor = 0; sensor < MAX_SENSORS; sensor++)
+    {
+        if (get_sampling_stats(sensor, &stats) != 0 || stats.readings == 0)
+        {
+            continue;
+        }
+        shell_print(sh, "%s: %u readings, jitter mean %u us, max %u us, missed deadlines: %u, "
+                        "longest reading: %u us",
+                    sensor_names[sensor], stats.readings,
+                    (uint32_t)(stats.total_jitter_us / stats.readings), stats.max_jitter_us,
+                    stats.missed_deadlines, stats.max_read_time_us);
+    }
+
+    return 0;
+}
+
+#if defined(CONFIG_SEND_ON_DELTA)
+static int set_deadband_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    if (argc != 4 && argc != 5)
+    {
+        shell_error(sh, "Wrong number of arguments.\n%s", HELP_DEADBAND_SET);
+        return -EINVAL;
+    }
+
+    enum SensorType sensor = get_sensor_type(argv[1]);
+    if (sensor == -1)
+    {
+        shell_error(sh, "Unknown sensor %s", argv[1]);
+        return -EINVAL;
+    }
+    int error = 0;
+    int field = shell_strtol(argv[2], 10, &error);
+    int absolute = shell_strtol(argv[3], 10, &error);
+    int relative = argc == 5 ? shell_strtol(argv[4], 10, &error) : 0;
+    if (error != 0 || relative < 0 || relative > UINT16_MAX ||
+        set_deadband_threshold(sensor, field, absolute, relative) != 0)
+    {
+        shell_error(sh, "Invalid deadband.");
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int get_deadband_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    DeadbandThreshold threshold;
+
+    if (argc != 2)
+    {
+        shell_error(sh, "Must provide a sensor.\n%s", HELP_DEADBAND_GET);
+        return -EINVAL;
+    }
+    enum SensorType sensor = get_sensor_type(argv[1]);
+    if (sensor == -1)
+    {
+        shell_error(sh, "Unknown sensor %s", argv[1]);
+        return -EINVAL;
+    }
+
+    for (int field = 0; field < MAX_MODEL_FIELDS; field++)
+    {
+        get_deadband_threshold(sensor, field, &threshold);
+        shell_print(sh, "  Field %d: %d or %u/1000", field, threshold.absolute,
+                    threshold.relative_permille);
+    }
+
+    return 0;
+}
+
+static int deadband_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    DeadbandStats stats;
+
+    for (enum SensorType sensor = 0; sensor < MAX_SENSORS; sensor++)
+    {
+        if (get_deadband_stats(sensor, &stats) != 0 || stats.reported + stats.suppressed == 0)
+        {
+            continue;
+        }
+        shell_print(sh, "%s: %u readings stored, %u of them by heartbeat, %u suppressed",
+                    sensor_names[sensor], stats.reported, stats.heartbeats, stats.suppressed);
+    }
+
+    return 0;
+}
+#endif /* CONFIG_SEND_ON_DELTA */
+
+#if defined(CONFIG_SCD30)
+static int scd30_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    const struct device *scd30 = DEVICE_DT_GET_ANY(sensirion_scd30);
+    struct scd30_stats stats;
+
+    if (scd30 == NULL || scd30_get_stats(scd30, &stats) != 0)
+    {
+        shell_error(sh, "SCD30 not available.");
+        return -ENODEV;
+    }
+
+    shell_print(sh, "Reads: %u, I2C transactions: %u, data ready queries: %u", stats.fetches,
+                stats.i2c_transactions, stats.data_ready_polls);
+    if (stats.interrupts > 0)
+    {
+        shell_print(sh, "RDY interrupts: %u, handling latency: %u us average, %u us max",
+                    stats.interrupts, (uint32_t)(stats.total_work_latency_us / stats.interrupts),
+                    stats.max_work_latency_us);
+    }
+    else
+    {
+        shell_print(sh, "No RDY interrupts handled");
+    }
+
+    return 0;
+}
+#endif /* CONFIG_SCD30 */
+
 static int read_sensors_cmd_handler(const struct shell *sh, size_t argc, char **argv)
 {
     // Returns if there are not enough arguments
@@ -99,26 +367,18 @@ static int read_sensors_cmd_handler(const struct shell *sh, size_t argc, char **
     for (int i = 1; i < argc; i++)
     {
         char *sensor_name = argv[i];
-        enum SensorType sensor_num = -1;
-
-        if (!strcmp(sensor_name, "bme280"))
-            sensor_num = BME280;
-        else if (!strcmp(sensor_name, "bmi160"))
-            sensor_num = BMI160;
-        else if (!strcmp(sensor_name, "si1133"))
-            sensor_num = SI1133;
-        else if (!strcmp(sensor_name, "vbatt"))
-            sensor_num = VBATT;
-        else if (!strcmp(sensor_name, "scd30"))
-            sensor_num = SCD30;
-        else if (!strcmp(sensor_name, "gps"))
-            sensor_num = L86_M33;
+        enum SensorType sensor_num = get_sensor_type(sensor_name);
 
         if (sensor_num == -1 || sensor_apis[sensor_num] == NULL)
         {
             shell_warn(sh, "Sensor %s is not available", sensor_name);
             continue;
         }
+        if (sensor_apis[sensor_num]->read_sensor_values == NULL)
+        {
+            shell_warn(sh, "Sensor %s measures by itself", sensor_name);
+            continue;
+        }
 
         shell_print(sh, "Reading from %s", sensor_name);
         sensor_apis[sensor_num]->read_sensor_values();
@@ -129,11 +389,23 @@ static int read_sensors_cmd_handler(const struct shell *sh, size_t argc, char **
 
 // Trasmission command handlers
 
+static enum ChannelType get_channel_type(const char *channel_name)
+{
+    for (enum ChannelType channel = 0; channel < MAX_CHANNELS; channel++)
+    {
+        if (!strcmp(channel_name, channel_names[channel]))
+        {
+            return channel;
+        }
+    }
+    return -1;
+}
+
 static int set_transmission_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv)
 {
 
     // Returns if there are not enough arguments
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
     {
         shell_error(sh, "Too few arguments.\n%s", HELP_TRANSMISSION_INTERVAL_SET);
         return -EINVAL;
@@ -148,14 +420,60 @@ static int set_transmission_interval_cmd_handler(const struct shell *sh, size_t
         return -EINVAL;
     }
 
-    set_transmission_interval(interval);
+    if (argc == 3)
+    {
+        enum ChannelType channel = get_channel_type(argv[2]);
+        if (channel == -1)
+        {
+            shell_error(sh, "Unknown channel %s", argv[2]);
+            return -EINVAL;
+        }
+        error = set_channel_transmission_interval(channel, interval);
+    }
+    else
+    {
+        error = set_transmission_interval(interval);
+    }
+    if (error)
+    {
+        shell_error(sh, "Invalid interval or channel not in use.");
+        return error;
+    }
 
     return 0;
 }
 
 static int get_transmission_interval_cmd_handler(const struct shell *sh, size_t argc, char **argv)
 {
+    int interval;
+
+    if (argc == 2)
+    {
+        enum ChannelType channel = get_channel_type(argv[1]);
+        if (channel == -1)
+        {
+            shell_error(sh, "Unknown channel %s", argv[1]);
+            return -EINVAL;
+        }
+        interval = get_channel_transmission_interval(channel);
+        if (interval < 0)
+        {
+            shell_error(sh, "Channel %s not in use", argv[1]);
+            return interval;
+        }
+        shell_print(sh, "Transmission interval of %s is %d milliseconds", argv[1], interval);
+        return 0;
+    }
+
     shell_print(sh, "Transmission interval is %d milliseconds", get_transmission_interval());
+    for (enum ChannelType channel = 0; channel < MAX_CHANNELS; channel++)
+    {
+        interval = get_channel_transmission_interval(channel);
+        if (interval > 0)
+        {
+            shell_print(sh, "  %s: %d milliseconds", channel_names[channel], interval);
+        }
+    }
 
     return 0;
 }
@@ -171,7 +489,7 @@ static int forward_data_cmd_handler(const struct shell *sh, size_t argc, char **
     char payload[SIZE_32_BIT_WORDS_TO_BYTES((MAX_32_WORDS))] = {0};
     snprintf(payload, sizeof(payload), "%s", argv[1]);
 
-    if (insert_in_buffer(&app_buffer, (uint32_t *)payload, TEXT_DATA, 0, MAX_32_WORDS) != 0)
+    if (insert_in_app_buffer((uint32_t *)payload, TEXT_DATA, 0, MAX_32_WORDS) != 0)
     {
         shell_error(sh, "Failed to insert data in ring buffer.");
         return -EAGAIN;
@@ -179,3 +497,94 @@ static int forward_data_cmd_handler(const struct shell *sh, size_t argc, char **
 
     return 0;
 }
+
+#if defined(CONFIG_ENCODE_CACHE)
+static int encode_cache_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    EncodeCacheStats stats;
+    get_encode_cache_stats(&stats);
+
+    shell_print(sh, "Found in cache: %u, encoded in cache: %u", stats.hits, stats.misses);
+    // Encoding levels used by a single channel skip the cache
+    shell_print(sh, "Encoded without caching: %u", stats.uncached);
+
+    return 0;
+}
+#endif /* CONFIG_ENCODE_CACHE */
+
+#if defined(CONFIG_SEND_LORAWAN)
+static int lorawan_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    LoRaWANPackingStats stats;
+    LoRaWANSchedulerStats scheduler_stats;
+    get_lorawan_packing_stats(&stats);
+    get_lorawan_scheduler_stats(&scheduler_stats);
+
+    if (stats.packages > 0)
+    {
+        shell_print(sh, "Packages: %u, records: %u, records per package: %u.%02u", stats.packages,
+                    stats.records, stats.records / stats.packages,
+                    stats.records * 100 / stats.packages % 100);
+        shell_print(sh, "Bytes sent: %u of %u, fill ratio: %u%%", stats.payload_bytes,
+                    stats.capacity_bytes, stats.payload_bytes * 100 / stats.capacity_bytes);
+    }
+    else
+    {
+        shell_print(sh, "No packages sent");
+    }
+    shell_print(sh, "Airtime used: %u ms, available: %u ms, waited for budget: %u ms",
+                scheduler_stats.airtime_ms, scheduler_stats.available_airtime_ms,
+                scheduler_stats.deferred_ms);
+    shell_print(sh, "Attempts deferred by the stack: %u, retried: %u",
+                scheduler_stats.restricted_attempts, scheduler_stats.retried_attempts);
+    shell_print(sh, "Lost packages: %u, lost records: %u, records dropped while waiting: %u",
+                stats.lost_packages, stats.lost_records, get_lorawan_dropped_items());
+
+    return 0;
+}
+#endif /* CONFIG_SEND_LORAWAN */
+
+// Buffer command handlers
+
+static int dropped_items_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    bool dropped_any = false;
+
+    for (enum DataType data_type = 0; data_type < MAX_DATA_TYPE; data_type++)
+    {
+        uint32_t dropped_items = get_dropped_items(data_type);
+        if (dropped_items > 0)
+        {
+            shell_print(sh, "Data type %d: %u items dropped", data_type, dropped_items);
+            dropped_any = true;
+        }
+    }
+    if (!dropped_any)
+    {
+        shell_print(sh, "No items dropped");
+    }
+
+    return 0;
+}
+
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+static int spill_stats_cmd_handler(const struct shell *sh, size_t argc, char **argv)
+{
+    FlashSpillStats stats;
+    get_flash_spill_stats(&stats);
+
+    if (stats.sector_count == 0)
+    {
+        shell_error(sh, "Flash spill is not initialized");
+        return -ENODEV;
+    }
+    shell_print(sh, "Pages: %u, free: %u", stats.sector_count, stats.free_sectors);
+    shell_print(sh, "Blocks pending: %u, written: %u, read: %u, lost: %u",
+                stats.pending_blocks, stats.written_blocks, stats.read_blocks, stats.lost_blocks);
+    // Pages are written in a circle, so erases are spread evenly among them
+    shell_print(sh, "Pages erased since boot: %u, erases per page over lifetime: %u",
+                stats.erased_sectors, stats.active_sector_id / stats.sector_count);
+
+    return 0;
+}
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <communication/uart/uart_frame.h>
+
+/**
+ * DEFINITIONS
+ */
+
+// Bytes of the data type and size of each record
+#define RECORD_HEADER_SIZE 2
+// Longest run of non-zero bytes in a COBS block
+#define COBS_MAX_BLOCK 254
+
+// Writes `length` bytes of `data` with COBS, replacing each zero byte by the distance to
+// the next one. Returns the number of bytes written, or -ENOMEM if they don't fit
+static int cobs_encode(const uint8_t *data, size_t length, uint8_t *encoded_data,
+                       size_t encoded_size);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+void start_uart_frame(UartFrame *frame, uint16_t sequence)
+{
+    sys_put_le16(sequence, frame->data);
+    frame->length = UART_FRAME_SEQUENCE_SIZE;
+}
+
+bool uart_frame_is_empty(UartFrame *frame)
+{
+    return frame->length == UART_FRAME_SEQUENCE_SIZE;
+}
+
+int append_uart_frame_record(UartFrame *frame, enum DataType data_type,
+                             const uint8_t *raw_bytes, size_t size)
+{
+    size_t available = UART_FRAME_SEQUENCE_SIZE + UART_FRAME_RECORDS_SIZE - frame->length;
+    uint8_t *record = &frame->data[frame->length];
+
+    if (size > UINT8_MAX || RECORD_HEADER_SIZE + size > available)
+    {
+        return -ENOMEM;
+    }
+    record[0] = data_type;
+    record[1] = size;
+    memcpy(&record[RECORD_HEADER_SIZE], raw_bytes, size);
+    frame->length += RECORD_HEADER_SIZE + size;
+    return 0;
+}
+
+int encode_uart_frame(UartFrame *frame, uint8_t *encoded_data, size_t encoded_size)
+{
+    int size;
+
+    // CRC is written after the records without adding it to the frame length,
+    // so the frame can be encoded again if it doesn't fit
+    sys_put_le16(crc16_ccitt(0xFFFF, frame->data, frame->length),
+                 &frame->data[frame->length]);
+    if (encoded_size < 2)
+    {
+        return -ENOMEM;
+    }
+    // Delimiters before and after the frame end any text printed in between
+    encoded_data[0] = 0;
+    size = cobs_encode(frame->data, frame->length + UART_FRAME_CRC_SIZE, &encoded_data[1],
+                       encoded_size - 2);
+    if (size < 0)
+    {
+        return -ENOMEM;
+    }
+    encoded_data[size + 1] = 0;
+    return size + 2;
+}
+
+static int cobs_encode(const uint8_t *data, size_t length, uint8_t *encoded_data,
+                       size_t encoded_size)
+{
+    // Position of the byte holding the distance to the next zero
+    size_t code_position = 0;
+    size_t encoded_length = 1;
+    uint8_t code = 1;
+
+    if (encoded_size == 0)
+    {
+        return -ENOMEM;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        if (encoded_length >= encoded_size)
+        {
+            return -ENOMEM;
+        }
+        if (data[i] == 0)
+        {
+            encoded_data[code_position] = code;
+            code_position = encoded_length++;
+            code = 1;
+            continue;
+        }
+        encoded_data[encoded_length++] = data[i];
+        // Blocks without zeros are ended every 254 bytes
+        if (++code == COBS_MAX_BLOCK + 1)
+        {
+            if (encoded_length >= encoded_size)
+            {
+                return -ENOMEM;
+            }
+            encoded_data[code_position] = code;
+            code_position = encoded_length++;
+            code = 1;
+        }
+    }
+    encoded_data[code_position] = code;
+    return encoded_length;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+#include <communication/comm_interface.h>
+
+// Maximum bytes of records in a frame
+#define UART_FRAME_RECORDS_SIZE 512
+// Bytes of the sequence number before the records and of the CRC after them
+#define UART_FRAME_SEQUENCE_SIZE 2
+#define UART_FRAME_CRC_SIZE 2
+#define UART_FRAME_DATA_SIZE \
+    (UART_FRAME_SEQUENCE_SIZE + UART_FRAME_RECORDS_SIZE + UART_FRAME_CRC_SIZE)
+// Maximum size of an encoded frame. COBS adds a byte every 254 bytes
+// and one more before the first, and the frame is between zero bytes
+#define UART_FRAME_ENCODED_SIZE \
+    (UART_FRAME_DATA_SIZE + DIV_ROUND_UP(UART_FRAME_DATA_SIZE, 254) + 1 + 2)
+
+// Records sent as a single binary frame by the UART channel. The frame holds
+// its sequence number, the records and the CRC-16/CCITT of the previous bytes,
+// seeded with 0xFFFF, all little-endian. Each record is its data type and size,
+// 1 byte each, followed by its RAW_BYTES encoding. The frame is sent encoded
+// with COBS, so it has no zero bytes, between zero bytes, which let the
+// receiver find the next frame after a corrupted one or after logs
+typedef struct
+{
+    uint8_t data[UART_FRAME_DATA_SIZE];
+    // Bytes used by the sequence number and the records
+    size_t length;
+} UartFrame;
+
+// Starts a frame without records
+void start_uart_frame(UartFrame *frame, uint16_t sequence);
+// Whether the frame has no records
+bool uart_frame_is_empty(UartFrame *frame);
+// Appends a record of `data_type` encoded as RAW_BYTES to the frame,
+// returning -ENOMEM if it doesn't fit
+int append_uart_frame_record(UartFrame *frame, enum DataType data_type,
+                             const uint8_t *raw_bytes, size_t size);
+// Writes the frame with its CRC, encoded and between delimiters, to `encoded_data`.
+// Returns the number of bytes written, or -ENOMEM if they don't fit in `encoded_size`
+int encode_uart_frame(UartFrame *frame, uint8_t *encoded_data, size_t encoded_size);
+
+#endif /* UART_FRAME_H */
\ No newline at end of file
@@ -1,6 +1,13 @@
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <communication/uart/uart_interface.h>
+#if defined(CONFIG_UART_CHANNEL_ASYNC)
+#include <zephyr/drivers/uart.h>
+#endif /* CONFIG_UART_CHANNEL_ASYNC */
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+#include <communication/uart/uart_frame.h>
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
 
 LOG_MODULE_REGISTER(uart_interface, CONFIG_APP_LOG_LEVEL);
 
@@ -16,8 +23,43 @@ static K_THREAD_STACK_DEFINE(uart_thread_stack_area, UART_THREAD_STACK_SIZE);
 static struct k_thread uart_thread_data;
 static k_tid_t uart_thread_id;
 
+#if defined(CONFIG_UART_CHANNEL_ASYNC)
+// Data is sent on the console UART, along with logs
+static const struct device *uart_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+BUILD_ASSERT(CONFIG_UART_CHANNEL_TX_BUFFER_SIZE > CONFIG_ENCODE_CACHE_ITEM_SIZE,
+             "UART_CHANNEL_TX_BUFFER_SIZE must fit an encoded record and its new line");
+// Records are written into one buffer while the other one is being sent
+static uint8_t tx_buffers[2][CONFIG_UART_CHANNEL_TX_BUFFER_SIZE];
+// Buffer being filled and number of bytes in it
+static int current_tx_buffer;
+static size_t tx_length;
+// Taken before starting a transfer and given back when it ends,
+// so only one transfer is in flight
+static K_SEM_DEFINE(tx_done_sem, 1, 1);
+
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+BUILD_ASSERT(CONFIG_UART_CHANNEL_TX_BUFFER_SIZE >= UART_FRAME_ENCODED_SIZE,
+             "UART_CHANNEL_TX_BUFFER_SIZE must fit an encoded frame");
+// Records of the batch, sent as frames numbered in sequence
+static UartFrame tx_frame;
+static uint16_t tx_frame_sequence;
+
+// Encodes the frame after the data in the current buffer, sending it first if it doesn't fit
+static void uart_queue_frame();
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
+
+// Handles the end of the transfers
+static void uart_async_callback(const struct device *dev, struct uart_event *event,
+                                void *user_data);
+// Encodes a record after the ones in the current buffer, sending them first if
+// it doesn't fit. In binary mode, records are added to the frame being built
+static void uart_queue_record(CommunicationUnit *data_unit);
+// Sends the current buffer once the previous transfer ends, and starts filling the other one
+static void uart_flush();
+#endif /* CONFIG_UART_CHANNEL_ASYNC */
+
 // Initializes and starts thread to send data via UART
-static void uart_init_channel();
+static int uart_init_channel();
 // Functions that prints data to UART in separate thread
 static void uart_send_data(void *, void *, void *);
 
@@ -25,10 +67,25 @@ static void uart_send_data(void *, void *, void *);
  * IMPLEMENTATIONS
  */
 
-static void uart_init_channel()
+static int uart_init_channel()
 {
     LOG_DBG("Initializing send via UART thread");
     int ret = 0;
+
+#if defined(CONFIG_UART_CHANNEL_ASYNC)
+    if (!device_is_ready(uart_dev))
+    {
+        LOG_ERR("UART device not ready");
+        return -ENODEV;
+    }
+    ret = uart_callback_set(uart_dev, uart_async_callback, NULL);
+    if (ret)
+    {
+        LOG_ERR("Failed to set UART callback: %d", ret);
+        return ret;
+    }
+#endif /* CONFIG_UART_CHANNEL_ASYNC */
+
     // Create thread and starts it immediately
     uart_thread_id = k_thread_create(&uart_thread_data, uart_thread_stack_area,
                                      K_THREAD_STACK_SIZEOF(uart_thread_stack_area),
@@ -39,6 +96,125 @@ static void uart_init_channel()
     {
         LOG_ERR("Failed to set read buffer thread name: %d", ret);
     }
+    return 0;
+}
+
+#if defined(CONFIG_UART_CHANNEL_ASYNC)
+
+static void uart_async_callback(const struct device *dev, struct uart_event *event,
+                                void *user_data)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(user_data);
+
+    switch (event->type)
+    {
+    case UART_TX_DONE:
+        k_sem_give(&tx_done_sem);
+        break;
+    case UART_TX_ABORTED:
+        LOG_WRN("UART transfer aborted after %d bytes", event->data.tx.len);
+        k_sem_give(&tx_done_sem);
+        break;
+    default:
+        break;
+    }
+}
+
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+
+static void uart_queue_record(CommunicationUnit *data_unit)
+{
+    const uint8_t *encoded_data;
+    int size = get_encoded_unit(UART, data_unit, &encoded_data);
+    int error;
+
+    if (size < 0)
+    {
+        LOG_ERR("Could not encode data: %d", size);
+        return;
+    }
+    error = append_uart_frame_record(&tx_frame, data_unit->data_type, encoded_data, size);
+    if (error == -ENOMEM && !uart_frame_is_empty(&tx_frame))
+    {
+        // Sends the records already in the frame and starts a new one
+        uart_queue_frame();
+        error = append_uart_frame_record(&tx_frame, data_unit->data_type, encoded_data, size);
+    }
+    if (error)
+    {
+        LOG_ERR("Could not add record to UART frame: %d", error);
+    }
+}
+
+static void uart_queue_frame()
+{
+    int size;
+
+    if (uart_frame_is_empty(&tx_frame))
+    {
+        return;
+    }
+    size = encode_uart_frame(&tx_frame, &tx_buffers[current_tx_buffer][tx_length],
+                             sizeof(tx_buffers[0]) - tx_length);
+    if (size == -ENOMEM)
+    {
+        // Sends the frames already encoded, the empty buffer always fits a frame
+        uart_flush();
+        size = encode_uart_frame(&tx_frame, tx_buffers[current_tx_buffer],
+                                 sizeof(tx_buffers[0]));
+    }
+    if (size > 0)
+    {
+        tx_length += size;
+    }
+    start_uart_frame(&tx_frame, ++tx_frame_sequence);
+}
+
+#else
+
+static void uart_queue_record(CommunicationUnit *data_unit)
+{
+    const uint8_t *encoded_data;
+    // Encoding data to verbose string
+    int size = get_encoded_unit(UART, data_unit, &encoded_data);
+
+    if (size < 0)
+    {
+        LOG_ERR("Could not encode data");
+        return;
+    }
+    // Records are separated by new lines
+    if (size + 1 > sizeof(tx_buffers[0]) - tx_length)
+    {
+        // Sends the records already copied, the empty buffer fits any encoded record
+        uart_flush();
+    }
+    memcpy(&tx_buffers[current_tx_buffer][tx_length], encoded_data, size);
+    tx_buffers[current_tx_buffer][tx_length + size] = '\n';
+    tx_length += size + 1;
+}
+
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
+
+static void uart_flush()
+{
+    int error;
+
+    if (tx_length == 0)
+    {
+        return;
+    }
+    // Waits for the other buffer, which was being sent, to be free
+    k_sem_take(&tx_done_sem, K_FOREVER);
+    error = uart_tx(uart_dev, tx_buffers[current_tx_buffer], tx_length, SYS_FOREVER_US);
+    if (error)
+    {
+        LOG_ERR("Failed to start UART transfer: %d", error);
+        k_sem_give(&tx_done_sem);
+    }
+    current_tx_buffer = !current_tx_buffer;
+    tx_length = 0;
 }
 
 static void uart_send_data(void *param0, void *param1, void *param2)
@@ -48,31 +224,78 @@ static void uart_send_data(void *param0, void *param1, void *param2)
     ARG_UNUSED(param1);
     ARG_UNUSED(param2);
 
-    // Max fprintf character output is 4096
-    uint8_t encoded_data[1024];
-    int size;
+    CommunicationUnit data_units[CONFIG_TRANSMISSION_BATCH_SIZE];
+    int num_units;
+
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+    start_uart_frame(&tx_frame, tx_frame_sequence);
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
 
     while (1)
     {
         // Waits data to be ready
-        k_sem_take(&data_ready_sem[UART], K_FOREVER);
+        num_units = get_channel_data(UART, data_units, CONFIG_TRANSMISSION_BATCH_SIZE);
+
+        for (int i = 0; i < num_units; i++)
+        {
+            uart_queue_record(&data_units[i]);
+        }
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+        // Each batch ends its frame, so records aren't held until the next one
+        uart_queue_frame();
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
+
+        // Records are already encoded, so the buffer can reclaim them
+        // while they are on the wire
+        release_channel_data(UART);
+        uart_flush();
+    }
+}
 
-        // Encoding data to verbose string
-        size = encode_data(data_unit.data_words, data_unit.data_type, VERBOSE,
-                           encoded_data, sizeof(encoded_data));
-        if (size >= 0)
-            printk("%s\n", encoded_data);
-        else
-            LOG_ERR("Could not encode data");
+#else
+
+static void uart_send_data(void *param0, void *param1, void *param2)
+{
+    LOG_DBG("Sending via UART started");
+    ARG_UNUSED(param0);
+    ARG_UNUSED(param1);
+    ARG_UNUSED(param2);
+
+    const uint8_t *encoded_data;
+    CommunicationUnit data_units[CONFIG_TRANSMISSION_BATCH_SIZE];
+    int size, num_units;
+
+    while (1)
+    {
+        // Waits data to be ready
+        num_units = get_channel_data(UART, data_units, CONFIG_TRANSMISSION_BATCH_SIZE);
+
+        for (int i = 0; i < num_units; i++)
+        {
+            // Encoding data to verbose string
+            size = get_encoded_unit(UART, &data_units[i], &encoded_data);
+            if (size >= 0)
+                printk("%.*s\n", size, encoded_data);
+            else
+                LOG_ERR("Could not encode data");
+        }
 
         // Signals back that UART sending is complete
-        k_sem_give(&data_processed);
+        release_channel_data(UART);
     }
 }
 
+#endif /* CONFIG_UART_CHANNEL_ASYNC */
+
 ChannelAPI *register_uart_callbacks()
 {
     LOG_DBG("Initializing UART callbacks");
     uart_api.init_channel = uart_init_channel;
+    uart_api.transmission_interval = CONFIG_UART_TRANSMISSION_INTERVAL;
+#if defined(CONFIG_UART_CHANNEL_FRAMES)
+    uart_api.encoding = RAW_BYTES;
+#else
+    uart_api.encoding = VERBOSE;
+#endif /* CONFIG_UART_CHANNEL_FRAMES */
     return &uart_api;
 }
\ No newline at end of file
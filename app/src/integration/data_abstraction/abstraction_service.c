@@ -2,6 +2,12 @@
 #include <integration/data_abstraction/abstraction_service.h>
 #include <integration/data_abstraction/text_model/text_model.h>
 #include <sensors/sensors_interface.h>
+#ifdef CONFIG_BMI160_STREAMING
+#include <sensors/bmi160/bmi160_service.h>
+#endif /* CONFIG_BMI160_STREAMING */
+#ifdef CONFIG_DATA_AGGREGATION
+#include <integration/data_aggregation/aggregation_service.h>
+#endif /* CONFIG_DATA_AGGREGATION */
 
 LOG_MODULE_REGISTER(data_abstraction, CONFIG_APP_LOG_LEVEL);
 
@@ -19,6 +25,12 @@ static DataAPI *data_apis[SENSOR_TYPE_OFFSET] = {0};
 int register_data_callbacks()
 {
 	data_apis[TEXT_DATA] = register_text_model_callbacks();
+#ifdef CONFIG_BMI160_STREAMING
+	data_apis[BMI160_BATCH_DATA] = register_bmi160_batch_model_callbacks();
+#endif /* CONFIG_BMI160_STREAMING */
+#ifdef CONFIG_DATA_AGGREGATION
+	data_apis[SUMMARY_DATA] = register_summary_model_callbacks();
+#endif /* CONFIG_DATA_AGGREGATION */
 	return 0;
 }
 
@@ -39,6 +51,9 @@ int encode_data(uint32_t *data_words, enum DataType data_type, enum EncodingLeve
 	case RAW_BYTES:
 		return data_api->encode_raw_bytes(data_words, encoded_data, encoded_size);
 		break;
+	case PACKED_BINARY:
+		return data_api->encode_packed_binary(data_words, encoded_data, encoded_size);
+		break;
 	default:
 		LOG_ERR("Invalid encoding level");
 		return -EINVAL;
@@ -52,7 +67,42 @@ DataAPI *get_data_api(enum DataType data_type)
 		// Removes offset and searches sensor APIs, that's why
 		// order of sensors and sensors data types needs to be the same
 		data_type = data_type - SENSOR_TYPE_OFFSET;
-		return sensor_apis[data_type]->data_model_api;
+		// Sensors that failed to initialize have no API
+		return sensor_apis[data_type] != NULL ? sensor_apis[data_type]->data_model_api : NULL;
 	}
 	return data_apis[data_type];
-}
\ No newline at end of file
+}
+
+int encode_packed_header(enum DataType data_type, uint32_t timestamp, size_t fields_size,
+						 uint8_t *encoded_data, size_t encoded_size)
+{
+	int header_size = 0;
+
+	if (encoded_size < 1)
+	{
+		return -ENOMEM;
+	}
+	encoded_data[header_size++] = data_type;
+	// Timestamp is split in groups of 7 bits, from the least significant,
+	// and the highest bit of each byte flags if another one follows
+	do
+	{
+		if (header_size == encoded_size)
+		{
+			return -ENOMEM;
+		}
+		encoded_data[header_size] = timestamp & BIT_MASK(7);
+		timestamp >>= 7;
+		if (timestamp > 0)
+		{
+			encoded_data[header_size] |= BIT(7);
+		}
+		header_size++;
+	} while (timestamp > 0);
+
+	if (header_size + fields_size > encoded_size)
+	{
+		return -ENOMEM;
+	}
+	return header_size;
+}
@@ -14,6 +14,10 @@
 enum DataType
 {
     TEXT_DATA,
+    // Batches of BMI160 samples, streamed from its FIFO
+    BMI160_BATCH_DATA,
+    // Statistics of a field of a sensor over an aggregation window
+    SUMMARY_DATA,
     // Sensors
     BME280_MODEL = SENSOR_TYPE_OFFSET,
     BMI160_MODEL,
@@ -37,13 +41,34 @@ enum EncodingLevel
     MINIMALIST,
     // Encodes data into a verbose string
     VERBOSE,
+    // Encodes data into a compact binary frame: a type tag, a varint
+    // timestamp and the fixed-point fields of the data type
+    PACKED_BINARY,
 };
 
+// How long data is kept in the application buffer when it is full.
+// Items of lower classes are evicted first
+enum RetentionClass
+{
+    // High rate data, of which losing some samples is acceptable
+    RETENTION_BULK,
+    // Periodic measurements
+    RETENTION_NORMAL,
+    // Rare data that should be kept for as long as possible
+    RETENTION_CRITICAL,
+    MAX_RETENTION_CLASSES // Total number of retention classes
+};
+
+// Maximum number of measurements a data type can expose to the aggregation stage
+#define MAX_MODEL_FIELDS 6
+
 // Functions exposed for each data type
 typedef struct
 {
     // Size of data of given data type in 32-bit words
     uint8_t num_data_words;
+    // Eviction priority of data of given type in the application buffer
+    enum RetentionClass retention_class;
     // Encodes data into a verbose string
     int (*encode_verbose)(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size);
     // Encodes data into small strings that can be useful for debugging or offload complexity
@@ -51,6 +76,13 @@ typedef struct
     int (*encode_minimalist)(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size);
     // Prints raw bytes to the buffer
     int (*encode_raw_bytes)(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size);
+    // Encodes data into a binary frame, little-endian, that is decoded on the
+    // network server by app/scripts/packed_payload_decoder.js
+    int (*encode_packed_binary)(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size);
+    // Optional. Writes the measurements of the data as fixed-point values, in the order of
+    // the fields of its binary frame, and returns how many were written, up to MAX_MODEL_FIELDS.
+    // Data types that implement it can be summarized by the aggregation stage
+    int (*get_fields)(uint32_t *data_words, int32_t *fields);
     // Splits structured data into individual one item sized buffers
     // void* (*split_data)(uint32_t* data_words, uint8_t** value_list);
 } DataAPI;
@@ -61,7 +93,12 @@ int register_data_callbacks();
 // Encodes data to chosen presentation format
 int encode_data(uint32_t *data_words, enum DataType data_type, enum EncodingLevel encoding,
                 uint8_t *encoded_data, size_t encoded_size);
-// Processes data type and returns correspondent data API
+// Processes data type and returns correspondent data API, or NULL if it isn't in use
 DataAPI *get_data_api(enum DataType data_type);
+// Writes the header of a binary frame, its data type tag followed by the timestamp as
+// a varint. Returns the header size in bytes, or -ENOMEM if the header and `fields_size`
+// bytes of fields don't fit in `encoded_size`
+int encode_packed_header(enum DataType data_type, uint32_t timestamp, size_t fields_size,
+                         uint8_t *encoded_data, size_t encoded_size);
 
 #endif /* DATA_ABSTRACTION_H */
\ No newline at end of file
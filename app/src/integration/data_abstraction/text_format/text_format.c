@@ -0,0 +1,161 @@
+#include <integration/data_abstraction/text_format/text_format.h>
+
+/**
+ * DEFINITIONS
+ */
+
+// Digits of the largest 32-bit value
+#define MAX_DIGITS 10
+// Largest power of 10 that fits 32 bits
+#define MAX_DECIMALS 9
+
+static const uint32_t powers_of_10[MAX_DECIMALS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+// Appends an integer in decimal, with 64-bit divisions only while it doesn't fit 32 bits
+static void append_uint64(TextWriter *text, uint64_t value);
+// Appends the fractional part of a fixed-point value, `fraction` out of `scale`
+static void append_fraction(TextWriter *text, uint32_t fraction, uint32_t scale,
+                            uint8_t decimals);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+void text_init(TextWriter *text, uint8_t *data, size_t size)
+{
+    text->data = data;
+    text->size = size;
+    text->length = 0;
+}
+
+void text_append_char(TextWriter *text, char character)
+{
+    // Keeps the last byte for the terminator
+    if (text->length + 1 < text->size)
+    {
+        text->data[text->length] = character;
+    }
+    text->length++;
+}
+
+void text_append(TextWriter *text, const char *string)
+{
+    while (*string != '\0')
+    {
+        text_append_char(text, *string++);
+    }
+}
+
+void text_append_padded(TextWriter *text, uint32_t value, uint8_t width)
+{
+    char digits[MAX_DIGITS];
+    int num_digits = 0;
+
+    // Divisions by the constant 10 are turned into multiplications by the compiler
+    do
+    {
+        digits[num_digits++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    for (int i = num_digits; i < width; i++)
+    {
+        text_append_char(text, '0');
+    }
+    while (num_digits > 0)
+    {
+        text_append_char(text, digits[--num_digits]);
+    }
+}
+
+void text_append_uint(TextWriter *text, uint32_t value)
+{
+    text_append_padded(text, value, 0);
+}
+
+void text_append_int(TextWriter *text, int32_t value)
+{
+    if (value < 0)
+    {
+        text_append_char(text, '-');
+    }
+    // Negated as unsigned, so INT32_MIN doesn't overflow
+    text_append_uint(text, value < 0 ? 0U - (uint32_t)value : (uint32_t)value);
+}
+
+void text_append_fixed(TextWriter *text, int32_t fixed, uint32_t scale, uint8_t decimals)
+{
+    uint32_t magnitude = fixed < 0 ? 0U - (uint32_t)fixed : (uint32_t)fixed;
+
+    // The sign is written apart, so values between -1 and 0 keep it
+    if (fixed < 0)
+    {
+        text_append_char(text, '-');
+    }
+    text_append_uint(text, magnitude / scale);
+    append_fraction(text, magnitude % scale, scale, decimals);
+}
+
+void text_append_fixed64(TextWriter *text, int64_t fixed, uint32_t scale, uint8_t decimals)
+{
+    uint64_t magnitude = fixed < 0 ? 0ULL - (uint64_t)fixed : (uint64_t)fixed;
+    uint64_t integer = magnitude / scale;
+
+    if (fixed < 0)
+    {
+        text_append_char(text, '-');
+    }
+    append_uint64(text, integer);
+    append_fraction(text, magnitude - integer * scale, scale, decimals);
+}
+
+void append_uint64(TextWriter *text, uint64_t value)
+{
+    if (value <= UINT32_MAX)
+    {
+        text_append_uint(text, value);
+        return;
+    }
+    // Digits are written in groups of 9, from the most significant
+    append_uint64(text, value / powers_of_10[MAX_DECIMALS]);
+    text_append_padded(text, value % powers_of_10[MAX_DECIMALS], MAX_DECIMALS);
+}
+
+void append_fraction(TextWriter *text, uint32_t fraction, uint32_t scale, uint8_t decimals)
+{
+    uint32_t unit;
+
+    if (decimals == 0)
+    {
+        return;
+    }
+    decimals = MIN(decimals, MAX_DECIMALS);
+    unit = powers_of_10[decimals];
+
+    text_append_char(text, '.');
+    if (scale % unit == 0)
+    {
+        // Decimal scales only drop the digits past the ones shown
+        fraction /= scale / unit;
+    }
+    else if (fraction <= UINT32_MAX / unit)
+    {
+        fraction = fraction * unit / scale;
+    }
+    else
+    {
+        fraction = (uint64_t)fraction * unit / scale;
+    }
+    text_append_padded(text, fraction, decimals);
+}
+
+int text_finish(TextWriter *text)
+{
+    if (text->size > 0)
+    {
+        text->data[MIN(text->length, text->size - 1)] = '\0';
+    }
+    return text->length;
+}
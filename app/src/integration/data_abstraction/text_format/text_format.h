@@ -0,0 +1,45 @@
+#ifndef TEXT_FORMAT_H
+#define TEXT_FORMAT_H
+
+#include <zephyr/kernel.h>
+
+// Text written by the model encoders, one value at a time, instead of through
+// a format string. As with snprintf, text that doesn't fit the buffer is cut
+// and the buffer is always null-terminated, while the length counts every
+// character appended, so encoders know how large the whole text is
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t length;
+} TextWriter;
+
+// Starts writing text at the beginning of the `size` bytes of `data`
+void text_init(TextWriter *text, uint8_t *data, size_t size);
+
+// Appends a character
+void text_append_char(TextWriter *text, char character);
+
+// Appends a null-terminated string
+void text_append(TextWriter *text, const char *string);
+
+// Appends an integer in decimal
+void text_append_int(TextWriter *text, int32_t value);
+void text_append_uint(TextWriter *text, uint32_t value);
+
+// Appends an integer in decimal, with leading zeros up to `width` digits
+void text_append_padded(TextWriter *text, uint32_t value, uint8_t width);
+
+// Appends a fixed-point value in units of 1/`scale`, truncated to `decimals`
+// digits after the point. Only 32-bit arithmetic is used while the fraction
+// times 10^decimals fits 32 bits, as with every scale of the sensor models
+void text_append_fixed(TextWriter *text, int32_t fixed, uint32_t scale, uint8_t decimals);
+
+// Appends a fixed-point value wider than 32 bits, splitting its integer
+// and fractional parts with a single 64-bit division
+void text_append_fixed64(TextWriter *text, int64_t fixed, uint32_t scale, uint8_t decimals);
+
+// Null-terminates the text and returns its length, as snprintf does
+int text_finish(TextWriter *text);
+
+#endif /* TEXT_FORMAT_H */
@@ -1,5 +1,6 @@
 #include <zephyr/logging/log.h>
 #include <integration/data_abstraction/text_model/text_model.h>
+#include <integration/data_abstraction/text_format/text_format.h>
 #include <integration/data_buffer/buffer_service.h>
 
 LOG_MODULE_REGISTER(text_model, CONFIG_APP_LOG_LEVEL);
@@ -17,15 +18,38 @@ DataAPI text_model_api;
 // Encodes all values of payload into a string
 static int text_encode(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-  return snprintf(encoded_data, encoded_size, "%s\n", (char *)data_words);
+  TextWriter text;
+
+  text_init(&text, encoded_data, encoded_size);
+  text_append(&text, (char *)data_words);
+  text_append_char(&text, '\n');
+  return text_finish(&text);
 }
 
 // Converts data words into bytes
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-  bytecpy(encoded_data, data_words, encoded_size);
+  size_t text_size = SIZE_32_BIT_WORDS_TO_BYTES(MAX_32_WORDS);
+
+  bytecpy(encoded_data, data_words, MIN(encoded_size, text_size));
+
+  return text_size;
+}
+
+// Encodes text into a binary frame with its length in 1 byte, as text has no timestamp
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+  size_t text_size = strnlen((char *)data_words, SIZE_32_BIT_WORDS_TO_BYTES(MAX_32_WORDS));
+
+  if (text_size + 2 > encoded_size)
+  {
+    return -ENOMEM;
+  }
+  encoded_data[0] = TEXT_DATA;
+  encoded_data[1] = text_size;
+  memcpy(&encoded_data[2], data_words, text_size);
 
-  return MAX_32_WORDS;
+  return text_size + 2;
 }
 
 DataAPI *register_text_model_callbacks()
@@ -33,6 +57,8 @@ DataAPI *register_text_model_callbacks()
   text_model_api.encode_verbose = text_encode;
   text_model_api.encode_minimalist = text_encode;
   text_model_api.encode_raw_bytes = encode_raw_bytes;
+  text_model_api.encode_packed_binary = encode_packed_binary;
   text_model_api.num_data_words = MAX_32_WORDS;
+  text_model_api.retention_class = RETENTION_CRITICAL;
   return &text_model_api;
 }
\ No newline at end of file
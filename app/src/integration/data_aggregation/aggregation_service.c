@@ -0,0 +1,254 @@
+#include <zephyr/logging/log.h>
+#include <integration/data_aggregation/aggregation_service.h>
+#include <integration/timestamp/timestamp_service.h>
+#include <sensors/sensors_interface.h>
+#ifdef CONFIG_SEND_ON_DELTA
+#include <integration/data_aggregation/deadband_filter.h>
+#endif /* CONFIG_SEND_ON_DELTA */
+
+LOG_MODULE_REGISTER(aggregation_service, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+#ifdef CONFIG_DATA_AGGREGATION
+// Running statistics of the readings of a sensor in the current window, so
+// memory doesn't grow with the window and no reading has to be kept. Sums are
+// exact integers in the fixed-point scale of each field, taken around the first
+// reading of the window, which keeps them small while readings stay close to it
+typedef struct
+{
+    // Uptime in milliseconds when the window started
+    int64_t start;
+    uint16_t count;
+    uint8_t num_fields;
+    int32_t min[MAX_MODEL_FIELDS];
+    int32_t max[MAX_MODEL_FIELDS];
+    int32_t first[MAX_MODEL_FIELDS];
+    // Sums of the differences to the first reading and of their squares
+    int64_t sum[MAX_MODEL_FIELDS];
+    uint64_t sum_squares[MAX_MODEL_FIELDS];
+} AggregationWindow;
+
+// Window of each sensor, only touched by the thread that reads the sensor
+static AggregationWindow windows[MAX_SENSORS];
+
+// Accumulates the fields of a reading in the window of its sensor, ending the
+// window first if it is over
+static int aggregate_reading(int32_t *fields, int num_fields, enum DataType data_type);
+// Inserts the summary of each field of the window in the application buffer
+static int insert_summaries(AggregationWindow *window, enum DataType data_type);
+// Square of the difference between two fields, which always fits 64 bits
+static uint64_t squared_difference(int32_t field, int32_t first);
+// Returns whether the sums of the window can't take the reading without overflowing
+static bool window_sums_full(AggregationWindow *window, int32_t *fields);
+// Mean of a field, rounded to the nearest fixed-point value
+static int32_t get_window_mean(AggregationWindow *window, int field);
+// Sample standard deviation of a field, rounded to the nearest fixed-point value
+static uint32_t get_window_std_dev(AggregationWindow *window, int field);
+// Square root of dividend / divisor, rounded to the nearest integer
+static uint32_t round_sqrt_quotient(uint64_t dividend, uint32_t divisor);
+#endif /* CONFIG_DATA_AGGREGATION */
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+int insert_sensor_data(uint32_t *data_words, enum DataType data_type,
+                       uint8_t custom_value, uint8_t num_words)
+{
+    BufferReservation reservation;
+    int error = reserve_app_buffer_item(&reservation, data_type, custom_value, num_words);
+
+    if (error)
+    {
+        return error;
+    }
+    memcpy(reservation.data_words, data_words, SIZE_32_BIT_WORDS_TO_BYTES(num_words));
+    return commit_sensor_data(&reservation);
+}
+
+int commit_sensor_data(BufferReservation *reservation)
+{
+#if defined(CONFIG_DATA_AGGREGATION) || defined(CONFIG_SEND_ON_DELTA)
+    enum DataType data_type = reservation->data_type;
+    DataAPI *data_api = get_data_api(data_type);
+
+    if (data_type >= SENSOR_TYPE_OFFSET && data_api->get_fields != NULL)
+    {
+        int32_t fields[MAX_MODEL_FIELDS];
+        int num_fields = data_api->get_fields(reservation->data_words, fields);
+
+#ifdef CONFIG_DATA_AGGREGATION
+        // Reading is only accumulated, and its space is given back before the
+        // summaries of an ended window are inserted in the same lane
+        cancel_app_buffer_item(reservation);
+        return aggregate_reading(fields, num_fields, data_type);
+#else
+        // Readings within the deadband of the last reported one are dropped
+        if (!deadband_should_report(data_type - SENSOR_TYPE_OFFSET, fields, num_fields))
+        {
+            cancel_app_buffer_item(reservation);
+            return 0;
+        }
+#endif /* CONFIG_DATA_AGGREGATION */
+    }
+#endif /* CONFIG_DATA_AGGREGATION || CONFIG_SEND_ON_DELTA */
+    commit_app_buffer_item(reservation);
+    return 0;
+}
+
+#ifdef CONFIG_DATA_AGGREGATION
+int aggregate_reading(int32_t *fields, int num_fields, enum DataType data_type)
+{
+    AggregationWindow *window = &windows[data_type - SENSOR_TYPE_OFFSET];
+    int64_t now = k_uptime_get();
+    int error = 0;
+
+    // Windows end at the first reading after their length has passed,
+    // or early if the count or sums would overflow
+    if (window->count > 0 && (now - window->start >= CONFIG_AGGREGATION_WINDOW ||
+                              window->count == UINT16_MAX || window_sums_full(window, fields)))
+    {
+        error = insert_summaries(window, data_type);
+        window->count = 0;
+    }
+    if (window->count == 0)
+    {
+        window->start = now;
+        window->num_fields = MIN(num_fields, MAX_MODEL_FIELDS);
+    }
+
+    window->count++;
+    for (int i = 0; i < window->num_fields; i++)
+    {
+        if (window->count == 1)
+        {
+            window->min[i] = fields[i];
+            window->max[i] = fields[i];
+            window->first[i] = fields[i];
+            window->sum[i] = 0;
+            window->sum_squares[i] = 0;
+            continue;
+        }
+        window->min[i] = MIN(window->min[i], fields[i]);
+        window->max[i] = MAX(window->max[i], fields[i]);
+        window->sum[i] += (int64_t)fields[i] - window->first[i];
+        window->sum_squares[i] += squared_difference(fields[i], window->first[i]);
+    }
+
+    return error;
+}
+
+uint64_t squared_difference(int32_t field, int32_t first)
+{
+    // Magnitude of the difference of 32-bit fields fits 32 bits
+    uint64_t magnitude = field > first ? (int64_t)field - first : (int64_t)first - field;
+
+    return magnitude * magnitude;
+}
+
+bool window_sums_full(AggregationWindow *window, int32_t *fields)
+{
+    for (int i = 0; i < window->num_fields; i++)
+    {
+        // Sum of differences can't overflow before the sum of their squares does
+        if (window->sum_squares[i] > UINT64_MAX - squared_difference(fields[i], window->first[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int insert_summaries(AggregationWindow *window, enum DataType data_type)
+{
+    BufferReservation reservation;
+    SummaryModel *summary_model;
+    uint32_t timestamp = 0;
+    int32_t mean;
+    uint32_t std_dev;
+    int error = 0;
+
+#ifndef CONFIG_EVENT_TIMESTAMP_NONE
+    timestamp = get_current_timestamp();
+#endif /* CONFIG_EVENT_TIMESTAMP_NONE */
+
+    for (int i = 0; i < window->num_fields; i++)
+    {
+        // Statistics are computed before reserving, as the shared lane is locked until commit
+        mean = get_window_mean(window, i);
+        std_dev = get_window_std_dev(window, i);
+        if (reserve_app_buffer_item(&reservation, SUMMARY_DATA, 0, SUMMARY_MODEL_WORDS) != 0)
+        {
+            LOG_ERR("Failed to insert summary of data type %d in ring buffer.", data_type);
+            error = -ENOMEM;
+            continue;
+        }
+        summary_model = (SummaryModel *)reservation.data_words;
+        summary_model->timestamp = timestamp;
+        summary_model->source_type = data_type;
+        summary_model->field = i;
+        summary_model->count = window->count;
+        summary_model->min = window->min[i];
+        summary_model->max = window->max[i];
+        summary_model->mean = mean;
+        summary_model->std_dev = std_dev;
+        commit_app_buffer_item(&reservation);
+    }
+    LOG_DBG("Summarized %d readings of data type %d", window->count, data_type);
+
+    return error;
+}
+
+int32_t get_window_mean(AggregationWindow *window, int field)
+{
+    int64_t sum = window->sum[field];
+    int64_t half_count = window->count / 2;
+
+    // Rounds halves away from the first reading
+    return window->first[field] + (sum < 0 ? (sum - half_count) : (sum + half_count)) / window->count;
+}
+
+uint32_t get_window_std_dev(AggregationWindow *window, int field)
+{
+    if (window->count < 2)
+    {
+        return 0;
+    }
+    // Squared deviations from the mean add up to sum_squares - sum² / count, where
+    // sum² / count = quotient * |sum| + remainder * quotient + remainder² / count,
+    // so no term exceeds sum_squares
+    uint64_t magnitude = window->sum[field] < 0 ? -window->sum[field] : window->sum[field];
+    uint64_t quotient = magnitude / window->count, remainder = magnitude % window->count;
+    uint64_t squared_sum_by_count = quotient * magnitude + remainder * quotient +
+                                    remainder * remainder / window->count;
+    uint64_t squared_deviations = window->sum_squares[field] - squared_sum_by_count;
+
+    return round_sqrt_quotient(squared_deviations, window->count - 1);
+}
+
+uint32_t round_sqrt_quotient(uint64_t dividend, uint32_t divisor)
+{
+    uint64_t value = dividend / divisor, remainder = dividend % divisor;
+    uint64_t root = 0;
+
+    // Sets the bits of the root from the highest, keeping root² <= value
+    for (int bit = 31; bit >= 0; bit--)
+    {
+        uint64_t candidate = root | (1ULL << bit);
+
+        if (candidate * candidate <= value)
+        {
+            root = candidate;
+        }
+    }
+    // Nearest integer is above when the quotient reaches (root + 0.5)² = root² + root + 0.25,
+    // where only the remainder can make up the quarter
+    uint64_t excess = value - root * root;
+    bool round_up = excess > root || (excess == root && 4 * remainder >= divisor);
+
+    return round_up && root < UINT32_MAX ? root + 1 : root;
+}
+#endif /* CONFIG_DATA_AGGREGATION */
@@ -0,0 +1,43 @@
+#ifndef AGGREGATION_SERVICE_H
+#define AGGREGATION_SERVICE_H
+
+#include <zephyr/kernel.h>
+#include <integration/data_buffer/buffer_service.h>
+
+// Statistics of one field of a sensor over an aggregation window,
+// in the fixed-point scale of the field
+typedef struct
+{
+    uint32_t timestamp;
+    // Data type of the summarized sensor
+    uint8_t source_type;
+    // Position of the summarized field in the binary frame of the sensor
+    uint8_t field;
+    // Number of readings in the window
+    uint16_t count;
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    // Sample standard deviation
+    uint32_t std_dev;
+} SummaryModel;
+
+// Number of 32-bit words in each data item (model)
+#define SUMMARY_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SummaryModel))
+
+// Passes a sensor reading to the application buffer. With CONFIG_DATA_AGGREGATION,
+// readings of data types that expose their fields are accumulated instead, and only
+// the summaries of each field are inserted when the aggregation window ends. With
+// CONFIG_SEND_ON_DELTA, they are only inserted when they leave the deadband
+// of the last inserted reading
+int insert_sensor_data(uint32_t *data_words, enum DataType data_type,
+                       uint8_t custom_value, uint8_t num_words);
+
+// Same as insert_sensor_data, for a reading the sensor service wrote in place in
+// space reserved with reserve_app_buffer_item. The reservation is always released
+int commit_sensor_data(BufferReservation *reservation);
+
+// Registers summary model callbacks
+DataAPI *register_summary_model_callbacks();
+
+#endif /* AGGREGATION_SERVICE_H */
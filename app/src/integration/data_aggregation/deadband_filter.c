@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <zephyr/logging/log.h>
+#include <integration/data_aggregation/deadband_filter.h>
+
+LOG_MODULE_REGISTER(deadband_filter, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+// Default deadbands, in the fixed-point scales of the sensor models, set around
+// the accuracy of each sensor. Sensors that change quickly aren't filtered
+static DeadbandThreshold thresholds[MAX_SENSORS][MAX_MODEL_FIELDS] = {
+    // Pressure, temperature and humidity
+    [BME280] = {{.absolute = 50}, {.absolute = 20}, {.absolute = 100}},
+    // Light, infrared, UV and UV index
+    [SI1133] = {{.absolute = 1, .relative_permille = 100},
+                {.absolute = 1, .relative_permille = 100},
+                {.absolute = 1, .relative_permille = 100},
+                {.absolute = 50}},
+    // Voltage in millivolts
+    [VBATT] = {{.absolute = 20}},
+    // CO2, temperature and humidity
+    [SCD30] = {{.absolute = 30, .relative_permille = 30}, {.absolute = 20}, {.absolute = 100}},
+};
+
+// Last reported reading of a sensor
+typedef struct
+{
+    bool reported_once;
+    // Uptime in milliseconds of the last report
+    int64_t time;
+    int32_t fields[MAX_MODEL_FIELDS];
+} ReportedReading;
+
+// Each entry is only touched by the thread that reads its sensor
+static ReportedReading last_reports[MAX_SENSORS];
+static DeadbandStats deadband_stats[MAX_SENSORS];
+
+// Returns whether value is farther than the deadband from the reported one
+static bool left_deadband(DeadbandThreshold *threshold, int32_t value, int32_t reported);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+bool deadband_should_report(enum SensorType sensor, int32_t *fields, int num_fields)
+{
+    ReportedReading *last_report = &last_reports[sensor];
+    DeadbandStats *stats = &deadband_stats[sensor];
+    int64_t now = k_uptime_get();
+    bool filtered = false, report = !last_report->reported_once;
+
+    num_fields = MIN(num_fields, MAX_MODEL_FIELDS);
+    for (int i = 0; i < num_fields; i++)
+    {
+        DeadbandThreshold *threshold = &thresholds[sensor][i];
+
+        // Measurements without deadband don't trigger reports by themselves
+        if (threshold->absolute == 0 && threshold->relative_permille == 0)
+        {
+            continue;
+        }
+        filtered = true;
+        if (left_deadband(threshold, fields[i], last_report->fields[i]))
+        {
+            report = true;
+        }
+    }
+    // Sensors without any deadband are passed through without being counted
+    if (!filtered)
+    {
+        return true;
+    }
+
+    if (!report && now - last_report->time >= CONFIG_SEND_ON_DELTA_HEARTBEAT)
+    {
+        stats->heartbeats++;
+        report = true;
+    }
+    if (!report)
+    {
+        stats->suppressed++;
+        return false;
+    }
+
+    stats->reported++;
+    last_report->reported_once = true;
+    last_report->time = now;
+    memcpy(last_report->fields, fields, num_fields * sizeof(int32_t));
+    return true;
+}
+
+bool left_deadband(DeadbandThreshold *threshold, int32_t value, int32_t reported)
+{
+    int64_t delta = llabs((int64_t)value - reported);
+    int64_t relative = llabs((int64_t)reported) * threshold->relative_permille / 1000;
+
+    return delta > MAX(threshold->absolute, relative);
+}
+
+int set_deadband_threshold(enum SensorType sensor, int field, int32_t absolute,
+                           uint16_t relative_permille)
+{
+    if (sensor < 0 || sensor >= MAX_SENSORS || field < 0 || field >= MAX_MODEL_FIELDS ||
+        absolute < 0)
+    {
+        return -EINVAL;
+    }
+    thresholds[sensor][field].absolute = absolute;
+    thresholds[sensor][field].relative_permille = relative_permille;
+    LOG_DBG("Deadband of field %d of sensor %d set to %d or %d/1000", field, sensor,
+            absolute, relative_permille);
+
+    return 0;
+}
+
+int get_deadband_threshold(enum SensorType sensor, int field, DeadbandThreshold *threshold)
+{
+    if (sensor < 0 || sensor >= MAX_SENSORS || field < 0 || field >= MAX_MODEL_FIELDS)
+    {
+        return -EINVAL;
+    }
+    *threshold = thresholds[sensor][field];
+
+    return 0;
+}
+
+int get_deadband_stats(enum SensorType sensor, DeadbandStats *stats)
+{
+    if (sensor < 0 || sensor >= MAX_SENSORS)
+    {
+        return -EINVAL;
+    }
+    *stats = deadband_stats[sensor];
+
+    return 0;
+}
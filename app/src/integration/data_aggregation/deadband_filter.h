@@ -0,0 +1,40 @@
+#ifndef DEADBAND_FILTER_H
+#define DEADBAND_FILTER_H
+
+#include <zephyr/kernel.h>
+#include <sensors/sensors_interface.h>
+
+// How far a measurement must move from its last reported value for a reading to be
+// reported. The deadband is the larger of both, so the absolute threshold also works
+// as a floor for the relative one near zero. Measurements with both 0 have no deadband
+// and sensors without any deadband aren't filtered
+typedef struct
+{
+    // In the fixed-point scale of the measurement
+    int32_t absolute;
+    // In thousandths of the last reported value
+    uint16_t relative_permille;
+} DeadbandThreshold;
+
+// Metrics of how many readings of a sensor the deadband filter let through
+typedef struct
+{
+    uint32_t reported;
+    uint32_t suppressed;
+    // Readings reported only because the heartbeat expired
+    uint32_t heartbeats;
+} DeadbandStats;
+
+// Returns whether a reading of sensor must be stored, because one of its measurements,
+// in the order of get_fields of its DataAPI, left its deadband or because
+// CONFIG_SEND_ON_DELTA_HEARTBEAT passed since the last reported reading
+bool deadband_should_report(enum SensorType sensor, int32_t *fields, int num_fields);
+// Sets the deadband of a measurement of sensor, by its position in the binary frame
+int set_deadband_threshold(enum SensorType sensor, int field, int32_t absolute,
+                           uint16_t relative_permille);
+// Gets the deadband of a measurement of sensor
+int get_deadband_threshold(enum SensorType sensor, int field, DeadbandThreshold *threshold);
+// Gets how many readings of sensor were reported and suppressed
+int get_deadband_stats(enum SensorType sensor, DeadbandStats *stats);
+
+#endif /* DEADBAND_FILTER_H */
@@ -0,0 +1,119 @@
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <integration/data_aggregation/aggregation_service.h>
+
+#include <integration/data_abstraction/text_format/text_format.h>
+
+LOG_MODULE_REGISTER(summary_model, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+// Bytes of the fields of the binary frame
+#define SUMMARY_FIELDS_SIZE 20
+
+static DataAPI summary_model_api;
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+// Encodes all values of data model into a verbose string. Statistics
+// are kept in the fixed-point scale of the summarized field
+static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SummaryModel *summary_model = (SummaryModel *)data_words;
+    TextWriter text;
+
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, summary_model->timestamp);
+    text_append(&text, "; Summary of data type ");
+    text_append_uint(&text, summary_model->source_type);
+    text_append(&text, ", field ");
+    text_append_uint(&text, summary_model->field);
+    text_append(&text, "; Readings: ");
+    text_append_uint(&text, summary_model->count);
+    text_append(&text, "; Min: ");
+    text_append_int(&text, summary_model->min);
+    text_append(&text, "; Max: ");
+    text_append_int(&text, summary_model->max);
+    text_append(&text, "; Mean: ");
+    text_append_int(&text, summary_model->mean);
+    text_append(&text, "; Standard deviation: ");
+    text_append_uint(&text, summary_model->std_dev);
+    text_append_char(&text, ';');
+    return text_finish(&text);
+}
+
+// Encodes all values of data model into a minimal string
+static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SummaryModel *summary_model = (SummaryModel *)data_words;
+    TextWriter text;
+
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, summary_model->timestamp);
+    text_append_char(&text, 'S');
+    text_append_uint(&text, summary_model->source_type);
+    text_append_char(&text, '.');
+    text_append_uint(&text, summary_model->field);
+    text_append_char(&text, 'N');
+    text_append_uint(&text, summary_model->count);
+    text_append_char(&text, 'L');
+    text_append_int(&text, summary_model->min);
+    text_append_char(&text, 'H');
+    text_append_int(&text, summary_model->max);
+    text_append_char(&text, 'M');
+    text_append_int(&text, summary_model->mean);
+    text_append_char(&text, 'D');
+    text_append_uint(&text, summary_model->std_dev);
+    return text_finish(&text);
+}
+
+static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Copies the model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SummaryModel)));
+
+    return sizeof(SummaryModel);
+}
+
+// Encodes data model into a binary frame with the summarized data type and field
+// in 1 byte each, the count in 2 bytes and the statistics in 4 bytes each
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SummaryModel *summary_model = (SummaryModel *)data_words;
+    int header_size = encode_packed_header(SUMMARY_DATA, summary_model->timestamp,
+                                           SUMMARY_FIELDS_SIZE, encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    uint8_t *fields = &encoded_data[header_size];
+    fields[0] = summary_model->source_type;
+    fields[1] = summary_model->field;
+    sys_put_le16(summary_model->count, &fields[2]);
+    sys_put_le32(summary_model->min, &fields[4]);
+    sys_put_le32(summary_model->max, &fields[8]);
+    sys_put_le32(summary_model->mean, &fields[12]);
+    sys_put_le32(summary_model->std_dev, &fields[16]);
+
+    return header_size + SUMMARY_FIELDS_SIZE;
+}
+
+// Registers summary model callbacks
+DataAPI *register_summary_model_callbacks()
+{
+    summary_model_api.num_data_words = SUMMARY_MODEL_WORDS;
+    // Each summary stands for a whole window of readings
+    summary_model_api.retention_class = RETENTION_CRITICAL;
+    summary_model_api.encode_verbose = encode_verbose;
+    summary_model_api.encode_minimalist = encode_minimalist;
+    summary_model_api.encode_raw_bytes = encode_raw_bytes;
+    summary_model_api.encode_packed_binary = encode_packed_binary;
+    return &summary_model_api;
+}
@@ -0,0 +1,298 @@
+#include <zephyr/logging/log.h>
+#include <integration/data_buffer/block_compression/block_compression.h>
+
+LOG_MODULE_REGISTER(block_compression, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+#define COMPRESSED_BLOCK_BITS (COMPRESSED_BLOCK_WORDS * 32)
+// Bits used to encode the leading zeros and the length of the meaningful bits of a XOR
+#define WINDOW_FIELD_BITS 5
+
+// Ranges of the delta of delta encoded after each prefix, as signed integers of
+// 7, 9 and 12 bits. Larger ones are encoded as the full 32-bit delta
+#define DOD_7_BITS_MAX 63
+#define DOD_9_BITS_MAX 255
+#define DOD_12_BITS_MAX 2047
+
+BUILD_ASSERT(COMPRESSED_BLOCK_WORDS >= MAX_32_WORDS,
+             "BUFFER_COMPRESSION_BLOCK_WORDS must fit at least one item of maximum size");
+
+// Reading position in an encoded block
+typedef struct
+{
+    uint32_t *words;
+    uint16_t num_bits;
+    uint16_t position;
+    bool overflow;
+} BitReader;
+
+// Writes the `num_bits` least significant bits of value, most significant first.
+// Returns false if they don't fit in the block
+static bool write_bits(CompressedBlock *block, uint32_t value, uint8_t num_bits);
+// Reads `num_bits` bits as an unsigned integer
+static uint32_t read_bits(BitReader *reader, uint8_t num_bits);
+// Reads `num_bits` bits as a signed integer
+static int32_t read_signed_bits(BitReader *reader, uint8_t num_bits);
+// Encodes the delta of the delta between the first word of consecutive records
+static bool write_delta_of_delta(CompressedBlock *block, uint32_t word);
+// Encodes XOR between a word and its value in the previous record
+static bool write_xor(CompressedBlock *block, int index, uint32_t word);
+// Clears the bits after the end of the encoded records
+static void clear_unused_bits(CompressedBlock *block);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+void start_compressed_block(CompressedBlock *block, uint8_t record_words)
+{
+    memset(block, 0, sizeof(CompressedBlock));
+    block->record_words = record_words;
+}
+
+int add_compressed_record(CompressedBlock *block, uint32_t *record)
+{
+    uint16_t previous_bits = block->num_bits;
+    int32_t previous_delta = block->previous_delta;
+    uint8_t leading_zeros[MAX_32_WORDS], meaningful_bits[MAX_32_WORDS];
+    bool fits = true;
+
+    memcpy(leading_zeros, block->leading_zeros, sizeof(leading_zeros));
+    memcpy(meaningful_bits, block->meaningful_bits, sizeof(meaningful_bits));
+
+    // First record is stored as it is, and is the reference of the next ones
+    if (block->num_records == 0)
+    {
+        for (int i = 0; i < block->record_words && fits; i++)
+        {
+            fits = write_bits(block, record[i], 32);
+        }
+    }
+    else
+    {
+        fits = write_delta_of_delta(block, record[0]);
+        for (int i = 1; i < block->record_words && fits; i++)
+        {
+            fits = write_xor(block, i, record[i]);
+        }
+    }
+
+    if (!fits)
+    {
+        block->num_bits = previous_bits;
+        block->previous_delta = previous_delta;
+        memcpy(block->leading_zeros, leading_zeros, sizeof(leading_zeros));
+        memcpy(block->meaningful_bits, meaningful_bits, sizeof(meaningful_bits));
+        clear_unused_bits(block);
+        return -ENOSPC;
+    }
+
+    if (block->num_records > 0)
+    {
+        block->previous_delta = record[0] - block->previous_record[0];
+    }
+    memcpy(block->previous_record, record, SIZE_32_BIT_WORDS_TO_BYTES(block->record_words));
+    block->num_records++;
+    return 0;
+}
+
+uint8_t get_compressed_block_words(CompressedBlock *block)
+{
+    return DIV_ROUND_UP(block->num_bits, 32);
+}
+
+int decompress_block(uint32_t *block_words, uint8_t num_words, uint8_t num_records,
+                     uint8_t record_words, uint32_t *records)
+{
+    BitReader reader = {
+        .words = block_words,
+        .num_bits = num_words * 32,
+    };
+    uint8_t leading_zeros[MAX_32_WORDS] = {0}, meaningful_bits[MAX_32_WORDS] = {0};
+    int32_t previous_delta = 0;
+
+    if (num_records == 0 || record_words == 0 || record_words > MAX_32_WORDS)
+    {
+        return -EINVAL;
+    }
+
+    for (int i = 0; i < record_words; i++)
+    {
+        records[i] = read_bits(&reader, 32);
+    }
+
+    for (int record = 1; record < num_records; record++)
+    {
+        uint32_t *previous = &records[(record - 1) * record_words];
+        uint32_t *current = &records[record * record_words];
+        int32_t delta;
+
+        // Prefix '0', '10', '110', '1110' or '1111' tells the size of the delta of delta
+        if (!read_bits(&reader, 1))
+        {
+            delta = previous_delta;
+        }
+        else if (!read_bits(&reader, 1))
+        {
+            delta = previous_delta + read_signed_bits(&reader, 7);
+        }
+        else if (!read_bits(&reader, 1))
+        {
+            delta = previous_delta + read_signed_bits(&reader, 9);
+        }
+        else if (!read_bits(&reader, 1))
+        {
+            delta = previous_delta + read_signed_bits(&reader, 12);
+        }
+        else
+        {
+            delta = read_bits(&reader, 32);
+        }
+        current[0] = previous[0] + delta;
+        previous_delta = delta;
+
+        for (int i = 1; i < record_words; i++)
+        {
+            uint32_t xor = 0;
+            // Prefix '0' means same value, '10' XOR in the previous window, '11' a new window
+            if (read_bits(&reader, 1))
+            {
+                if (read_bits(&reader, 1))
+                {
+                    leading_zeros[i] = read_bits(&reader, WINDOW_FIELD_BITS);
+                    meaningful_bits[i] = read_bits(&reader, WINDOW_FIELD_BITS) + 1;
+                }
+                uint8_t trailing_zeros = 32 - leading_zeros[i] - meaningful_bits[i];
+                xor = read_bits(&reader, meaningful_bits[i]) << trailing_zeros;
+            }
+            current[i] = previous[i] ^ xor;
+        }
+    }
+
+    if (reader.overflow)
+    {
+        LOG_ERR("Compressed block is shorter than its records");
+        return -EINVAL;
+    }
+    return num_records;
+}
+
+bool write_bits(CompressedBlock *block, uint32_t value, uint8_t num_bits)
+{
+    if (block->num_bits + num_bits > COMPRESSED_BLOCK_BITS)
+    {
+        return false;
+    }
+    while (num_bits > 0)
+    {
+        uint8_t offset = block->num_bits % 32;
+        uint8_t chunk_bits = MIN(32 - offset, num_bits);
+        uint32_t chunk = (uint32_t)((uint64_t)value >> (num_bits - chunk_bits)) &
+                         (uint32_t)BIT64_MASK(chunk_bits);
+
+        block->words[block->num_bits / 32] |= chunk << (32 - offset - chunk_bits);
+        block->num_bits += chunk_bits;
+        num_bits -= chunk_bits;
+    }
+    return true;
+}
+
+uint32_t read_bits(BitReader *reader, uint8_t num_bits)
+{
+    uint32_t value = 0;
+
+    if (reader->position + num_bits > reader->num_bits)
+    {
+        reader->overflow = true;
+        return 0;
+    }
+    while (num_bits > 0)
+    {
+        uint8_t offset = reader->position % 32;
+        uint8_t chunk_bits = MIN(32 - offset, num_bits);
+        uint32_t chunk = (reader->words[reader->position / 32] >> (32 - offset - chunk_bits)) &
+                         (uint32_t)BIT64_MASK(chunk_bits);
+
+        value = (uint32_t)((uint64_t)value << chunk_bits) | chunk;
+        reader->position += chunk_bits;
+        num_bits -= chunk_bits;
+    }
+    return value;
+}
+
+int32_t read_signed_bits(BitReader *reader, uint8_t num_bits)
+{
+    return sign_extend(read_bits(reader, num_bits), num_bits - 1);
+}
+
+bool write_delta_of_delta(CompressedBlock *block, uint32_t word)
+{
+    int32_t delta = word - block->previous_record[0];
+    int64_t delta_of_delta = (int64_t)delta - block->previous_delta;
+
+    if (delta_of_delta == 0)
+    {
+        return write_bits(block, 0b0, 1);
+    }
+    if (delta_of_delta >= -DOD_7_BITS_MAX - 1 && delta_of_delta <= DOD_7_BITS_MAX)
+    {
+        return write_bits(block, 0b10, 2) && write_bits(block, delta_of_delta, 7);
+    }
+    if (delta_of_delta >= -DOD_9_BITS_MAX - 1 && delta_of_delta <= DOD_9_BITS_MAX)
+    {
+        return write_bits(block, 0b110, 3) && write_bits(block, delta_of_delta, 9);
+    }
+    if (delta_of_delta >= -DOD_12_BITS_MAX - 1 && delta_of_delta <= DOD_12_BITS_MAX)
+    {
+        return write_bits(block, 0b1110, 4) && write_bits(block, delta_of_delta, 12);
+    }
+    return write_bits(block, 0b1111, 4) && write_bits(block, delta, 32);
+}
+
+bool write_xor(CompressedBlock *block, int index, uint32_t word)
+{
+    uint32_t xor = word ^ block->previous_record[index];
+    uint8_t leading_zeros, trailing_zeros, meaningful_bits;
+
+    if (xor == 0)
+    {
+        return write_bits(block, 0b0, 1);
+    }
+
+    // XOR isn't zero, so there are at most 31 leading zeros, which fit in the window field
+    leading_zeros = __builtin_clz(xor);
+    trailing_zeros = __builtin_ctz(xor);
+
+    // Reuses the window of the previous XOR if the meaningful bits fit in it
+    if (block->meaningful_bits[index] > 0 && leading_zeros >= block->leading_zeros[index] &&
+        trailing_zeros >= 32 - block->leading_zeros[index] - block->meaningful_bits[index])
+    {
+        trailing_zeros = 32 - block->leading_zeros[index] - block->meaningful_bits[index];
+        return write_bits(block, 0b10, 2) &&
+               write_bits(block, xor >> trailing_zeros, block->meaningful_bits[index]);
+    }
+
+    meaningful_bits = 32 - leading_zeros - trailing_zeros;
+    block->leading_zeros[index] = leading_zeros;
+    block->meaningful_bits[index] = meaningful_bits;
+    return write_bits(block, 0b11, 2) &&
+           write_bits(block, leading_zeros, WINDOW_FIELD_BITS) &&
+           write_bits(block, meaningful_bits - 1, WINDOW_FIELD_BITS) &&
+           write_bits(block, xor >> trailing_zeros, meaningful_bits);
+}
+
+void clear_unused_bits(CompressedBlock *block)
+{
+    uint16_t word = block->num_bits / 32;
+    uint8_t offset = block->num_bits % 32;
+
+    if (offset > 0)
+    {
+        block->words[word] &= ~(uint32_t)BIT64_MASK(32 - offset);
+        word++;
+    }
+    memset(&block->words[word], 0, SIZE_32_BIT_WORDS_TO_BYTES(COMPRESSED_BLOCK_WORDS - word));
+}
@@ -0,0 +1,39 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <zephyr/kernel.h>
+#include <integration/data_buffer/buffer_service.h>
+
+// Maximum size in 32-bit words of a block of compressed records
+#define COMPRESSED_BLOCK_WORDS CONFIG_BUFFER_COMPRESSION_BLOCK_WORDS
+
+// Records of the same data type encoded as in Facebook's Gorilla time series
+// database: the first word of each record, usually the timestamp, as the
+// delta of its delta, and every other word XORed with its previous value
+typedef struct
+{
+    uint32_t words[COMPRESSED_BLOCK_WORDS];
+    // Size of the encoded records in bits
+    uint16_t num_bits;
+    uint8_t num_records;
+    // Size of each record in 32-bit words
+    uint8_t record_words;
+    uint32_t previous_record[MAX_32_WORDS];
+    int32_t previous_delta;
+    // Window of the meaningful bits of the last XOR of each word
+    uint8_t leading_zeros[MAX_32_WORDS];
+    uint8_t meaningful_bits[MAX_32_WORDS];
+} CompressedBlock;
+
+// Starts an empty block of records with `record_words` 32-bit words each
+void start_compressed_block(CompressedBlock *block, uint8_t record_words);
+// Encodes record at the end of the block. Returns -ENOSPC, leaving the
+// block unchanged, if the record doesn't fit
+int add_compressed_record(CompressedBlock *block, uint32_t *record);
+// Returns the size in 32-bit words of the encoded records
+uint8_t get_compressed_block_words(CompressedBlock *block);
+// Decodes the records of a block into `records`, one after the other
+int decompress_block(uint32_t *block_words, uint8_t num_words, uint8_t num_records,
+                     uint8_t record_words, uint32_t *records);
+
+#endif /* BLOCK_COMPRESSION_H */
@@ -1,5 +1,13 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/atomic.h>
 #include <integration/data_buffer/buffer_service.h>
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+#include <integration/data_buffer/flash_spill/flash_spill.h>
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+#if defined(CONFIG_BUFFER_COMPRESSION)
+#include <integration/data_buffer/block_compression/block_compression.h>
+#endif /* CONFIG_BUFFER_COMPRESSION */
 
 LOG_MODULE_REGISTER(data_buffer, CONFIG_APP_LOG_LEVEL);
 
@@ -7,8 +15,204 @@ LOG_MODULE_REGISTER(data_buffer, CONFIG_APP_LOG_LEVEL);
  * DEFINITIONS
  */
 
-// Initializes ring buffer that will store data until it is read and sent
-RING_BUF_ITEM_DECLARE(app_buffer, CONFIG_BUFFER_WORDS);
+// Lanes of registered producers plus the one shared by interrupts and other threads
+#define NUM_LANES (CONFIG_BUFFER_INGESTION_LANES + 1)
+#define SHARED_LANE CONFIG_BUFFER_INGESTION_LANES
+// Words of the configured buffer size that are taken by the lanes
+#define LANES_WORDS (NUM_LANES * CONFIG_BUFFER_LANE_WORDS)
+// Lane occupancy in 32-bit words that wakes up the reading thread to merge it
+#define LANE_WATERMARK_WORDS (CONFIG_BUFFER_LANE_WORDS / 2)
+// Words of the application buffer log, which holds the merged items
+#define APP_LOG_WORDS (CONFIG_BUFFER_WORDS - LANES_WORDS)
+// Type of the item that fills the end of the log or of a lane when the next item
+// doesn't fit there, so every item is contiguous and can be read in place
+#define PADDING_TYPE UINT8_MAX
+// Size of the header preceding each item in the log
+#define ITEM_HEADER_WORDS 1
+// Flags the data type of items holding a block of compressed records
+#define COMPRESSED_TYPE_FLAG BIT(7)
+// Data type of the records held by an item
+#define ITEM_DATA_TYPE(data_type) ((data_type) & ~COMPRESSED_TYPE_FLAG)
+
+#if defined(CONFIG_BUFFER_COMPRESSION)
+// Maximum size of an item in the log, which may be a compressed block
+#define MAX_ITEM_WORDS MAX(MAX_32_WORDS, COMPRESSED_BLOCK_WORDS)
+// Words where each cursor decodes the compressed records it peeks
+#define DECODED_WORDS (CONFIG_BUFFER_COMPRESSION_BLOCK_RECORDS * MAX_32_WORDS)
+#else
+#define MAX_ITEM_WORDS MAX_32_WORDS
+#endif /* CONFIG_BUFFER_COMPRESSION */
+
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+// Log occupancy in 32-bit words above which new items are moved to flash,
+// and up to which items are read back from it
+#define SPILL_WATERMARK_WORDS (APP_LOG_WORDS / 100 * CONFIG_BUFFER_SPILL_WATERMARK)
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+
+BUILD_ASSERT(CONFIG_BUFFER_WORDS > LANES_WORDS,
+             "BUFFER_WORDS must be larger than the words taken by the ingestion lanes");
+BUILD_ASSERT(CONFIG_BUFFER_LANE_WORDS > MAX_32_WORDS,
+             "BUFFER_LANE_WORDS must fit at least one item of maximum size");
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+BUILD_ASSERT(SPILL_BLOCK_WORDS >= ITEM_HEADER_WORDS + MAX_ITEM_WORDS,
+             "BUFFER_SPILL_BLOCK_WORDS must fit at least one item of maximum size");
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+
+// Single producer, single consumer staging buffer in front of the application buffer
+typedef struct
+{
+    struct ring_buf ring;
+    uint32_t storage[CONFIG_BUFFER_LANE_WORDS];
+    // Registered thread that inserts in this lane, NULL while the lane is free
+    atomic_ptr_t owner;
+    // Number of items dropped because the lane was full
+    atomic_t dropped;
+} IngestionLane;
+
+// Header of an item in the application buffer log
+typedef struct
+{
+    uint8_t data_type;
+    // Cursors that already read this item before it was moved forward in the log
+    uint8_t read_cursors;
+    uint8_t custom_value;
+    uint8_t num_words;
+} ItemHeader;
+
+BUILD_ASSERT(sizeof(ItemHeader) == SIZE_32_BIT_WORDS_TO_BYTES(ITEM_HEADER_WORDS));
+BUILD_ASSERT(MAX_DATA_TYPE < COMPRESSED_TYPE_FLAG, "Data types must fit in the item header");
+BUILD_ASSERT(MAX_BUFFER_CURSORS <= 8, "Cursors must fit in the item header mask");
+
+// Reading position of a consumer of the application buffer
+typedef struct
+{
+    bool registered;
+    // Log position of the next item to be read
+    uint32_t read_position;
+    // Words between the read position and the write position
+    uint32_t unread_words;
+    // Words of the items peeked and not yet released, which can't be reclaimed
+    uint32_t peeked_words;
+    // Number of items skipped because the cursor lagged behind
+    uint32_t skipped_items;
+} BufferCursor;
+
+// Lanes where producers insert data without contending with each other
+static IngestionLane ingestion_lanes[NUM_LANES];
+// Serializes the producers of the shared lane
+static struct k_spinlock shared_lane_lock;
+// Signals the reading thread that a lane passed its watermark
+static K_SEM_DEFINE(lanes_watermark, 0, 1);
+// Log shared by all cursors, holding data until every cursor has read it
+static uint32_t app_log[APP_LOG_WORDS];
+// Log position where the next item will be written, only changed by the reading thread
+static uint32_t write_position;
+// Log position of the oldest item that some cursor hasn't read yet
+static uint32_t tail_position;
+// Words between the tail and the write position, which can't be overwritten
+static uint32_t held_words;
+// Number of items between the tail and the write position of each retention class
+static uint32_t held_items[MAX_RETENTION_CLASSES];
+// Reading cursors of the consumers
+static BufferCursor buffer_cursors[MAX_BUFFER_CURSORS];
+// Protects the cursors and the log positions
+static struct k_spinlock log_lock;
+// Number of items of each data type dropped from the buffer or before entering it
+static atomic_t dropped_items[MAX_DATA_TYPE];
+#if defined(CONFIG_BUFFER_COMPRESSION)
+// Blocks being filled with the records of each data type, only used by the reading thread
+static CompressedBlock open_blocks[MAX_DATA_TYPE];
+// Uptime when the first record of each open block was added
+static int64_t open_block_times[MAX_DATA_TYPE];
+// Records decoded from the compressed blocks peeked by each cursor
+static uint32_t decoded_records[MAX_BUFFER_CURSORS][DECODED_WORDS];
+#endif /* CONFIG_BUFFER_COMPRESSION */
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+// Block of new items to be written to flash after the ones already there,
+// only used by the reading thread
+static uint32_t staged_block[SPILL_BLOCK_WORDS];
+static uint32_t staged_words;
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+
+// Initializes the lanes ring buffers
+static int init_ingestion_lanes(void);
+SYS_INIT(init_ingestion_lanes, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+// Returns the lane registered to the current thread, or the shared lane
+static IngestionLane *get_producer_lane();
+// Reserves contiguous space for an item in the producer's lane, without zeroing it
+static int reserve_lane_item(BufferReservation *reservation, enum DataType data_type,
+                             uint8_t custom_value, uint8_t num_words);
+// Claims contiguous space in the lane for an item with its header, filling the end
+// of the lane with padding if the item doesn't fit there. Returns NULL if the lane is full
+static struct ring_element *claim_lane_space(IngestionLane *lane, uint32_t item_words);
+// Gets the oldest item of the lane in place, skipping padding. Returns NULL if the lane is empty
+static struct ring_element *peek_lane_item(IngestionLane *lane);
+// Moves all items in the lanes to the application buffer log
+static void merge_ingestion_lanes();
+// Inserts a new item after every item buffered before it, in the log or in flash
+static int insert_item(ItemHeader header, uint32_t *data_words);
+// Appends item to the log, reclaiming space according to the lagging cursor policy
+static int append_to_log(ItemHeader header, uint32_t *data_words);
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+// Reads items back from flash while the log is below the spill watermark,
+// followed by the staged items once flash has no more
+static void balance_buffer_tiers();
+// Adds item to the staged block, writing the block to flash when it's full
+static void stage_spill_item(ItemHeader header, uint32_t *data_words);
+// Writes the staged block to flash. If it fails, its items are appended to the log
+// when flash has no older items, and dropped otherwise
+static void spill_staged_block();
+// Moves the staged items to the log, or counts them as dropped
+static void flush_staged_items(bool drop_items);
+// Verifies if an item read back from flash, which may have been spilled by another
+// build or before a sensor failed, can be decoded by this one
+static bool is_spilled_item_supported(ItemHeader header);
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+#if defined(CONFIG_BUFFER_COMPRESSION)
+// Adds item to the open block of its data type, appending the block to the log when
+// it's full. Returns -ENOTSUP if the item must be stored as it is
+static int compress_item(ItemHeader header, uint32_t *data_words);
+// Appends the open block of data type to the log
+static void seal_compressed_block(uint8_t data_type);
+// Appends blocks open for longer than the maximum delay to the log
+static void seal_stale_blocks();
+// Replaces the compressed blocks among peeked items by the records decoded from them,
+// dropping blocks that fail to decompress. Returns the number of records left
+static int expand_compressed_items(int cursor_id, BufferItem *items, int num_items,
+                                   int num_records);
+#endif /* CONFIG_BUFFER_COMPRESSION */
+// Counts the records held by a dropped item and returns the total dropped of its type
+static atomic_val_t count_dropped_items(ItemHeader header);
+// Peeks up to `max_items` records of the cursor in the log, setting the number of
+// items they are held in, which may be compressed blocks, and returns the records
+static int peek_log_items(int cursor_id, BufferItem *items, int max_items, int *num_items_peeked);
+
+// The following functions must be called with log_lock held
+
+// Frees the oldest item in the log, evicting it or, if less important data is held,
+// moving it forward. Returns -ENOMEM if the new item is the one to be dropped
+static int evict_oldest_item(enum RetentionClass new_item_class);
+// Moves the oldest item to the write position, keeping it in the buffer
+static void relocate_oldest_item(ItemHeader header);
+// Removes the oldest item from the log, copying its data and marking in its header
+// the cursors that already read it. Returns false if every cursor read it
+static bool take_oldest_item(ItemHeader *header, uint32_t *data_words);
+// Verifies if the slowest cursors are processing the oldest items
+static bool slowest_cursors_busy();
+// Moves the slowest cursors past the oldest item
+static void skip_slowest_cursors(ItemHeader header, bool count_skipped);
+// Writes item at the write position and publishes it to every cursor.
+// There must be space for the item and the padding it may need
+static void write_item(ItemHeader header, uint32_t *data_words);
+// Returns padding needed before writing an item of `item_words`
+static uint32_t get_padding_words(uint32_t item_words);
+// Moves the tail past the items every cursor has already read
+static void release_held_items();
+// Returns retention class of data type
+static enum RetentionClass get_retention_class(uint16_t data_type);
+// Inserts item in buffer, removing oldest items until it fits
+static int put_dropping_oldest(struct ring_buf *buffer, uint32_t *data_words, enum DataType data_type,
+                               uint8_t custom_value, uint8_t num_words);
 // Peeks into buffer to return type of data
 static int get_data_type(struct ring_buf *buffer, enum DataType *data_type);
 // Parses data from buffer according to data type
@@ -18,6 +222,17 @@ static int parse_buffer_data(struct ring_buf *buffer, uint32_t *data_words, enum
  * IMPLEMENTATIONS
  */
 
+int init_ingestion_lanes(void)
+{
+    for (int i = 0; i < NUM_LANES; i++)
+    {
+        ring_buf_item_init(&ingestion_lanes[i].ring, CONFIG_BUFFER_LANE_WORDS,
+                           ingestion_lanes[i].storage);
+    }
+    // Work items of the sensor drivers and the GNSS modem run on the system workqueue
+    return register_buffer_producer(&k_sys_work_q.thread);
+}
+
 int get_from_buffer(struct ring_buf *buffer, uint32_t *data_words, enum DataType *data_type, uint8_t *num_words)
 {
     if (get_data_type(buffer, data_type) == 0 &&
@@ -48,6 +263,901 @@ int get_data_type(struct ring_buf *buffer, enum DataType *data_type)
 
 int insert_in_buffer(struct ring_buf *buffer, uint32_t *data_words, enum DataType data_type,
                      uint8_t custom_value, uint8_t num_words)
+{
+    return put_dropping_oldest(buffer, data_words, data_type, custom_value, num_words);
+}
+
+IngestionLane *get_producer_lane()
+{
+    // Interrupts don't run on behalf of a single thread
+    if (k_is_in_isr())
+    {
+        return &ingestion_lanes[SHARED_LANE];
+    }
+
+    k_tid_t current_thread = k_current_get();
+    for (int i = 0; i < CONFIG_BUFFER_INGESTION_LANES; i++)
+    {
+        if (atomic_ptr_get(&ingestion_lanes[i].owner) == current_thread)
+        {
+            return &ingestion_lanes[i];
+        }
+    }
+    return &ingestion_lanes[SHARED_LANE];
+}
+
+int register_buffer_producer(k_tid_t thread)
+{
+    for (int i = 0; i < CONFIG_BUFFER_INGESTION_LANES; i++)
+    {
+        if (atomic_ptr_get(&ingestion_lanes[i].owner) == thread)
+        {
+            return 0;
+        }
+    }
+    for (int i = 0; i < CONFIG_BUFFER_INGESTION_LANES; i++)
+    {
+        // If another producer claims the lane first, keeps looking
+        if (atomic_ptr_cas(&ingestion_lanes[i].owner, NULL, thread))
+        {
+            LOG_DBG("Thread %p registered ingestion lane %d", (void *)thread, i);
+            return 0;
+        }
+    }
+    LOG_WRN("No free ingestion lane, thread %p will use the shared lane", (void *)thread);
+    return -ENOMEM;
+}
+
+void unregister_buffer_producer(k_tid_t thread)
+{
+    for (int i = 0; i < CONFIG_BUFFER_INGESTION_LANES; i++)
+    {
+        // Items left in the lane are merged as usual and come before the next owner's
+        if (atomic_ptr_cas(&ingestion_lanes[i].owner, thread, NULL))
+        {
+            LOG_DBG("Thread %p released ingestion lane %d", (void *)thread, i);
+            return;
+        }
+    }
+}
+
+int insert_in_app_buffer(uint32_t *data_words, enum DataType data_type,
+                         uint8_t custom_value, uint8_t num_words)
+{
+    BufferReservation reservation;
+    int error = reserve_lane_item(&reservation, data_type, custom_value, num_words);
+
+    if (error)
+    {
+        return error;
+    }
+    memcpy(reservation.data_words, data_words, SIZE_32_BIT_WORDS_TO_BYTES(num_words));
+    commit_app_buffer_item(&reservation);
+    return 0;
+}
+
+int reserve_app_buffer_item(BufferReservation *reservation, enum DataType data_type,
+                            uint8_t custom_value, uint8_t num_words)
+{
+    int error = reserve_lane_item(reservation, data_type, custom_value, num_words);
+
+    // Lane memory holds older items, which must not leak into padding bytes of the model
+    if (!error)
+    {
+        memset(reservation->data_words, 0, SIZE_32_BIT_WORDS_TO_BYTES(num_words));
+    }
+    return error;
+}
+
+int reserve_lane_item(BufferReservation *reservation, enum DataType data_type,
+                      uint8_t custom_value, uint8_t num_words)
+{
+    IngestionLane *lane;
+    struct ring_element *element;
+    k_spinlock_key_t key = {0};
+
+    if (num_words > MAX_32_WORDS)
+    {
+        LOG_ERR("Item with %d words exceeds maximum item size", num_words);
+        return -EINVAL;
+    }
+    if (data_type >= MAX_DATA_TYPE)
+    {
+        LOG_ERR("Invalid data type %d", data_type);
+        return -EINVAL;
+    }
+
+    lane = get_producer_lane();
+    if (lane == &ingestion_lanes[SHARED_LANE])
+    {
+        key = k_spin_lock(&shared_lane_lock);
+    }
+    element = claim_lane_space(lane, ITEM_HEADER_WORDS + num_words);
+
+    // Only the reading thread consumes from lanes, so new items are dropped
+    // instead of discarding the oldest ones
+    if (element == NULL)
+    {
+        if (lane == &ingestion_lanes[SHARED_LANE])
+        {
+            k_spin_unlock(&shared_lane_lock, key);
+        }
+        atomic_inc(&dropped_items[data_type]);
+        LOG_WRN("Ingestion lane full, dropped %ld items",
+                atomic_inc(&lane->dropped) + 1);
+        k_sem_give(&lanes_watermark);
+        return -ENOMEM;
+    }
+    element->type = data_type;
+    element->length = num_words;
+    element->value = custom_value;
+
+    *reservation = (BufferReservation){
+        .data_words = (uint32_t *)(element + 1),
+        .data_type = data_type,
+        .num_words = num_words,
+        .lane = lane - ingestion_lanes,
+        .key = key,
+    };
+    return 0;
+}
+
+struct ring_element *claim_lane_space(IngestionLane *lane, uint32_t item_words)
+{
+    uint32_t item_size = SIZE_32_BIT_WORDS_TO_BYTES(item_words);
+    struct ring_element *padding;
+    uint8_t *space;
+    uint32_t claimed = ring_buf_put_claim(&lane->ring, &space, item_size);
+
+    if (claimed == item_size)
+    {
+        return (struct ring_element *)space;
+    }
+    // Claimed space is either all the free space or all the space before the end of
+    // the lane, and the space left after it is at the start of the lane
+    if (claimed == 0 || ring_buf_space_get(&lane->ring) < item_size)
+    {
+        ring_buf_put_finish(&lane->ring, 0);
+        return NULL;
+    }
+    padding = (struct ring_element *)space;
+    padding->type = PADDING_TYPE;
+    padding->length = SIZE_BYTES_TO_32_BIT_WORDS(claimed) - ITEM_HEADER_WORDS;
+    padding->value = 0;
+    ring_buf_put_finish(&lane->ring, claimed);
+
+    ring_buf_put_claim(&lane->ring, &space, item_size);
+    return (struct ring_element *)space;
+}
+
+void commit_app_buffer_item(BufferReservation *reservation)
+{
+    IngestionLane *lane = &ingestion_lanes[reservation->lane];
+    uint32_t used_words;
+
+    ring_buf_put_finish(&lane->ring,
+                        SIZE_32_BIT_WORDS_TO_BYTES(ITEM_HEADER_WORDS + reservation->num_words));
+    used_words = SIZE_BYTES_TO_32_BIT_WORDS(ring_buf_size_get(&lane->ring));
+    if (reservation->lane == SHARED_LANE)
+    {
+        k_spin_unlock(&shared_lane_lock, reservation->key);
+    }
+
+    if (used_words >= LANE_WATERMARK_WORDS)
+    {
+        k_sem_give(&lanes_watermark);
+    }
+    LOG_DBG("Wrote item to lane starting with '0x%X' and ending with '0x%X'",
+            reservation->data_words[0], reservation->data_words[reservation->num_words - 1]);
+}
+
+void cancel_app_buffer_item(BufferReservation *reservation)
+{
+    ring_buf_put_finish(&ingestion_lanes[reservation->lane].ring, 0);
+    if (reservation->lane == SHARED_LANE)
+    {
+        k_spin_unlock(&shared_lane_lock, reservation->key);
+    }
+}
+
+int merge_buffer_lanes(k_timeout_t timeout)
+{
+    int error = k_sem_take(&lanes_watermark, timeout);
+    merge_ingestion_lanes();
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+    balance_buffer_tiers();
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+    return error;
+}
+
+void wake_buffer_reader()
+{
+    k_sem_give(&lanes_watermark);
+}
+
+void merge_ingestion_lanes()
+{
+    struct ring_element *element;
+    uint32_t *data_words;
+    ItemHeader header;
+    bool merged_item;
+
+    // Takes one item from each lane at a time, so the merged order
+    // follows the order in which producers inserted them
+    do
+    {
+        merged_item = false;
+        for (int i = 0; i < NUM_LANES; i++)
+        {
+            element = peek_lane_item(&ingestion_lanes[i]);
+            if (element == NULL)
+            {
+                continue;
+            }
+            header = (ItemHeader){
+                .data_type = element->type,
+                .custom_value = element->value,
+                .num_words = element->length,
+            };
+            // Items are moved from the lane to the log without an intermediate copy
+            data_words = (uint32_t *)(element + 1);
+#if defined(CONFIG_BUFFER_COMPRESSION)
+            if (compress_item(header, data_words) == -ENOTSUP)
+            {
+                insert_item(header, data_words);
+            }
+#else
+            insert_item(header, data_words);
+#endif /* CONFIG_BUFFER_COMPRESSION */
+            ring_buf_get_finish(&ingestion_lanes[i].ring,
+                                SIZE_32_BIT_WORDS_TO_BYTES(ITEM_HEADER_WORDS + header.num_words));
+            merged_item = true;
+        }
+    } while (merged_item);
+#if defined(CONFIG_BUFFER_COMPRESSION)
+    seal_stale_blocks();
+#endif /* CONFIG_BUFFER_COMPRESSION */
+}
+
+struct ring_element *peek_lane_item(IngestionLane *lane)
+{
+    struct ring_element *element;
+
+    // Items never wrap around the end of the lane, so a claim of the largest
+    // item size holds at least the whole oldest item
+    while (ring_buf_get_claim(&lane->ring, (uint8_t **)&element,
+                              SIZE_32_BIT_WORDS_TO_BYTES(ITEM_HEADER_WORDS + MAX_32_WORDS)) > 0)
+    {
+        if (element->type != PADDING_TYPE)
+        {
+            return element;
+        }
+        ring_buf_get_finish(&lane->ring,
+                            SIZE_32_BIT_WORDS_TO_BYTES(ITEM_HEADER_WORDS + element->length));
+    }
+    return NULL;
+}
+
+int insert_item(ItemHeader header, uint32_t *data_words)
+{
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+    // Only the reading thread increases the held words, so they can be checked unlocked.
+    // While older items are in flash, new ones follow them there instead of going ahead
+    // of them in the log, so every channel receives items in the order they were inserted
+    if (staged_words > 0 || get_spilled_blocks() > 0 || held_words > SPILL_WATERMARK_WORDS)
+    {
+        stage_spill_item(header, data_words);
+        return 0;
+    }
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+    return append_to_log(header, data_words);
+}
+
+int append_to_log(ItemHeader header, uint32_t *data_words)
+{
+    uint32_t item_words = ITEM_HEADER_WORDS + header.num_words;
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    int error = 0;
+
+    while (APP_LOG_WORDS - held_words < get_padding_words(item_words) + item_words)
+    {
+        error = evict_oldest_item(get_retention_class(header.data_type));
+        if (error)
+        {
+            break;
+        }
+    }
+    if (!error)
+    {
+        write_item(header, data_words);
+        release_held_items();
+    }
+    k_spin_unlock(&log_lock, key);
+
+    if (error)
+    {
+        LOG_WRN("No space in buffer for data type %d, dropped %ld items",
+                ITEM_DATA_TYPE(header.data_type), count_dropped_items(header));
+        return error;
+    }
+    LOG_DBG("Wrote item to buffer starting with '0x%X' and ending with '0x%X'",
+            data_words[0], data_words[header.num_words - 1]);
+    return 0;
+}
+
+#if defined(CONFIG_BUFFER_COMPRESSION)
+int compress_item(ItemHeader header, uint32_t *data_words)
+{
+    CompressedBlock *block = &open_blocks[header.data_type];
+
+    // Only sensor records, which have a fixed size, are compressed. Records with
+    // a custom value are kept as they are, as blocks don't store it
+    if (header.data_type < SENSOR_TYPE_OFFSET || header.custom_value != 0 ||
+        header.num_words != get_data_api(header.data_type)->num_data_words)
+    {
+        return -ENOTSUP;
+    }
+
+    if (block->num_records > 0 && add_compressed_record(block, data_words) == 0)
+    {
+        if (block->num_records == CONFIG_BUFFER_COMPRESSION_BLOCK_RECORDS)
+        {
+            seal_compressed_block(header.data_type);
+        }
+        return 0;
+    }
+    // Block is empty or full, so the record starts a new one
+    seal_compressed_block(header.data_type);
+    start_compressed_block(block, header.num_words);
+    open_block_times[header.data_type] = k_uptime_get();
+    return add_compressed_record(block, data_words);
+}
+
+void seal_compressed_block(uint8_t data_type)
+{
+    CompressedBlock *block = &open_blocks[data_type];
+    ItemHeader header = {
+        .data_type = data_type | COMPRESSED_TYPE_FLAG,
+        .custom_value = block->num_records,
+        .num_words = get_compressed_block_words(block),
+    };
+
+    if (block->num_records == 0)
+    {
+        return;
+    }
+    LOG_DBG("Compressed %d records of data type %d in %d words", block->num_records,
+            data_type, header.num_words);
+    insert_item(header, block->words);
+    block->num_records = 0;
+}
+
+void seal_stale_blocks()
+{
+    int64_t now = k_uptime_get();
+
+    for (int i = SENSOR_TYPE_OFFSET; i < MAX_DATA_TYPE; i++)
+    {
+        if (open_blocks[i].num_records > 0 &&
+            now - open_block_times[i] >= CONFIG_BUFFER_COMPRESSION_MAX_DELAY)
+        {
+            seal_compressed_block(i);
+        }
+    }
+}
+
+int expand_compressed_items(int cursor_id, BufferItem *items, int num_items, int num_records)
+{
+    uint32_t decoded_position = DECODED_WORDS;
+    int record_index = num_records;
+
+    // Items are expanded from the last one, so none is overwritten before being expanded
+    for (int i = num_items - 1; i >= 0; i--)
+    {
+        BufferItem item = items[i];
+        uint8_t data_type = ITEM_DATA_TYPE(item.data_type);
+        uint8_t record_words;
+
+        if (!(item.data_type & COMPRESSED_TYPE_FLAG))
+        {
+            items[--record_index] = item;
+            continue;
+        }
+
+        record_words = get_data_api(data_type)->num_data_words;
+        decoded_position -= item.custom_value * record_words;
+        if (decompress_block(item.data_words, item.num_words, item.custom_value, record_words,
+                             &decoded_records[cursor_id][decoded_position]) < 0)
+        {
+            ItemHeader header = {.data_type = item.data_type, .custom_value = item.custom_value};
+            LOG_ERR("Failed to decompress block of data type %d, %ld items dropped", data_type,
+                    count_dropped_items(header));
+            continue;
+        }
+        for (int record = item.custom_value - 1; record >= 0; record--)
+        {
+            items[--record_index] = (BufferItem){
+                .data_words = &decoded_records[cursor_id][decoded_position + record * record_words],
+                .data_type = data_type,
+                .num_words = record_words,
+            };
+        }
+    }
+
+    // Records of dropped blocks left unused slots before the first record
+    if (record_index > 0)
+    {
+        memmove(items, &items[record_index], (num_records - record_index) * sizeof(*items));
+    }
+    return num_records - record_index;
+}
+#endif /* CONFIG_BUFFER_COMPRESSION */
+
+atomic_val_t count_dropped_items(ItemHeader header)
+{
+    uint8_t num_records = header.data_type & COMPRESSED_TYPE_FLAG ? header.custom_value : 1;
+    return atomic_add(&dropped_items[ITEM_DATA_TYPE(header.data_type)], num_records) + num_records;
+}
+
+#if defined(CONFIG_BUFFER_FLASH_SPILL)
+void balance_buffer_tiers()
+{
+    static uint32_t block_words[SPILL_BLOCK_WORDS];
+    ItemHeader header;
+    int num_words;
+
+    // Log only holds items older than those in flash, so the ones read back go after them
+    while (held_words + SPILL_BLOCK_WORDS <= SPILL_WATERMARK_WORDS)
+    {
+        num_words = read_spilled_block(block_words);
+        if (num_words == -ENODATA)
+        {
+            // Staged items are the newest, so they follow the last block read back
+            flush_staged_items(false);
+            break;
+        }
+        for (int position = 0; position < num_words;
+             position += ITEM_HEADER_WORDS + header.num_words)
+        {
+            memcpy(&header, &block_words[position], sizeof(header));
+            // Block corrupted in flash
+            if (ITEM_DATA_TYPE(header.data_type) >= MAX_DATA_TYPE ||
+                header.num_words > MAX_ITEM_WORDS ||
+                position + ITEM_HEADER_WORDS + header.num_words > num_words)
+            {
+                LOG_ERR("Invalid item read from flash");
+                break;
+            }
+            if (!is_spilled_item_supported(header))
+            {
+                LOG_WRN("Dropped item of unsupported data type %d read from flash, %ld dropped",
+                        ITEM_DATA_TYPE(header.data_type), count_dropped_items(header));
+                continue;
+            }
+            append_to_log(header, &block_words[position + ITEM_HEADER_WORDS]);
+        }
+    }
+}
+
+void stage_spill_item(ItemHeader header, uint32_t *data_words)
+{
+    uint32_t item_words = ITEM_HEADER_WORDS + header.num_words;
+
+    if (staged_words + item_words > SPILL_BLOCK_WORDS)
+    {
+        spill_staged_block();
+    }
+    memcpy(&staged_block[staged_words], &header, sizeof(header));
+    memcpy(&staged_block[staged_words + ITEM_HEADER_WORDS], data_words,
+           SIZE_32_BIT_WORDS_TO_BYTES(header.num_words));
+    staged_words += item_words;
+}
+
+void spill_staged_block()
+{
+    // Flash is written by the reading thread without holding the log lock,
+    // as page writes and erases are slow
+    if (spill_block(staged_block, staged_words) == 0)
+    {
+        staged_words = 0;
+        return;
+    }
+    if (get_spilled_blocks() > 0)
+    {
+        LOG_WRN("Failed to move items to flash, dropped block of %d words", staged_words);
+        flush_staged_items(true);
+        return;
+    }
+    LOG_WRN("Failed to move items to flash, kept block of %d words in buffer", staged_words);
+    flush_staged_items(false);
+}
+
+void flush_staged_items(bool drop_items)
+{
+    ItemHeader header;
+
+    for (int position = 0; position < staged_words;
+         position += ITEM_HEADER_WORDS + header.num_words)
+    {
+        memcpy(&header, &staged_block[position], sizeof(header));
+        if (drop_items)
+        {
+            count_dropped_items(header);
+        }
+        else
+        {
+            append_to_log(header, &staged_block[position + ITEM_HEADER_WORDS]);
+        }
+    }
+    staged_words = 0;
+}
+
+bool is_spilled_item_supported(ItemHeader header)
+{
+#if !defined(CONFIG_BUFFER_COMPRESSION)
+    if (header.data_type & COMPRESSED_TYPE_FLAG)
+    {
+        return false;
+    }
+#endif /* CONFIG_BUFFER_COMPRESSION */
+    return get_data_api(ITEM_DATA_TYPE(header.data_type)) != NULL;
+}
+#endif /* CONFIG_BUFFER_FLASH_SPILL */
+
+int evict_oldest_item(enum RetentionClass new_item_class)
+{
+#if defined(CONFIG_BUFFER_SKIP_LAGGING_CHANNEL)
+    ItemHeader header;
+    enum RetentionClass oldest_class;
+    bool lower_class_held = false;
+
+    // Items being processed by the slowest cursors can't be discarded
+    if (slowest_cursors_busy())
+    {
+        return -EBUSY;
+    }
+
+    memcpy(&header, &app_log[tail_position], sizeof(header));
+    if (header.data_type == PADDING_TYPE)
+    {
+        skip_slowest_cursors(header, false);
+        release_held_items();
+        return 0;
+    }
+
+    oldest_class = get_retention_class(header.data_type);
+    for (int i = 0; i < oldest_class; i++)
+    {
+        lower_class_held |= held_items[i] > 0;
+    }
+    // Keeps the oldest item while there is less important data to evict
+    if (lower_class_held)
+    {
+        relocate_oldest_item(header);
+        return 0;
+    }
+    // New item is less important than everything held
+    if (new_item_class < oldest_class)
+    {
+        return -ENOMEM;
+    }
+
+    skip_slowest_cursors(header, true);
+    release_held_items();
+    LOG_WRN("Buffer full, evicted item of data type %d, %ld items dropped",
+            ITEM_DATA_TYPE(header.data_type), count_dropped_items(header));
+    return 0;
+#else
+    ARG_UNUSED(new_item_class);
+    // Keeps items until every cursor reads them
+    return -ENOMEM;
+#endif /* CONFIG_BUFFER_SKIP_LAGGING_CHANNEL */
+}
+
+void relocate_oldest_item(ItemHeader header)
+{
+    uint32_t data_words[MAX_ITEM_WORDS];
+    uint32_t item_words = ITEM_HEADER_WORDS + header.num_words;
+
+    // Item was already read by every cursor
+    if (!take_oldest_item(&header, data_words))
+    {
+        return;
+    }
+    // Writing at the end of the log may need padding, for which there might not be space
+    if (APP_LOG_WORDS - held_words < get_padding_words(item_words) + item_words)
+    {
+        LOG_WRN("Buffer full, evicted item of data type %d, %ld items dropped",
+                ITEM_DATA_TYPE(header.data_type), count_dropped_items(header));
+        return;
+    }
+    LOG_DBG("Buffer full, kept item of data type %d", header.data_type);
+    write_item(header, data_words);
+    release_held_items();
+}
+
+bool take_oldest_item(ItemHeader *header, uint32_t *data_words)
+{
+    uint8_t registered_cursors = 0;
+
+    // Items are contiguous, so the data follows the header without wrapping
+    memcpy(data_words, &app_log[tail_position + ITEM_HEADER_WORDS],
+           SIZE_32_BIT_WORDS_TO_BYTES(header->num_words));
+    // Cursors ahead of the slowest ones already read the item, so they skip its copy
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        if (buffer_cursors[i].registered)
+        {
+            registered_cursors |= BIT(i);
+            if (buffer_cursors[i].unread_words < held_words)
+            {
+                header->read_cursors |= BIT(i);
+            }
+        }
+    }
+    skip_slowest_cursors(*header, false);
+    release_held_items();
+
+    return (header->read_cursors & registered_cursors) != registered_cursors;
+}
+
+bool slowest_cursors_busy()
+{
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        if (buffer_cursors[i].registered &&
+            buffer_cursors[i].unread_words == held_words &&
+            buffer_cursors[i].peeked_words > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void skip_slowest_cursors(ItemHeader header, bool count_skipped)
+{
+    uint32_t item_words = ITEM_HEADER_WORDS + header.num_words;
+
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        BufferCursor *cursor = &buffer_cursors[i];
+        if (!cursor->registered || cursor->unread_words != held_words)
+        {
+            continue;
+        }
+        if (count_skipped && !(header.read_cursors & BIT(i)))
+        {
+            cursor->skipped_items++;
+        }
+        cursor->read_position = (cursor->read_position + item_words) % APP_LOG_WORDS;
+        cursor->unread_words -= item_words;
+    }
+}
+
+void write_item(ItemHeader header, uint32_t *data_words)
+{
+    uint32_t item_words = ITEM_HEADER_WORDS + header.num_words;
+    uint32_t padding_words = get_padding_words(item_words);
+
+    // Item doesn't fit before the end of the log, so it's written at its start
+    if (padding_words > 0)
+    {
+        ItemHeader padding = {
+            .data_type = PADDING_TYPE,
+            .num_words = padding_words - ITEM_HEADER_WORDS,
+        };
+        memcpy(&app_log[write_position], &padding, sizeof(padding));
+        write_position = 0;
+    }
+    memcpy(&app_log[write_position], &header, sizeof(header));
+    memcpy(&app_log[write_position + ITEM_HEADER_WORDS], data_words,
+           SIZE_32_BIT_WORDS_TO_BYTES(header.num_words));
+    write_position = (write_position + item_words) % APP_LOG_WORDS;
+
+    // Publishes the item to every cursor
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        if (buffer_cursors[i].registered)
+        {
+            buffer_cursors[i].unread_words += padding_words + item_words;
+        }
+    }
+    held_words += padding_words + item_words;
+    held_items[get_retention_class(header.data_type)]++;
+}
+
+uint32_t get_padding_words(uint32_t item_words)
+{
+    return write_position + item_words > APP_LOG_WORDS ? APP_LOG_WORDS - write_position : 0;
+}
+
+void release_held_items()
+{
+    uint32_t max_unread_words = 0;
+
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        if (buffer_cursors[i].registered)
+        {
+            max_unread_words = MAX(max_unread_words, buffer_cursors[i].unread_words);
+        }
+    }
+    // Cursors move by whole items, so the tail always lands on an item header
+    while (held_words > max_unread_words)
+    {
+        ItemHeader *header = (ItemHeader *)&app_log[tail_position];
+        uint32_t item_words = ITEM_HEADER_WORDS + header->num_words;
+
+        if (header->data_type != PADDING_TYPE)
+        {
+            held_items[get_retention_class(header->data_type)]--;
+        }
+        tail_position = (tail_position + item_words) % APP_LOG_WORDS;
+        held_words -= item_words;
+    }
+}
+
+enum RetentionClass get_retention_class(uint16_t data_type)
+{
+    return get_data_api(ITEM_DATA_TYPE(data_type))->retention_class;
+}
+
+int register_buffer_cursor()
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    int cursor_id = -ENOMEM;
+
+    for (int i = 0; i < MAX_BUFFER_CURSORS; i++)
+    {
+        if (!buffer_cursors[i].registered)
+        {
+            // Cursor only sees items written after its registration
+            buffer_cursors[i] = (BufferCursor){
+                .registered = true,
+                .read_position = write_position,
+            };
+            cursor_id = i;
+            break;
+        }
+    }
+    k_spin_unlock(&log_lock, key);
+    return cursor_id;
+}
+
+void unregister_buffer_cursor(int cursor_id)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+
+    buffer_cursors[cursor_id].registered = false;
+    release_held_items();
+    k_spin_unlock(&log_lock, key);
+}
+
+int peek_buffer_items(int cursor_id, BufferItem *items, int max_items)
+{
+    int num_items, num_records;
+
+    // When every peeked block was dropped, the cursor moves past them to the next items
+    do
+    {
+        num_records = peek_log_items(cursor_id, items, max_items, &num_items);
+#if defined(CONFIG_BUFFER_COMPRESSION)
+        // Peeked items can't be reclaimed, so blocks are decoded outside the lock
+        num_records = expand_compressed_items(cursor_id, items, num_items, num_records);
+        if (num_records == 0 && num_items > 0)
+        {
+            release_buffer_items(cursor_id);
+        }
+#endif /* CONFIG_BUFFER_COMPRESSION */
+    } while (num_records == 0 && num_items > 0);
+    return num_records;
+}
+
+int peek_log_items(int cursor_id, BufferItem *items, int max_items, int *num_items_peeked)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    BufferCursor *cursor = &buffer_cursors[cursor_id];
+    uint32_t position = cursor->read_position, peeked_words = 0, decoded_words = 0;
+    int num_items = 0, num_records = 0;
+
+    while (num_records < max_items && peeked_words < cursor->unread_words)
+    {
+        ItemHeader *header = (ItemHeader *)&app_log[position];
+        uint32_t *data_words = &app_log[position + ITEM_HEADER_WORDS];
+        uint32_t item_words = ITEM_HEADER_WORDS + header->num_words;
+        // Padding and copies of items the cursor already read are skipped
+        bool skip_item = header->data_type == PADDING_TYPE ||
+                         (header->read_cursors & BIT(cursor_id));
+        uint8_t item_records = 1;
+        uint32_t item_decoded_words = 0;
+
+#if defined(CONFIG_BUFFER_COMPRESSION)
+        if (!skip_item && (header->data_type & COMPRESSED_TYPE_FLAG))
+        {
+            item_records = header->custom_value;
+            item_decoded_words =
+                item_records * get_data_api(ITEM_DATA_TYPE(header->data_type))->num_data_words;
+            // Block is left to the next peek if its records don't fit
+            if (num_records + item_records > max_items ||
+                decoded_words + item_decoded_words > DECODED_WORDS)
+            {
+                break;
+            }
+        }
+#endif /* CONFIG_BUFFER_COMPRESSION */
+
+        position = (position + item_words) % APP_LOG_WORDS;
+        if (skip_item && num_items == 0)
+        {
+            // Skipped words before any peeked item are released right away,
+            // so a peek with no items never holds words
+            cursor->read_position = position;
+            cursor->unread_words -= item_words;
+            continue;
+        }
+        if (!skip_item)
+        {
+            items[num_items] = (BufferItem){
+                .data_words = data_words,
+                .data_type = header->data_type,
+                .num_words = header->num_words,
+                .custom_value = header->custom_value,
+            };
+            num_items++;
+            num_records += item_records;
+            decoded_words += item_decoded_words;
+        }
+        peeked_words += item_words;
+    }
+    cursor->peeked_words = peeked_words;
+    release_held_items();
+    k_spin_unlock(&log_lock, key);
+
+    *num_items_peeked = num_items;
+    return num_records;
+}
+
+void release_buffer_items(int cursor_id)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    BufferCursor *cursor = &buffer_cursors[cursor_id];
+
+    cursor->read_position = (cursor->read_position + cursor->peeked_words) % APP_LOG_WORDS;
+    cursor->unread_words -= cursor->peeked_words;
+    cursor->peeked_words = 0;
+    release_held_items();
+    k_spin_unlock(&log_lock, key);
+}
+
+bool buffer_cursor_is_empty(int cursor_id)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    bool is_empty = buffer_cursors[cursor_id].unread_words == 0;
+    k_spin_unlock(&log_lock, key);
+    return is_empty;
+}
+
+uint32_t get_cursor_unread_words(int cursor_id)
+{
+    k_spinlock_key_t key = k_spin_lock(&log_lock);
+    uint32_t unread_words = buffer_cursors[cursor_id].unread_words;
+    k_spin_unlock(&log_lock, key);
+    return unread_words;
+}
+
+uint32_t get_cursor_skipped_items(int cursor_id)
+{
+    return buffer_cursors[cursor_id].skipped_items;
+}
+
+uint32_t get_dropped_items(enum DataType data_type)
+{
+    return atomic_get(&dropped_items[data_type]);
+}
+
+int put_dropping_oldest(struct ring_buf *buffer, uint32_t *data_words, enum DataType data_type,
+                        uint8_t custom_value, uint8_t num_words)
 {
     // Removes oldest items from buffer until new item fits
     while (ring_buf_item_put(buffer, data_type, custom_value,
@@ -104,4 +1214,4 @@ int parse_buffer_data(struct ring_buf *buffer, uint32_t *data_words, enum DataTy
             "starting with '0x%X' and ending with '0x%X'",
             data_type, data_words[0], data_words[*data_size - 1]);
     return 0;
-}
\ No newline at end of file
+}
@@ -6,13 +6,35 @@
 #include <integration/data_abstraction/abstraction_service.h>
 
 #define SIZE_BYTES_TO_32_BIT_WORDS(expr) DIV_ROUND_UP(expr, sizeof(uint32_t))
-#define SIZE_32_BIT_WORDS_TO_BYTES(expr) (expr * 4)
+#define SIZE_32_BIT_WORDS_TO_BYTES(expr) ((expr) * 4)
 
 // Maximum number of 32-bit words an item of the application buffer can have
 #define MAX_32_WORDS 16
 
-// Declares ring buffer that will store data until it is read and sent
-extern struct ring_buf app_buffer;
+// Maximum number of consumers reading the application buffer at their own pace
+#define MAX_BUFFER_CURSORS 4
+
+// Item read from the application buffer, pointing to its content in the
+// buffer memory, which is valid until the item is released
+typedef struct
+{
+    uint32_t *data_words;
+    enum DataType data_type;
+    uint8_t num_words;
+    uint8_t custom_value;
+} BufferItem;
+
+// Space reserved for an item in the producer's lane, where the producer writes
+// the item in place instead of copying it there
+typedef struct
+{
+    uint32_t *data_words;
+    enum DataType data_type;
+    uint8_t num_words;
+    // Lane holding the space, whose lock is held until commit if it's the shared one
+    uint8_t lane;
+    k_spinlock_key_t key;
+} BufferReservation;
 
 // Gets item from buffer
 int get_from_buffer(struct ring_buf *buffer, uint32_t *data_words, enum DataType *data_type, uint8_t *num_words);
@@ -24,4 +46,69 @@ int insert_in_buffer(struct ring_buf *buffer, uint32_t *data_words, enum DataTyp
 // Verifies if buffer is empty
 int buffer_is_empty(struct ring_buf *buffer);
 
-#endif /* BUFFER_SERVICE_H */
\ No newline at end of file
+// Gives `thread` its own lane in front of the application buffer, so its inserts
+// don't contend with other producers. Meant for long-lived producers, since the
+// lane is kept until unregistered, while other threads insert in the shared lane.
+// Returns -ENOMEM if every lane is taken
+int register_buffer_producer(k_tid_t thread);
+
+// Frees the lane of `thread`, which must not insert anymore, as before it exits.
+// Otherwise a thread later created with the same ID would inherit the lane
+void unregister_buffer_producer(k_tid_t thread);
+
+// Inserts data in the application buffer, through the producer's
+// own lane, so registered producers don't block each other
+int insert_in_app_buffer(uint32_t *data_words, enum DataType data_type,
+                         uint8_t custom_value, uint8_t num_words);
+
+// Reserves `num_words` zeroed words in the producer's lane, where the producer writes
+// the item before committing it. Returns -ENOMEM if the lane is full, or -EINVAL for
+// an unknown data type or an item larger than MAX_32_WORDS. Interrupts and
+// unregistered producers hold the shared lane's lock until they commit
+// or cancel, so the item must be written without blocking
+int reserve_app_buffer_item(BufferReservation *reservation, enum DataType data_type,
+                            uint8_t custom_value, uint8_t num_words);
+
+// Publishes the reserved item to the reading thread
+void commit_app_buffer_item(BufferReservation *reservation);
+
+// Gives back the space of a reserved item that won't be inserted
+void cancel_app_buffer_item(BufferReservation *reservation);
+
+// Waits until a producer lane passes its watermark or `timeout` expires and merges
+// the lanes into the application buffer. Returns 0 if woken by a lane or by
+// wake_buffer_reader, -EAGAIN on timeout. Must only be called by the application
+// buffer reading thread
+int merge_buffer_lanes(k_timeout_t timeout);
+// Wakes the reading thread up from merge_buffer_lanes, so it rechecks when to wake up next
+void wake_buffer_reader();
+
+// Registers a consumer of the application buffer, which will read items
+// inserted from now on. Returns the cursor ID or -ENOMEM
+int register_buffer_cursor();
+
+// Unregisters a cursor, releasing the items only it hadn't read
+void unregister_buffer_cursor(int cursor_id);
+
+// Gets up to `max_items` unread items of the cursor without copying them
+// and returns how many were got. Items stay valid until released. With
+// compression enabled, `max_items` must fit the records of a whole block,
+// and blocks that fail to decompress are dropped instead of returned
+int peek_buffer_items(int cursor_id, BufferItem *items, int max_items);
+
+// Releases the items of the last peek, so their space can be reclaimed
+void release_buffer_items(int cursor_id);
+
+// Verifies if cursor has read every item in the application buffer
+bool buffer_cursor_is_empty(int cursor_id);
+// Returns the 32-bit words, headers included, the cursor hasn't read yet
+uint32_t get_cursor_unread_words(int cursor_id);
+
+// Returns how many items the cursor skipped because it lagged behind
+uint32_t get_cursor_skipped_items(int cursor_id);
+
+// Returns how many items of given data type were dropped because
+// the application buffer or the producer's lane was full
+uint32_t get_dropped_items(enum DataType data_type);
+
+#endif /* BUFFER_SERVICE_H */
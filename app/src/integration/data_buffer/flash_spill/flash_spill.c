@@ -0,0 +1,226 @@
+#include <zephyr/logging/log.h>
+#include <zephyr/init.h>
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#include <integration/data_buffer/buffer_service.h>
+#include <integration/data_buffer/flash_spill/flash_spill.h>
+
+LOG_MODULE_REGISTER(flash_spill, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+#define SPILL_PARTITION storage_partition
+#define SPILL_PARTITION_ID FIXED_PARTITION_ID(SPILL_PARTITION)
+// Flash pages are the erase unit and the sectors of the circular log
+#define SPILL_PAGE_SIZE DT_PROP(DT_CHOSEN(zephyr_flash), erase_block_size)
+#define SPILL_MAX_SECTORS (FIXED_PARTITION_SIZE(SPILL_PARTITION) / SPILL_PAGE_SIZE)
+// Identifies the flash log, so data written by other applications isn't read
+#define SPILL_FCB_MAGIC 0x50554C47
+#define SPILL_FCB_VERSION 1
+// Bytes FCB adds to each page and block
+#define SPILL_PAGE_OVERHEAD 16
+#define SPILL_BLOCK_OVERHEAD 8
+
+BUILD_ASSERT(SPILL_MAX_SECTORS >= 2, "Flash log needs at least two pages");
+BUILD_ASSERT(SIZE_32_BIT_WORDS_TO_BYTES(SPILL_BLOCK_WORDS) + SPILL_BLOCK_OVERHEAD <=
+                 SPILL_PAGE_SIZE - SPILL_PAGE_OVERHEAD,
+             "BUFFER_SPILL_BLOCK_WORDS must fit in a flash page");
+
+static struct flash_sector spill_sectors[SPILL_MAX_SECTORS];
+static struct fcb spill_fcb;
+// Last block read back, or no sector to start from the oldest one
+static struct fcb_entry read_entry;
+static FlashSpillStats spill_stats;
+static bool spill_ready;
+
+// Initializes the flash circular log, finding blocks left from previous boots
+static int init_flash_spill(void);
+SYS_INIT(init_flash_spill, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+// Counts blocks after the last one read
+static uint32_t count_unread_blocks();
+// Erases the oldest page, counting the unread blocks lost with it
+static int erase_oldest_sector();
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+int init_flash_spill(void)
+{
+    uint32_t sector_count = SPILL_MAX_SECTORS;
+    int error = flash_area_get_sectors(SPILL_PARTITION_ID, &sector_count, spill_sectors);
+    if (error)
+    {
+        LOG_ERR("Failed to get storage partition pages: %d", error);
+        return error;
+    }
+
+    spill_fcb.f_magic = SPILL_FCB_MAGIC;
+    spill_fcb.f_version = SPILL_FCB_VERSION;
+    spill_fcb.f_sectors = spill_sectors;
+    spill_fcb.f_sector_cnt = sector_count;
+    spill_fcb.f_scratch_cnt = 0;
+    error = fcb_init(SPILL_PARTITION_ID, &spill_fcb);
+    if (error)
+    {
+        LOG_ERR("Failed to initialize flash log: %d", error);
+        return error;
+    }
+
+    spill_stats.sector_count = sector_count;
+    spill_stats.pending_blocks = count_unread_blocks();
+    spill_ready = true;
+    LOG_INF("Flash log has %d blocks from previous boots", spill_stats.pending_blocks);
+    return 0;
+}
+
+int spill_block(uint32_t *block_words, uint16_t num_words)
+{
+    struct fcb_entry entry;
+    uint16_t block_size = SIZE_32_BIT_WORDS_TO_BYTES(num_words);
+    int error;
+
+    if (!spill_ready)
+    {
+        return -ENODEV;
+    }
+
+    error = fcb_append(&spill_fcb, block_size, &entry);
+    // Flash is full, so the oldest page gives room for new data
+    if (error == -ENOSPC)
+    {
+        error = erase_oldest_sector();
+        if (!error)
+        {
+            error = fcb_append(&spill_fcb, block_size, &entry);
+        }
+    }
+    if (error)
+    {
+        LOG_ERR("Failed to allocate block in flash: %d", error);
+        return error;
+    }
+
+    error = flash_area_write(spill_fcb.fap, FCB_ENTRY_FA_DATA_OFF(entry), block_words, block_size);
+    if (error)
+    {
+        LOG_ERR("Failed to write block to flash: %d", error);
+        return error;
+    }
+    error = fcb_append_finish(&spill_fcb, &entry);
+    if (error)
+    {
+        LOG_ERR("Failed to seal block in flash: %d", error);
+        return error;
+    }
+
+    spill_stats.pending_blocks++;
+    spill_stats.written_blocks++;
+    LOG_DBG("Moved block of %d words to flash", num_words);
+    return 0;
+}
+
+int read_spilled_block(uint32_t *block_words)
+{
+    struct fcb_entry entry = read_entry;
+    int error;
+
+    if (!spill_ready || spill_stats.pending_blocks == 0)
+    {
+        return -ENODATA;
+    }
+
+    error = fcb_getnext(&spill_fcb, &entry);
+    if (error)
+    {
+        return -ENODATA;
+    }
+    if (entry.fe_data_len > SIZE_32_BIT_WORDS_TO_BYTES(SPILL_BLOCK_WORDS))
+    {
+        LOG_ERR("Invalid block size in flash: %d", entry.fe_data_len);
+        error = -EINVAL;
+    }
+    else
+    {
+        error = flash_area_read(spill_fcb.fap, FCB_ENTRY_FA_DATA_OFF(entry),
+                                block_words, entry.fe_data_len);
+    }
+    // Unreadable blocks are skipped, so they don't stop the ones after them
+    read_entry = entry;
+    spill_stats.pending_blocks--;
+    if (error)
+    {
+        LOG_ERR("Failed to read block from flash: %d", error);
+        return error;
+    }
+    spill_stats.read_blocks++;
+
+    // Pages are only erased when they were fully read and the log moved past them,
+    // so a page that is still being written is not erased at every read
+    while (spill_fcb.f_oldest != read_entry.fe_sector)
+    {
+        error = fcb_rotate(&spill_fcb);
+        if (error)
+        {
+            LOG_ERR("Failed to erase flash page: %d", error);
+            break;
+        }
+        spill_stats.erased_sectors++;
+    }
+
+    return SIZE_BYTES_TO_32_BIT_WORDS(entry.fe_data_len);
+}
+
+uint32_t get_spilled_blocks()
+{
+    return spill_stats.pending_blocks;
+}
+
+void get_flash_spill_stats(FlashSpillStats *stats)
+{
+    *stats = spill_stats;
+    if (spill_ready)
+    {
+        stats->free_sectors = fcb_free_sector_cnt(&spill_fcb);
+        stats->active_sector_id = spill_fcb.f_active_id;
+    }
+}
+
+uint32_t count_unread_blocks()
+{
+    struct fcb_entry entry = read_entry;
+    uint32_t unread_blocks = 0;
+
+    while (fcb_getnext(&spill_fcb, &entry) == 0)
+    {
+        unread_blocks++;
+    }
+    return unread_blocks;
+}
+
+int erase_oldest_sector()
+{
+    uint32_t unread_blocks;
+    int error;
+
+    // Reading restarts at the new oldest page if the erased one had unread blocks
+    if (read_entry.fe_sector == spill_fcb.f_oldest)
+    {
+        read_entry.fe_sector = NULL;
+    }
+    error = fcb_rotate(&spill_fcb);
+    if (error)
+    {
+        LOG_ERR("Failed to erase flash page: %d", error);
+        return error;
+    }
+    spill_stats.erased_sectors++;
+
+    unread_blocks = count_unread_blocks();
+    spill_stats.lost_blocks += spill_stats.pending_blocks - unread_blocks;
+    LOG_WRN("Flash full, lost %d blocks", spill_stats.pending_blocks - unread_blocks);
+    spill_stats.pending_blocks = unread_blocks;
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef FLASH_SPILL_H
+#define FLASH_SPILL_H
+
+#include <zephyr/kernel.h>
+
+// Size in 32-bit words of the blocks of buffer items moved to flash
+#define SPILL_BLOCK_WORDS CONFIG_BUFFER_SPILL_BLOCK_WORDS
+
+// Usage and wear of the flash circular log
+typedef struct
+{
+    // Number of flash pages of the storage partition used by the log
+    uint8_t sector_count;
+    // Pages that can still be written before the oldest one is erased
+    uint8_t free_sectors;
+    // Identifier of the page being written, incremented on every page erase and
+    // kept in flash, so it counts erases over the device lifetime
+    uint16_t active_sector_id;
+    // Blocks in flash not read back yet
+    uint32_t pending_blocks;
+    // Blocks written and read back since boot
+    uint32_t written_blocks;
+    uint32_t read_blocks;
+    // Pages erased since boot
+    uint32_t erased_sectors;
+    // Blocks erased before being read back because flash was full
+    uint32_t lost_blocks;
+} FlashSpillStats;
+
+// Writes a sealed block of buffer items at the end of the flash log
+int spill_block(uint32_t *block_words, uint16_t num_words);
+// Reads the oldest block not read back yet, in the order they were written.
+// Returns the number of words read or -ENODATA if there is none
+int read_spilled_block(uint32_t *block_words);
+// Returns how many blocks in flash were not read back yet
+uint32_t get_spilled_blocks();
+// Gets usage and wear statistics of the flash log
+void get_flash_spill_stats(FlashSpillStats *stats);
+
+#endif /* FLASH_SPILL_H */
@@ -1,5 +1,7 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/bme280/bme280_service.h>
+#include <integration/data_abstraction/text_format/text_format.h>
 
 LOG_MODULE_REGISTER(bme280_model, CONFIG_APP_LOG_LEVEL);
 
@@ -18,53 +20,92 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Timestamp: %d; Temperature: %d.%02d°C; Pressure: %d.%02d kPa; "
-                    "Humidity: %d.%02d %%RH;",
-                    bme280_model->timestamp,
-                    bme280_model->temperature.val1,
-                    bme280_model->temperature.val2 / 10000,
-                    bme280_model->pressure.val1,
-                    bme280_model->pressure.val2 / 10000,
-                    bme280_model->humidity.val1,
-                    bme280_model->humidity.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, bme280_model->timestamp);
+    text_append(&text, "; Temperature: ");
+    text_append_fixed(&text, bme280_model->temperature, BME280_TEMPERATURE_SCALE, 2);
+    text_append(&text, "°C; Pressure: ");
+    text_append_fixed(&text, bme280_model->pressure, BME280_PRESSURE_SCALE, 2);
+    text_append(&text, " kPa; Humidity: ");
+    text_append_fixed(&text, bme280_model->humidity, BME280_HUMIDITY_SCALE, 2);
+    text_append(&text, " %RH;");
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a minimal string
 static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
     // Converts words into the model
-    SensorModelBME280 * bme280_model = (SensorModelBME280 *)data_words;
+    SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dT%d.%02dP%d.%02dH%d.%02d",
-                    bme280_model->timestamp,
-                    bme280_model->temperature.val1,
-                    bme280_model->temperature.val2 / 10000,
-                    bme280_model->pressure.val1,
-                    bme280_model->pressure.val2 / 10000,
-                    bme280_model->humidity.val1,
-                    bme280_model->humidity.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, bme280_model->timestamp);
+    text_append_char(&text, 'T');
+    text_append_fixed(&text, bme280_model->temperature, BME280_TEMPERATURE_SCALE, 2);
+    text_append_char(&text, 'P');
+    text_append_fixed(&text, bme280_model->pressure, BME280_PRESSURE_SCALE, 2);
+    text_append_char(&text, 'H');
+    text_append_fixed(&text, bme280_model->humidity, BME280_HUMIDITY_SCALE, 2);
+    return text_finish(&text);
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-    // Converts words into bytes
-    bytecpy(encoded_data, data_words, encoded_size);
+    // Copies the packed fixed-point model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SensorModelBME280)));
 
     return sizeof(SensorModelBME280);
 }
 
+// Encodes data model into a binary frame with pressure in 3 bytes,
+// temperature and humidity in 2 bytes each
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+    int header_size = encode_packed_header(BME280_MODEL, bme280_model->timestamp, 7,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    // Pressure in Pa is always below 2^24
+    sys_put_le24(bme280_model->pressure, &encoded_data[header_size]);
+    sys_put_le16(bme280_model->temperature, &encoded_data[header_size + 3]);
+    sys_put_le16(bme280_model->humidity, &encoded_data[header_size + 5]);
+
+    return header_size + 7;
+}
+
+// Gets the measurements of the data model in the order of its binary frame
+static int get_fields(uint32_t *data_words, int32_t *fields)
+{
+    SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+
+    fields[0] = bme280_model->pressure;
+    fields[1] = bme280_model->temperature;
+    fields[2] = bme280_model->humidity;
+
+    return 3;
+}
+
 // Registers BME280 model callbacks
 DataAPI *register_bme280_model_callbacks()
 {
     bme280_model_api.num_data_words = BME280_MODEL_WORDS;
+    bme280_model_api.retention_class = RETENTION_NORMAL;
     bme280_model_api.encode_verbose = encode_verbose;
     bme280_model_api.encode_minimalist = encode_minimalist;
     bme280_model_api.encode_raw_bytes = encode_raw_bytes;
+    bme280_model_api.encode_packed_binary = encode_packed_binary;
+    bme280_model_api.get_fields = get_fields;
     // bme280_model_api.split_values = split_values;
     return &bme280_model_api;
 }
\ No newline at end of file
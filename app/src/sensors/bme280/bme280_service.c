@@ -1,4 +1,5 @@
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
@@ -42,27 +43,34 @@ static void read_sensor_values()
 {
     LOG_DBG("Reading BME280");
 
-    SensorModelBME280 bme280_model;
-    uint32_t bme280_data[MAX_32_WORDS];
+    BufferReservation reservation;
+    SensorModelBME280 *bme280_model;
+    struct sensor_value temperature, pressure, humidity;
     int error;
 
 sample_fetch:
     error = sensor_sample_fetch(bme280);
     if (!error)
     {
-        sensor_channel_get(bme280, SENSOR_CHAN_AMBIENT_TEMP,
-                           &bme280_model.temperature);
-        sensor_channel_get(bme280, SENSOR_CHAN_PRESS,
-                           &bme280_model.pressure);
-        sensor_channel_get(bme280, SENSOR_CHAN_HUMIDITY,
-                           &bme280_model.humidity);
+        sensor_channel_get(bme280, SENSOR_CHAN_AMBIENT_TEMP, &temperature);
+        sensor_channel_get(bme280, SENSOR_CHAN_PRESS, &pressure);
+        sensor_channel_get(bme280, SENSOR_CHAN_HUMIDITY, &humidity);
+
+        // Model is written in place in the application buffer
+        error = reserve_app_buffer_item(&reservation, BME280_MODEL, 0, BME280_MODEL_WORDS);
+        if (!error)
+        {
+            bme280_model = (SensorModelBME280 *)reservation.data_words;
+            bme280_model->temperature =
+                sensor_value_to_fixed16(&temperature, BME280_TEMPERATURE_SCALE);
+            bme280_model->pressure = sensor_value_to_fixed32(&pressure, BME280_PRESSURE_SCALE);
+            bme280_model->humidity = sensor_value_to_ufixed16(&humidity, BME280_HUMIDITY_SCALE);
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-        bme280_model.timestamp = get_current_timestamp();
+            bme280_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-
-        memcpy(&bme280_data, &bme280_model, sizeof(SensorModelBME280));
-
-        if (insert_in_buffer(&app_buffer, bme280_data, BME280_MODEL, error, BME280_MODEL_WORDS) != 0)
+            error = commit_sensor_data(&reservation);
+        }
+        if (error)
         {
             LOG_ERR("Failed to insert data in ring buffer.");
         }
@@ -5,16 +5,21 @@
 #include <sensors/sensors_interface.h>
 #include <integration/data_buffer/buffer_service.h>
 
+// Fixed-point scales of the measurements
+#define BME280_TEMPERATURE_SCALE 100 // 0.01 °C
+#define BME280_PRESSURE_SCALE 1000   // 1 Pa
+#define BME280_HUMIDITY_SCALE 100    // 0.01 %RH
+
 typedef struct
 {
-    struct sensor_value temperature;
-    struct sensor_value pressure;
-    struct sensor_value humidity;
     uint32_t timestamp;
+    int32_t pressure;
+    int16_t temperature;
+    uint16_t humidity;
 } SensorModelBME280;
 
 // Number of 32-bit words in each data item (model)
-// Each sensor_value has 2 words, bme280 has 3 measurements
+// Pressure takes one word, temperature and humidity share another
 #define BME280_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SensorModelBME280))
 
 // Register BME280 sensor callbacks
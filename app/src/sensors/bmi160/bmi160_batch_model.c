@@ -0,0 +1,133 @@
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <sensors/bmi160/bmi160_service.h>
+
+LOG_MODULE_REGISTER(bmi160_batch_model, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+BUILD_ASSERT(BMI160_BATCH_MODEL_WORDS <= MAX_32_WORDS, "Batch record must fit in a buffer item");
+
+// Bytes of the batch fields before the samples in the binary frame
+#define BATCH_FIELDS_SIZE 5
+// Bytes of each sample in the binary frame
+#define SAMPLE_SIZE 12
+
+static DataAPI bmi160_batch_model_api;
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+// Encodes each sample of the batch into a line of a verbose string
+static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160Batch *batch_model = (SensorModelBMI160Batch *)data_words;
+    TextWriter text;
+
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, batch_model->timestamp);
+    text_append_char(&text, '.');
+    text_append_padded(&text, batch_model->first_sample_ms, 3);
+    text_append(&text, "; Samples: ");
+    text_append_uint(&text, batch_model->num_samples);
+    text_append(&text, "; Period [us]: ");
+    text_append_uint(&text, batch_model->sample_period_us);
+    text_append_char(&text, ';');
+    for (int i = 0; i < MIN(batch_model->num_samples, BMI160_BATCH_SAMPLES); i++)
+    {
+        if (text.length >= encoded_size)
+        {
+            break;
+        }
+        text_append(&text, "\n  ");
+        append_bmi160_sample(&text, &batch_model->samples[i][0], &batch_model->samples[i][3]);
+    }
+
+    return text_finish(&text);
+}
+
+// Encodes the samples of the batch as raw fixed-point values in a minimalist string
+static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160Batch *batch_model = (SensorModelBMI160Batch *)data_words;
+    TextWriter text;
+
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, batch_model->timestamp);
+    text_append_char(&text, '.');
+    text_append_padded(&text, batch_model->first_sample_ms, 3);
+    text_append_char(&text, 'P');
+    text_append_uint(&text, batch_model->sample_period_us);
+    text_append_char(&text, 'B');
+    for (int i = 0; i < MIN(batch_model->num_samples, BMI160_BATCH_SAMPLES); i++)
+    {
+        if (text.length >= encoded_size)
+        {
+            break;
+        }
+        // Raw fixed-point values of the 6 axes
+        for (int axis = 0; axis < 6; axis++)
+        {
+            text_append_char(&text, axis == 0 ? ' ' : ',');
+            text_append_int(&text, batch_model->samples[i][axis]);
+        }
+    }
+
+    return text_finish(&text);
+}
+
+static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Copies the packed fixed-point model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SensorModelBMI160Batch)));
+
+    return sizeof(SensorModelBMI160Batch);
+}
+
+// Encodes the batch into a binary frame with the milliseconds of the first sample
+// and the sample period in 2 bytes each, the number of samples in 1 byte and
+// then the samples, each laid out as in BMI160 frames
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160Batch *batch_model = (SensorModelBMI160Batch *)data_words;
+    uint8_t num_samples = MIN(batch_model->num_samples, BMI160_BATCH_SAMPLES);
+    int header_size = encode_packed_header(BMI160_BATCH_DATA, batch_model->timestamp,
+                                           BATCH_FIELDS_SIZE + num_samples * SAMPLE_SIZE,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    uint8_t *fields = &encoded_data[header_size];
+    sys_put_le16(batch_model->first_sample_ms, &fields[0]);
+    sys_put_le16(batch_model->sample_period_us, &fields[2]);
+    fields[4] = num_samples;
+    fields += BATCH_FIELDS_SIZE;
+    for (int i = 0; i < num_samples; i++)
+    {
+        for (int value = 0; value < 6; value++)
+        {
+            sys_put_le16(batch_model->samples[i][value], &fields[i * SAMPLE_SIZE + 2 * value]);
+        }
+    }
+
+    return header_size + BATCH_FIELDS_SIZE + num_samples * SAMPLE_SIZE;
+}
+
+// Registers BMI160 batch model callbacks
+DataAPI *register_bmi160_batch_model_callbacks()
+{
+    bmi160_batch_model_api.num_data_words = BMI160_BATCH_MODEL_WORDS;
+    bmi160_batch_model_api.retention_class = RETENTION_BULK;
+    bmi160_batch_model_api.encode_verbose = encode_verbose;
+    bmi160_batch_model_api.encode_minimalist = encode_minimalist;
+    bmi160_batch_model_api.encode_raw_bytes = encode_raw_bytes;
+    bmi160_batch_model_api.encode_packed_binary = encode_packed_binary;
+    return &bmi160_batch_model_api;
+}
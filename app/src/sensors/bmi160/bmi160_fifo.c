@@ -0,0 +1,298 @@
+#include <integration/timestamp/timestamp_service.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <sensors/bmi160/bmi160_fifo.h>
+
+LOG_MODULE_REGISTER(bmi160_fifo, CONFIG_APP_LOG_LEVEL);
+
+/**
+ * DEFINITIONS
+ */
+
+// Registers used to stream samples, from the BMI160 datasheet.
+// Zephyr's driver doesn't handle the FIFO, so they are accessed directly
+#define BMI160_REG_FIFO_LENGTH 0x22
+#define BMI160_REG_FIFO_DATA 0x24
+#define BMI160_REG_ACC_CONF 0x40
+#define BMI160_REG_ACC_RANGE 0x41
+#define BMI160_REG_GYR_CONF 0x42
+#define BMI160_REG_GYR_RANGE 0x43
+#define BMI160_REG_FIFO_CONFIG_0 0x46
+#define BMI160_REG_FIFO_CONFIG_1 0x47
+#define BMI160_REG_INT_EN_1 0x51
+#define BMI160_REG_INT_OUT_CTRL 0x53
+#define BMI160_REG_INT_LATCH 0x54
+#define BMI160_REG_INT_MAP_1 0x56
+#define BMI160_REG_CMD 0x7E
+
+#define BMI160_CMD_FIFO_FLUSH 0xB0
+// Normal filter mode, averaging samples over the output data rate
+#define BMI160_CONF_NORMAL_BANDWIDTH (0x2 << 4)
+// Stores gyroscope and accelerometer samples in the FIFO, without headers
+#define BMI160_FIFO_GYR_ACC (BIT(7) | BIT(6))
+#define BMI160_INT_FIFO_WATERMARK BIT(6)
+// Enables INT1 pin as push-pull and active low, as in the devicetree
+#define BMI160_INT1_OUTPUT_ENABLE BIT(3)
+#define BMI160_INT_NON_LATCHED 0x00
+#define BMI160_FIFO_LENGTH_MASK BIT_MASK(11)
+
+// Rates of both sensors are 25 Hz times a power of 2, with the code of 25 Hz being 6
+#define BMI160_ODR_CODE (6 + LOG2(CONFIG_BMI160_STREAMING_ODR / 25))
+BUILD_ASSERT(CONFIG_BMI160_STREAMING_ODR % 25 == 0 &&
+                 IS_POWER_OF_TWO(CONFIG_BMI160_STREAMING_ODR / 25) &&
+                 CONFIG_BMI160_STREAMING_ODR <= 1600,
+             "BMI160 output data rate must be 25, 50, 100, 200, 400, 800 or 1600 Hz");
+#define SAMPLE_PERIOD_US (USEC_PER_SEC / CONFIG_BMI160_STREAMING_ODR)
+// Watermark is set in units of 4 bytes
+BUILD_ASSERT(CONFIG_BMI160_STREAMING_WATERMARK * BMI160_FIFO_FRAME_SIZE / 4 <= UINT8_MAX,
+             "BMI160 FIFO watermark must fit in its register");
+// Frames read in each bus transfer, so it is kept short
+#define FRAMES_PER_READ 20
+
+static const struct i2c_dt_spec bmi160_bus = I2C_DT_SPEC_GET(DT_INST(0, bosch_bmi160));
+static const struct gpio_dt_spec bmi160_interrupt = GPIO_DT_SPEC_GET(DT_INST(0, bosch_bmi160),
+                                                                    int_gpios);
+// Register and value pairs written to start streaming. Both sensors
+// must have the same rate, as the FIFO frames have no headers
+static const uint8_t streaming_configuration[][2] = {
+    {BMI160_REG_ACC_CONF, BMI160_CONF_NORMAL_BANDWIDTH | BMI160_ODR_CODE},
+    {BMI160_REG_GYR_CONF, BMI160_CONF_NORMAL_BANDWIDTH | BMI160_ODR_CODE},
+    {BMI160_REG_FIFO_CONFIG_0, CONFIG_BMI160_STREAMING_WATERMARK * BMI160_FIFO_FRAME_SIZE / 4},
+    {BMI160_REG_FIFO_CONFIG_1, BMI160_FIFO_GYR_ACC},
+    {BMI160_REG_CMD, BMI160_CMD_FIFO_FLUSH},
+    {BMI160_REG_INT_OUT_CTRL, BMI160_INT1_OUTPUT_ENABLE},
+    {BMI160_REG_INT_LATCH, BMI160_INT_NON_LATCHED},
+    {BMI160_REG_INT_MAP_1, BMI160_INT_FIFO_WATERMARK},
+    {BMI160_REG_INT_EN_1, BMI160_INT_FIFO_WATERMARK},
+};
+static struct gpio_callback interrupt_callback;
+// FIFO is drained in the system workqueue, as the bus can't be used in interrupts
+static struct k_work drain_work;
+// FIFO is drained both by the workqueue and by the reading thread
+static K_MUTEX_DEFINE(drain_lock);
+// Full scale of the measurements, read from the sensor when streaming starts
+static int32_t acceleration_range_g;
+static int32_t rotation_range_dps;
+
+// Reads the full scale set by Zephyr's driver, used to convert the raw samples
+static int read_ranges();
+// Converts a FIFO frame into acceleration and rotation axes, in the scales of the models
+static void convert_frame(const uint8_t *frame, int16_t *sample);
+// Schedules draining of the FIFO when its watermark is reached
+static void fifo_watermark_handler(const struct device *dev, struct gpio_callback *callback,
+                                   uint32_t pins);
+static void drain_work_handler(struct k_work *work);
+// Stores batch record in the application buffer and starts the next one
+static void store_batch(SensorModelBMI160Batch *batch_model, int64_t *sample_time_us);
+
+/**
+ * IMPLEMENTATIONS
+ */
+
+int start_bmi160_streaming()
+{
+    int error;
+
+    if (!i2c_is_ready_dt(&bmi160_bus) || !gpio_is_ready_dt(&bmi160_interrupt))
+    {
+        LOG_ERR("BMI160 bus or interrupt pin is not ready");
+        return -ENODEV;
+    }
+    error = read_ranges();
+    if (error)
+    {
+        return error;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(streaming_configuration); i++)
+    {
+        error = i2c_reg_write_byte_dt(&bmi160_bus, streaming_configuration[i][0],
+                                      streaming_configuration[i][1]);
+        if (error)
+        {
+            LOG_ERR("Failed to configure BMI160 FIFO: %d", error);
+            return error;
+        }
+    }
+
+    k_work_init(&drain_work, drain_work_handler);
+    error = gpio_pin_configure_dt(&bmi160_interrupt, GPIO_INPUT);
+    if (error)
+    {
+        LOG_ERR("Failed to configure BMI160 interrupt pin: %d", error);
+        return error;
+    }
+    gpio_init_callback(&interrupt_callback, fifo_watermark_handler, BIT(bmi160_interrupt.pin));
+    error = gpio_add_callback_dt(&bmi160_interrupt, &interrupt_callback);
+    if (!error)
+    {
+        error = gpio_pin_interrupt_configure_dt(&bmi160_interrupt, GPIO_INT_EDGE_TO_ACTIVE);
+    }
+    if (error)
+    {
+        LOG_ERR("Failed to enable BMI160 interrupt: %d", error);
+        return error;
+    }
+
+    LOG_INF("Streaming BMI160 at %d Hz, draining every %d samples",
+            CONFIG_BMI160_STREAMING_ODR, CONFIG_BMI160_STREAMING_WATERMARK);
+    return 0;
+}
+
+int read_ranges()
+{
+    uint8_t acceleration_range, rotation_range;
+    int error = i2c_reg_read_byte_dt(&bmi160_bus, BMI160_REG_ACC_RANGE, &acceleration_range);
+    if (!error)
+    {
+        error = i2c_reg_read_byte_dt(&bmi160_bus, BMI160_REG_GYR_RANGE, &rotation_range);
+    }
+    if (error)
+    {
+        LOG_ERR("Failed to read BMI160 ranges: %d", error);
+        return error;
+    }
+
+    switch (acceleration_range)
+    {
+    case 0x03:
+        acceleration_range_g = 2;
+        break;
+    case 0x05:
+        acceleration_range_g = 4;
+        break;
+    case 0x08:
+        acceleration_range_g = 8;
+        break;
+    case 0x0C:
+        acceleration_range_g = 16;
+        break;
+    default:
+        LOG_ERR("Unknown BMI160 accelerometer range 0x%X", acceleration_range);
+        return -EINVAL;
+    }
+    // Codes 0 to 4 halve the range starting from 2000 °/s
+    rotation_range_dps = 2000 >> MIN(rotation_range & BIT_MASK(3), 4);
+    return 0;
+}
+
+void fifo_watermark_handler(const struct device *dev, struct gpio_callback *callback,
+                            uint32_t pins)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(callback);
+    ARG_UNUSED(pins);
+    k_work_submit(&drain_work);
+}
+
+void drain_work_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+    drain_bmi160_fifo();
+}
+
+void drain_bmi160_fifo()
+{
+    uint8_t frames[FRAMES_PER_READ * BMI160_FIFO_FRAME_SIZE];
+    SensorModelBMI160Batch batch_model = {0};
+    uint16_t fifo_length;
+    int64_t sample_time_us;
+    int num_frames, error;
+
+    k_mutex_lock(&drain_lock, K_FOREVER);
+    error = i2c_burst_read_dt(&bmi160_bus, BMI160_REG_FIFO_LENGTH, (uint8_t *)&fifo_length,
+                              sizeof(fifo_length));
+    if (error)
+    {
+        LOG_ERR("Failed to read BMI160 FIFO length: %d", error);
+        goto unlock;
+    }
+    fifo_length = sys_le16_to_cpu(fifo_length) & BMI160_FIFO_LENGTH_MASK;
+    num_frames = fifo_length / BMI160_FIFO_FRAME_SIZE;
+    if (fifo_length > BMI160_FIFO_SIZE - BMI160_FIFO_FRAME_SIZE)
+    {
+        LOG_WRN("BMI160 FIFO overflowed, oldest samples were lost");
+    }
+    if (num_frames == 0)
+    {
+        goto unlock;
+    }
+
+    // The newest sample was taken about now, and the others one period apart before it
+    sample_time_us = k_uptime_get() * USEC_PER_MSEC - (int64_t)(num_frames - 1) * SAMPLE_PERIOD_US;
+    batch_model.sample_period_us = SAMPLE_PERIOD_US;
+    while (num_frames > 0)
+    {
+        int read_frames = MIN(num_frames, FRAMES_PER_READ);
+
+        error = i2c_burst_read_dt(&bmi160_bus, BMI160_REG_FIFO_DATA, frames,
+                                  read_frames * BMI160_FIFO_FRAME_SIZE);
+        if (error)
+        {
+            LOG_ERR("Failed to read BMI160 FIFO: %d", error);
+            break;
+        }
+        for (int i = 0; i < read_frames; i++)
+        {
+            convert_frame(&frames[i * BMI160_FIFO_FRAME_SIZE],
+                          batch_model.samples[batch_model.num_samples++]);
+            if (batch_model.num_samples == BMI160_BATCH_SAMPLES)
+            {
+                store_batch(&batch_model, &sample_time_us);
+            }
+        }
+        num_frames -= read_frames;
+    }
+    if (batch_model.num_samples > 0)
+    {
+        store_batch(&batch_model, &sample_time_us);
+    }
+
+unlock:
+    k_mutex_unlock(&drain_lock);
+}
+
+void convert_frame(const uint8_t *frame, int16_t *sample)
+{
+    // Gyroscope axes come before the accelerometer ones in the frame
+    for (int axis = 0; axis < 3; axis++)
+    {
+        int64_t rotation = (int16_t)sys_get_le16(&frame[2 * axis]);
+        int64_t acceleration = (int16_t)sys_get_le16(&frame[6 + 2 * axis]);
+
+        acceleration = acceleration * acceleration_range_g * SENSOR_G * BMI160_ACCELERATION_SCALE /
+                       (INT16_MAX + 1) / 1000000;
+        rotation = rotation * rotation_range_dps * SENSOR_PI * BMI160_ROTATION_SCALE /
+                   (180 * (INT16_MAX + 1)) / 1000000;
+        sample[axis] = CLAMP(acceleration, INT16_MIN, INT16_MAX);
+        sample[3 + axis] = CLAMP(rotation, INT16_MIN, INT16_MAX);
+    }
+}
+
+void store_batch(SensorModelBMI160Batch *batch_model, int64_t *sample_time_us)
+{
+#ifndef CONFIG_EVENT_TIMESTAMP_NONE
+    // Timestamps have a resolution of seconds, so the milliseconds of the first sample are
+    // kept apart. Uptime and timestamp seconds change at the same time
+    int64_t uptime_ms = k_uptime_get();
+    int64_t current_time_ms = get_current_timestamp() * (int64_t)MSEC_PER_SEC + uptime_ms % MSEC_PER_SEC;
+    int64_t sample_time_ms = current_time_ms - (uptime_ms - *sample_time_us / USEC_PER_MSEC);
+    batch_model->timestamp = sample_time_ms / MSEC_PER_SEC;
+    batch_model->first_sample_ms = sample_time_ms % MSEC_PER_SEC;
+#endif /* CONFIG_EVENT_TIMESTAMP_NONE */
+
+    // Batch is built across FIFO reads, so it's copied once into the producer's lane
+    if (insert_in_app_buffer((uint32_t *)batch_model, BMI160_BATCH_DATA, 0,
+                             BMI160_BATCH_MODEL_WORDS) != 0)
+    {
+        LOG_ERR("Failed to insert data in ring buffer.");
+    }
+
+    *sample_time_us += batch_model->num_samples * SAMPLE_PERIOD_US;
+    memset(batch_model->samples, 0, sizeof(batch_model->samples));
+    batch_model->num_samples = 0;
+}
@@ -0,0 +1,17 @@
+#ifndef BMI160_FIFO_H
+#define BMI160_FIFO_H
+
+#include <sensors/bmi160/bmi160_service.h>
+
+// Size in bytes of the BMI160 hardware FIFO
+#define BMI160_FIFO_SIZE 1024
+// Size in bytes of each FIFO frame without headers, with gyroscope and accelerometer axes
+#define BMI160_FIFO_FRAME_SIZE 12
+
+// Configures accelerometer and gyroscope at CONFIG_BMI160_STREAMING_ODR, storing their
+// samples in the hardware FIFO, and drains it when its watermark interrupt fires
+int start_bmi160_streaming();
+// Moves the samples stored in the FIFO to the application buffer as batch records
+void drain_bmi160_fifo();
+
+#endif /* BMI160_FIFO_H */
@@ -1,4 +1,5 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/bmi160/bmi160_service.h>
 
 LOG_MODULE_REGISTER(bmi160_model, CONFIG_APP_LOG_LEVEL);
@@ -9,6 +10,14 @@ LOG_MODULE_REGISTER(bmi160_model, CONFIG_APP_LOG_LEVEL);
 
 static DataAPI bmi160_model_api;
 
+// Units of each axis in verbose strings, and separators in minimal ones
+static const char *const verbose_axes[3] = {" (X) ", " (Y) ", " (Z)"};
+static const char *const minimalist_axes[3] = {" ", " ", ""};
+
+// Appends the 3 axes of a measurement, each followed by its suffix
+static void append_axes(TextWriter *text, const int16_t *axes, uint32_t scale,
+                        const char *const *suffixes);
+
 /**
  * IMPLEMENTATIONS
  */
@@ -18,25 +27,15 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Timestamp: %d; "
-                    "Acceleration [m/s²]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z); "
-                    "Rotation [radian/s]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z);",
-                    bmi160_model->timestamp,
-                    bmi160_model->acceleration[0].val1,
-                    bmi160_model->acceleration[0].val2 / 10000,
-                    bmi160_model->acceleration[1].val1,
-                    bmi160_model->acceleration[1].val2 / 10000,
-                    bmi160_model->acceleration[2].val1,
-                    bmi160_model->acceleration[2].val2 / 10000,
-                    bmi160_model->rotation[0].val1,
-                    bmi160_model->rotation[0].val2 / 10000,
-                    bmi160_model->rotation[1].val1,
-                    bmi160_model->rotation[1].val2 / 10000,
-                    bmi160_model->rotation[2].val1,
-                    bmi160_model->rotation[2].val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, bmi160_model->timestamp);
+    text_append(&text, "; ");
+    append_bmi160_sample(&text, bmi160_model->acceleration, bmi160_model->rotation);
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a minimalist string
@@ -44,40 +43,91 @@ static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t
 {
     // Converts words into the model
     SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dAC%d.%02d %d.%02d %d.%02dR%d.%02d %d.%02d %d.%02d",
-                    bmi160_model->timestamp,
-                    bmi160_model->acceleration[0].val1,
-                    bmi160_model->acceleration[0].val2 / 10000,
-                    bmi160_model->acceleration[1].val1,
-                    bmi160_model->acceleration[1].val2 / 10000,
-                    bmi160_model->acceleration[2].val1,
-                    bmi160_model->acceleration[2].val2 / 10000,
-                    bmi160_model->rotation[0].val1,
-                    bmi160_model->rotation[0].val2 / 10000,
-                    bmi160_model->rotation[1].val1,
-                    bmi160_model->rotation[1].val2 / 10000,
-                    bmi160_model->rotation[2].val1,
-                    bmi160_model->rotation[2].val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, bmi160_model->timestamp);
+    text_append(&text, "AC");
+    append_axes(&text, bmi160_model->acceleration, BMI160_ACCELERATION_SCALE, minimalist_axes);
+    text_append_char(&text, 'R');
+    append_axes(&text, bmi160_model->rotation, BMI160_ROTATION_SCALE, minimalist_axes);
+    return text_finish(&text);
+}
+
+void append_axes(TextWriter *text, const int16_t *axes, uint32_t scale,
+                 const char *const *suffixes)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        text_append_fixed(text, axes[i], scale, 2);
+        text_append(text, suffixes[i]);
+    }
+}
+
+void append_bmi160_sample(TextWriter *text, const int16_t *acceleration, const int16_t *rotation)
+{
+    text_append(text, "Acceleration [m/s²]: ");
+    append_axes(text, acceleration, BMI160_ACCELERATION_SCALE, verbose_axes);
+    text_append(text, "; Rotation [radian/s]: ");
+    append_axes(text, rotation, BMI160_ROTATION_SCALE, verbose_axes);
+    text_append_char(text, ';');
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-    // Converts words into bytes
-    bytecpy(encoded_data, data_words, encoded_size);
+    // Copies the packed fixed-point model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SensorModelBMI160)));
 
     return sizeof(SensorModelBMI160);
 }
 
+// Encodes data model into a binary frame with each axis in 2 bytes,
+// acceleration axes first
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+    int header_size = encode_packed_header(BMI160_MODEL, bmi160_model->timestamp, 12,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        sys_put_le16(bmi160_model->acceleration[axis], &encoded_data[header_size + 2 * axis]);
+        sys_put_le16(bmi160_model->rotation[axis], &encoded_data[header_size + 6 + 2 * axis]);
+    }
+
+    return header_size + 12;
+}
+
+// Gets the measurements of the data model in the order of its binary frame
+static int get_fields(uint32_t *data_words, int32_t *fields)
+{
+    SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        fields[axis] = bmi160_model->acceleration[axis];
+        fields[3 + axis] = bmi160_model->rotation[axis];
+    }
+
+    return 6;
+}
+
 // Registers BMI160 model callbacks
 DataAPI *register_bmi160_model_callbacks()
 {
     bmi160_model_api.num_data_words = BMI160_MODEL_WORDS;
+    bmi160_model_api.retention_class = RETENTION_BULK;
     bmi160_model_api.encode_verbose = encode_verbose;
     bmi160_model_api.encode_minimalist = encode_minimalist;
     bmi160_model_api.encode_raw_bytes = encode_raw_bytes;
+    bmi160_model_api.encode_packed_binary = encode_packed_binary;
+    bmi160_model_api.get_fields = get_fields;
     // bmi160_model_api.split_values = split_values;
     return &bmi160_model_api;
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 #include <zephyr/device.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
 #include <sensors/bmi160/bmi160_service.h>
+#ifdef CONFIG_BMI160_STREAMING
+#include <sensors/bmi160/bmi160_fifo.h>
+#endif /* CONFIG_BMI160_STREAMING */
 
 LOG_MODULE_REGISTER(bmi160_service, CONFIG_APP_LOG_LEVEL);
 
@@ -35,33 +39,54 @@ static int init_sensor()
         LOG_ERR("device \"%s\" is not ready", bmi160->name);
         return -EAGAIN;
     }
+#ifdef CONFIG_BMI160_STREAMING
+    return start_bmi160_streaming();
+#else
     return 0;
+#endif /* CONFIG_BMI160_STREAMING */
 }
 
 // Reads sensor measurements and stores them in buffer
 static void read_sensor_values()
 {
+#ifdef CONFIG_BMI160_STREAMING
+    // Samples are taken by the sensor itself, so the scheduled readings only
+    // flush those that didn't reach the FIFO watermark yet
+    drain_bmi160_fifo();
+    return;
+#endif /* CONFIG_BMI160_STREAMING */
     LOG_DBG("Reading BMI160");
 
-    SensorModelBMI160 bmi160_model;
-    uint32_t bmi160_data[MAX_32_WORDS];
+    BufferReservation reservation;
+    SensorModelBMI160 *bmi160_model;
+    struct sensor_value acceleration[3], rotation[3];
     int error = 0;
 
 sample_fetch:
     error = sensor_sample_fetch(bmi160);
     if (!error)
     {
-        sensor_channel_get(bmi160, SENSOR_CHAN_ACCEL_XYZ,
-                           bmi160_model.acceleration);
-        sensor_channel_get(bmi160, SENSOR_CHAN_GYRO_XYZ,
-                           bmi160_model.rotation);
+        sensor_channel_get(bmi160, SENSOR_CHAN_ACCEL_XYZ, acceleration);
+        sensor_channel_get(bmi160, SENSOR_CHAN_GYRO_XYZ, rotation);
+
+        // Model is written in place in the application buffer
+        error = reserve_app_buffer_item(&reservation, BMI160_MODEL, 0, BMI160_MODEL_WORDS);
+        if (!error)
+        {
+            bmi160_model = (SensorModelBMI160 *)reservation.data_words;
+            for (int i = 0; i < 3; i++)
+            {
+                bmi160_model->acceleration[i] =
+                    sensor_value_to_fixed16(&acceleration[i], BMI160_ACCELERATION_SCALE);
+                bmi160_model->rotation[i] =
+                    sensor_value_to_fixed16(&rotation[i], BMI160_ROTATION_SCALE);
+            }
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-        bmi160_model.timestamp = get_current_timestamp();
+            bmi160_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-
-        memcpy(&bmi160_data, &bmi160_model, sizeof(SensorModelBMI160));
-
-        if (insert_in_buffer(&app_buffer, bmi160_data, BMI160_MODEL, error, BMI160_MODEL_WORDS) != 0)
+            error = commit_sensor_data(&reservation);
+        }
+        if (error)
         {
             LOG_ERR("Failed to insert data in ring buffer.");
         }
@@ -4,23 +4,52 @@
 #include <zephyr/drivers/sensor.h>
 #include <sensors/sensors_interface.h>
 #include <integration/data_buffer/buffer_service.h>
+#include <integration/data_abstraction/text_format/text_format.h>
+
+// Fixed-point scales of the measurements
+#define BMI160_ACCELERATION_SCALE 100 // 0.01 m/s², up to ±33 g
+#define BMI160_ROTATION_SCALE 500     // 0.002 rad/s, up to ±3754 °/s
 
 typedef struct
 {
-    struct sensor_value acceleration[3];
-    struct sensor_value rotation[3];
     uint32_t timestamp;
+    int16_t acceleration[3];
+    int16_t rotation[3];
 } SensorModelBMI160;
 
 // Number of 32-bit words in each data item (model)
-// Each sensor_value has 2 words, bmi160 has 2 measurements
-// with 3 axis each
+// Each axis of the 2 measurements takes half a word
 #define BMI160_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SensorModelBMI160))
 
+// Samples in each batch record, as many as fit in an item
+#define BMI160_BATCH_SAMPLES 4
+
+// Consecutive samples drained from the hardware FIFO, taken at a fixed period,
+// so they share one timestamp
+typedef struct
+{
+    uint32_t timestamp;
+    // Milliseconds past timestamp when the first sample was taken
+    uint16_t first_sample_ms;
+    uint16_t sample_period_us;
+    uint8_t num_samples;
+    // Acceleration axes followed by rotation axes of each sample,
+    // in the same scales as SensorModelBMI160
+    int16_t samples[BMI160_BATCH_SAMPLES][6];
+} SensorModelBMI160Batch;
+
+#define BMI160_BATCH_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SensorModelBMI160Batch))
+
 // Register BMI160 sensor callbacks
 SensorAPI *register_bmi160_callbacks();
 
 // Register BMI160 model callbacks
 DataAPI *register_bmi160_model_callbacks();
 
+// Register BMI160 batch model callbacks
+DataAPI *register_bmi160_batch_model_callbacks();
+
+// Appends the acceleration and rotation axes of a sample to a verbose string
+void append_bmi160_sample(TextWriter *text, const int16_t *acceleration, const int16_t *rotation);
+
 #endif /* BMI160_SERVICE_H */
\ No newline at end of file
@@ -1,7 +1,9 @@
-#include <stdlib.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/l86_m33/l86_m33_service.h>
 
+#include <integration/data_abstraction/text_format/text_format.h>
+
 LOG_MODULE_REGISTER(gnss_model, CONFIG_APP_LOG_LEVEL);
 
 /**
@@ -19,29 +21,35 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelGNSS *gnss_model = (SensorModelGNSS *)data_words;
+    TextWriter text;
 
-    // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Latitude: %lld.%lld o; Longitude: %lld.%lld o; Bearing angle: %d.%d o; "
-                    "Speed: %d.%d m/s; Altitude: %d.%d m;\n\t"
-                    "Timestamp: %02dh %02dmin %02d.%ds - %02d/%02d/20%02d",
-                    gnss_model->navigation.latitude / 1000000000,
-                    llabs(gnss_model->navigation.latitude % 1000000000) / 100, // Gets 7 digits
-                    gnss_model->navigation.longitude / 1000000000,
-                    llabs(gnss_model->navigation.longitude % 1000000000) / 100, // Gets 7 digits
-                    gnss_model->navigation.bearing / 1000,
-                    gnss_model->navigation.bearing % 1000,
-                    gnss_model->navigation.speed / 1000,
-                    gnss_model->navigation.speed % 1000,
-                    gnss_model->navigation.altitude / 1000,
-                    gnss_model->navigation.altitude % 1000,
-                    gnss_model->real_time.hour,
-                    gnss_model->real_time.minute,
-                    gnss_model->real_time.millisecond / 1000,
-                    gnss_model->real_time.millisecond % 1000,
-                    gnss_model->real_time.month_day,
-                    gnss_model->real_time.month,
-                    gnss_model->real_time.century_year);
+    // Formats the string, with coordinates in nanodegrees and the others in thousandths
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Latitude: ");
+    text_append_fixed64(&text, gnss_model->navigation.latitude, 1000000000, 7);
+    text_append(&text, " o; Longitude: ");
+    text_append_fixed64(&text, gnss_model->navigation.longitude, 1000000000, 7);
+    text_append(&text, " o; Bearing angle: ");
+    text_append_fixed(&text, gnss_model->navigation.bearing, 1000, 3);
+    text_append(&text, " o; Speed: ");
+    text_append_fixed(&text, gnss_model->navigation.speed, 1000, 3);
+    text_append(&text, " m/s; Altitude: ");
+    text_append_fixed(&text, gnss_model->navigation.altitude, 1000, 3);
+    text_append(&text, " m;\n\tTimestamp: ");
+    text_append_padded(&text, gnss_model->real_time.hour, 2);
+    text_append(&text, "h ");
+    text_append_padded(&text, gnss_model->real_time.minute, 2);
+    text_append(&text, "min ");
+    text_append_padded(&text, gnss_model->real_time.millisecond / 1000, 2);
+    text_append_char(&text, '.');
+    text_append_padded(&text, gnss_model->real_time.millisecond % 1000, 3);
+    text_append(&text, "s - ");
+    text_append_padded(&text, gnss_model->real_time.month_day, 2);
+    text_append_char(&text, '/');
+    text_append_padded(&text, gnss_model->real_time.month, 2);
+    text_append(&text, "/20");
+    text_append_padded(&text, gnss_model->real_time.century_year, 2);
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a minimalist string
@@ -49,22 +57,31 @@ static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t
 {
     // Converts words into the model
     SensorModelGNSS *gnss_model = (SensorModelGNSS *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dLT%lldLG%lldB%dS%dAL%dTU%02d%02d%dD%02d%02d%02d",
-                    gnss_model->timestamp,
-                    gnss_model->navigation.latitude / 100,
-                    gnss_model->navigation.longitude / 100,
-                    gnss_model->navigation.bearing,
-                    gnss_model->navigation.speed,
-                    gnss_model->navigation.altitude / 100,
-                    gnss_model->real_time.hour,
-                    gnss_model->real_time.minute,
-                    gnss_model->real_time.millisecond / 1000,
-                    gnss_model->real_time.month_day,
-                    gnss_model->real_time.month,
-                    gnss_model->real_time.century_year);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, gnss_model->timestamp);
+    text_append(&text, "LT");
+    text_append_int(&text, gnss_model->navigation.latitude / 100);
+    text_append(&text, "LG");
+    text_append_int(&text, gnss_model->navigation.longitude / 100);
+    text_append_char(&text, 'B');
+    text_append_uint(&text, gnss_model->navigation.bearing);
+    text_append_char(&text, 'S');
+    text_append_uint(&text, gnss_model->navigation.speed);
+    text_append(&text, "AL");
+    text_append_int(&text, gnss_model->navigation.altitude / 100);
+    text_append(&text, "TU");
+    text_append_padded(&text, gnss_model->real_time.hour, 2);
+    text_append_padded(&text, gnss_model->real_time.minute, 2);
+    text_append_uint(&text, gnss_model->real_time.millisecond / 1000);
+    text_append_char(&text, 'D');
+    text_append_padded(&text, gnss_model->real_time.month_day, 2);
+    text_append_padded(&text, gnss_model->real_time.month, 2);
+    text_append_padded(&text, gnss_model->real_time.century_year, 2);
+    return text_finish(&text);
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
@@ -75,13 +92,44 @@ static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t
     return sizeof(SensorModelGNSS);
 }
 
+// Encodes data model into a binary frame with latitude and longitude in 10^-7 degrees,
+// bearing in centidegrees, speed in cm/s and altitude in cm, followed by UTC time
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelGNSS *gnss_model = (SensorModelGNSS *)data_words;
+    int header_size = encode_packed_header(GNSS_MODEL, gnss_model->timestamp, 22,
+                                           encoded_data, encoded_size);
+    uint8_t *fields;
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+    fields = &encoded_data[header_size];
+
+    sys_put_le32(gnss_model->navigation.latitude / 100, &fields[0]);
+    sys_put_le32(gnss_model->navigation.longitude / 100, &fields[4]);
+    sys_put_le16(gnss_model->navigation.bearing / 10, &fields[8]);
+    sys_put_le16(gnss_model->navigation.speed / 10, &fields[10]);
+    sys_put_le32(gnss_model->navigation.altitude / 10, &fields[12]);
+    fields[16] = gnss_model->real_time.hour;
+    fields[17] = gnss_model->real_time.minute;
+    fields[18] = gnss_model->real_time.millisecond / 1000;
+    fields[19] = gnss_model->real_time.month_day;
+    fields[20] = gnss_model->real_time.month;
+    fields[21] = gnss_model->real_time.century_year;
+
+    return header_size + 22;
+}
+
 // Registers GNSS model callbacks
 DataAPI *register_gnss_model_callbacks()
 {
     gnss_model_api.num_data_words = GNSS_MODEL_WORDS;
+    gnss_model_api.retention_class = RETENTION_CRITICAL;
     gnss_model_api.encode_verbose = encode_verbose;
     gnss_model_api.encode_minimalist = encode_minimalist;
     gnss_model_api.encode_raw_bytes = encode_raw_bytes;
+    gnss_model_api.encode_packed_binary = encode_packed_binary;
     // gnss_model_api.split_values = split_values;
     return &gnss_model_api;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/sys/timeutil.h>
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 #include <sensors/l86_m33/l86_m33_service.h>
 
 LOG_MODULE_REGISTER(l86_m33_service, CONFIG_APP_LOG_LEVEL);
@@ -52,7 +53,7 @@ static int init_sensor()
         LOG_ERR("Device \"%s\" could not be initialized", l86_m33->name);
         return error;
     }
-    error = set_valid_fix_interval(get_sampling_interval());
+    error = set_valid_fix_interval(get_sensor_sampling_interval(L86_M33));
     if (error)
     {
         return error;
@@ -88,23 +89,27 @@ void receive_fix_callback(const struct device *gnss_device,
     // to start gettting valid readings from the satellites
     if (gnss_data->info.fix_status != GNSS_FIX_STATUS_NO_FIX)
     {
-        SensorModelGNSS gnss_model;
-        uint32_t l86_m33_data[MAX_32_WORDS] = {0};
+        BufferReservation reservation;
+        SensorModelGNSS *gnss_model;
+        int error;
 
 #if defined(CONFIG_EVENT_TIMESTAMP_GNSS)
         convert_and_set_sync_time(gnss_data);
 #endif
 
-        gnss_model.navigation = gnss_data->nav_data;
-        gnss_model.real_time = gnss_data->utc;
-
+        // Model is written in place in the application buffer
+        error = reserve_app_buffer_item(&reservation, GNSS_MODEL, 0, GNSS_MODEL_WORDS);
+        if (!error)
+        {
+            gnss_model = (SensorModelGNSS *)reservation.data_words;
+            gnss_model->navigation = gnss_data->nav_data;
+            gnss_model->real_time = gnss_data->utc;
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-        gnss_model.timestamp = get_current_timestamp();
+            gnss_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-
-        memcpy(&l86_m33_data, &gnss_model, sizeof(SensorModelGNSS));
-
-        if (insert_in_buffer(&app_buffer, l86_m33_data, GNSS_MODEL, 0, GNSS_MODEL_WORDS) != 0)
+            error = commit_sensor_data(&reservation);
+        }
+        if (error)
         {
             LOG_ERR("Failed to insert data in ring buffer.");
         }
@@ -1,5 +1,7 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/scd30/scd30_service.h>
+#include <integration/data_abstraction/text_format/text_format.h>
 
 LOG_MODULE_REGISTER(scd30_model, CONFIG_APP_LOG_LEVEL);
 
@@ -18,17 +20,20 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Timestamp: %d; CO2: %d ppm; Temperature: %d.%02d oC; "
-                    "Humidity: %d.%02d %% RH;",
-                    scd30_model->timestamp,
-                    scd30_model->co2.val1,
-                    scd30_model->temperature.val1,
-                    scd30_model->temperature.val2 / 10000,
-                    scd30_model->humidity.val1,
-                    scd30_model->humidity.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, scd30_model->timestamp);
+    text_append(&text, "; CO2: ");
+    text_append_fixed(&text, scd30_model->co2, SCD30_CO2_SCALE, 0);
+    text_append(&text, " ppm; Temperature: ");
+    text_append_fixed(&text, scd30_model->temperature, SCD30_TEMPERATURE_SCALE, 2);
+    text_append(&text, " oC; Humidity: ");
+    text_append_fixed(&text, scd30_model->humidity, SCD30_HUMIDITY_SCALE, 2);
+    text_append(&text, " % RH;");
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a mininal string
@@ -36,33 +41,69 @@ static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t
 {
     // Converts words into the model
     SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dCO2%dT%d.%02dH%d.%02d",
-                    scd30_model->timestamp,
-                    scd30_model->co2.val1,
-                    scd30_model->temperature.val1,
-                    scd30_model->temperature.val2 / 10000,
-                    scd30_model->humidity.val1,
-                    scd30_model->humidity.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, scd30_model->timestamp);
+    text_append(&text, "CO2");
+    text_append_fixed(&text, scd30_model->co2, SCD30_CO2_SCALE, 0);
+    text_append_char(&text, 'T');
+    text_append_fixed(&text, scd30_model->temperature, SCD30_TEMPERATURE_SCALE, 2);
+    text_append_char(&text, 'H');
+    text_append_fixed(&text, scd30_model->humidity, SCD30_HUMIDITY_SCALE, 2);
+    return text_finish(&text);
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-    // Converts words into bytes
-    bytecpy(encoded_data, data_words, encoded_size);
+    // Copies the packed fixed-point model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SensorModelSCD30)));
 
     return sizeof(SensorModelSCD30);
 }
 
+// Encodes data model into a binary frame with each measurement in 2 bytes
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+    int header_size = encode_packed_header(SCD30_MODEL, scd30_model->timestamp, 6,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    sys_put_le16(scd30_model->co2, &encoded_data[header_size]);
+    sys_put_le16(scd30_model->temperature, &encoded_data[header_size + 2]);
+    sys_put_le16(scd30_model->humidity, &encoded_data[header_size + 4]);
+
+    return header_size + 6;
+}
+
+// Gets the measurements of the data model in the order of its binary frame
+static int get_fields(uint32_t *data_words, int32_t *fields)
+{
+    SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+
+    fields[0] = scd30_model->co2;
+    fields[1] = scd30_model->temperature;
+    fields[2] = scd30_model->humidity;
+
+    return 3;
+}
+
 // Registers SCD30 model callbacks
 DataAPI *register_scd30_model_callbacks()
 {
     scd30_model_api.num_data_words = SCD30_MODEL_WORDS;
+    scd30_model_api.retention_class = RETENTION_NORMAL;
     scd30_model_api.encode_verbose = encode_verbose;
     scd30_model_api.encode_minimalist = encode_minimalist;
     scd30_model_api.encode_raw_bytes = encode_raw_bytes;
+    scd30_model_api.encode_packed_binary = encode_packed_binary;
+    scd30_model_api.get_fields = get_fields;
     //  scd30_model_api.split_values = split_values;
     return &scd30_model_api;
 }
\ No newline at end of file
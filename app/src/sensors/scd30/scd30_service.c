@@ -1,4 +1,5 @@
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
@@ -87,7 +88,7 @@ static int init_sensor()
     scd30_register_callback(scd30, read_data_callback);
 
     // Warns the sampling interval isn't enough for stabilization
-    if (get_sampling_interval() < k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
+    if (get_sensor_sampling_interval(SCD30) < k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
     {
         LOG_WRN("Sampling interval is less than SCD30 response time. Data will "
                 "be reliable after %d seconds.",
@@ -114,27 +115,34 @@ void read_data_callback()
 
     LOG_DBG("Storing SCD30 data");
 
-    SensorModelSCD30 scd30_model = {0};
-    uint32_t scd30_data[MAX_32_WORDS];
+    BufferReservation reservation;
+    SensorModelSCD30 *scd30_model;
+    struct sensor_value co2, temperature, humidity;
     int error = 0;
 
-    sensor_channel_get(scd30, SENSOR_CHAN_CO2,
-                       &scd30_model.co2);
-    sensor_channel_get(scd30, SENSOR_CHAN_AMBIENT_TEMP,
-                       &scd30_model.temperature);
-    sensor_channel_get(scd30, SENSOR_CHAN_HUMIDITY,
-                       &scd30_model.humidity);
+    sensor_channel_get(scd30, SENSOR_CHAN_CO2, &co2);
+    sensor_channel_get(scd30, SENSOR_CHAN_AMBIENT_TEMP, &temperature);
+    sensor_channel_get(scd30, SENSOR_CHAN_HUMIDITY, &humidity);
+
+    // Model is written in place in the application buffer
+    error = reserve_app_buffer_item(&reservation, SCD30_MODEL, 0, SCD30_MODEL_WORDS);
+    if (!error)
+    {
+        scd30_model = (SensorModelSCD30 *)reservation.data_words;
+        scd30_model->co2 = sensor_value_to_ufixed16(&co2, SCD30_CO2_SCALE);
+        scd30_model->temperature = sensor_value_to_fixed16(&temperature, SCD30_TEMPERATURE_SCALE);
+        scd30_model->humidity = sensor_value_to_ufixed16(&humidity, SCD30_HUMIDITY_SCALE);
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-    scd30_model.timestamp = get_current_timestamp();
+        scd30_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-    memcpy(&scd30_data, &scd30_model, sizeof(SensorModelSCD30));
-
-    if (insert_in_buffer(&app_buffer, scd30_data, SCD30_MODEL, error, SCD30_MODEL_WORDS) != 0)
+        error = commit_sensor_data(&reservation);
+    }
+    if (error)
     {
         LOG_ERR("Failed to insert data in ring buffer.");
     }
 
-    if (get_sampling_interval() >= k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
+    if (get_sensor_sampling_interval(SCD30) >= k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
     {
         // Stops periodic measurement to save power
         scd30_stop_periodic_measurement(scd30);
@@ -144,7 +152,7 @@ void read_data_callback()
 static inline void read_sensor_values()
 {
 
-    if (get_sampling_interval() < k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
+    if (get_sensor_sampling_interval(SCD30) < k_ticks_to_ms_floor32(SCD30_RESPONSE_TIME.ticks))
     {
         k_work_schedule(&trigger_stabilized_sensor_routine, K_NO_WAIT);
     }
@@ -5,16 +5,21 @@
 #include <sensors/sensors_interface.h>
 #include <integration/data_buffer/buffer_service.h>
 
+// Fixed-point scales of the measurements
+#define SCD30_CO2_SCALE 1           // 1 ppm
+#define SCD30_TEMPERATURE_SCALE 100 // 0.01 °C
+#define SCD30_HUMIDITY_SCALE 100    // 0.01 %RH
+
 typedef struct
 {
-	struct sensor_value co2;
-	struct sensor_value temperature;
-	struct sensor_value humidity;
 	uint32_t timestamp;
+	uint16_t co2;
+	int16_t temperature;
+	uint16_t humidity;
 } SensorModelSCD30;
 
 // Number of 32-bit words in each data item (model)
-// Each sensor_value has 2 words, SCD30 has 3 measurements
+// Each measurement takes half a word
 #define SCD30_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SensorModelSCD30))
 
 // To be used in SCD30 compensation of ambient pressure
@@ -6,6 +6,7 @@
 #include <sensors/scd30/scd30_service.h>
 #include <sensors/l86_m33/l86_m33_service.h>
 #include <sensors/vbatt/vbatt_service.h>
+#include <integration/data_buffer/buffer_service.h>
 
 LOG_MODULE_REGISTER(sensors_interface, CONFIG_APP_LOG_LEVEL);
 
@@ -18,10 +19,41 @@ static K_THREAD_STACK_DEFINE(sensors_thread_stack_area, SENSORS_THREAD_STACK_SIZ
 // Thread control block - metadata
 static struct k_thread sensors_thread_data;
 static k_tid_t sensors_thread_id;
-// Time between measurements
-// #TODO: Make it configurable from module that receives commands
-// #TODO: Look for macro that defines variable
+// Interval of sensors that don't set their own
+#define SENSOR_SAMPLING_INTERVAL(interval) ((interval) > 0 ? (interval) : CONFIG_SAMPLING_INTERVAL)
+
+// Default time between measurements
 static int current_sampling_interval = CONFIG_SAMPLING_INTERVAL;
+// Guards the intervals, which the shell changes while the reading thread schedules sensors
+static struct k_spinlock intervals_lock;
+// Time between measurements of each sensor, in milliseconds
+static int sensor_sampling_intervals[MAX_SENSORS] = {
+	[BME280] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_BME280),
+	[BMI160] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_BMI160),
+	[SI1133] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_SI1133),
+	[VBATT] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_VBATT),
+	[SCD30] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_SCD30),
+	[L86_M33] = SENSOR_SAMPLING_INTERVAL(CONFIG_SAMPLING_INTERVAL_L86_M33),
+};
+// Set when intervals change, so the reading thread reschedules sensors
+static atomic_t schedule_changed = ATOMIC_INIT(0);
+// Given when intervals change, ending the reading thread's wait for the next event.
+// Drivers' own sleeps aren't interrupted, so conversions they wait for complete
+static K_SEM_DEFINE(schedule_sem, 0, 1);
+// Uptime in ticks when each sensor must be read next and when it was last due.
+// Deadlines advance by whole intervals, so time taken by readings doesn't add up
+static int64_t next_deadlines[MAX_SENSORS];
+static int64_t last_deadlines[MAX_SENSORS];
+// Conversions started and not collected yet, and when each sensor will have results ready
+static bool measuring[MAX_SENSORS];
+static int64_t ready_times[MAX_SENSORS];
+// When each sensor's current reading began, either by starting a conversion or reading it
+static int64_t start_times[MAX_SENSORS];
+// Min-heap of registered sensors ordered by their next event, which is the deadline
+// or, while converting, the ready time, owned by the reading thread
+static uint8_t deadline_heap[MAX_SENSORS];
+static int scheduled_sensors = 0;
+static SamplingStats sampling_stats[MAX_SENSORS];
 // List of registered sensor APIs
 SensorAPI *sensor_apis[MAX_SENSORS] = {0};
 
@@ -31,6 +63,25 @@ static void init_sensors();
 static void start_reading();
 // Functions that calls registered sensors in separate thread
 static void perform_read_sensors(void *, void *, void *);
+// Starts conversions of the sensors that support it and are due, so they run
+// while other sensors are read. Returns whether any was started
+static bool start_due_measurements(int64_t now);
+// Reads sensor, or collects its conversion, and moves its deadline to the first one still ahead
+static void read_scheduled_sensor(enum SensorType sensor);
+// Returns when the sensor must be handled next
+static int64_t get_event_time(enum SensorType sensor);
+// Rebuilds the heap after event times change
+static void heapify_events();
+// Computes the next deadline of every registered sensor from its interval
+// and rebuilds the heap
+static void schedule_sensors();
+// Signals the reading thread to schedule sensors again after an interval changes
+static void reschedule_sensors();
+// Passes the interval of a sensor to it, if it measures by itself
+static int update_sensor_interval(enum SensorType sensor);
+// Moves the heap entry at `position` down until its event is
+// earlier than the ones below it
+static void sift_down_deadline(int position);
 
 /**
  * IMPLEMENTATIONS
@@ -55,13 +106,13 @@ int register_sensors_callbacks()
 	sensor_apis[VBATT] = register_vbatt_callbacks();
 #endif /* CONFIG_VBATT */
 
-#ifdef CONFIG_SHIELD_SCD30
+#ifdef CONFIG_SCD30
 	sensor_apis[SCD30] = register_scd30_callbacks();
 #endif /* CONFIG_SCD30 */
 
-#ifdef CONFIG_SHIELD_PULGA_GPS
+#ifdef CONFIG_GNSS_QUECTEL_L86
 	sensor_apis[L86_M33] = register_l86_m33_callbacks();
-#endif /* CONFIG_SHIELD_PULGA_GPS */
+#endif /* CONFIG_GNSS_QUECTEL_L86 */
 
 	return 0;
 }
@@ -116,31 +167,277 @@ static void perform_read_sensors(void *param0, void *param1, void *param2)
 	ARG_UNUSED(param0);
 	ARG_UNUSED(param1);
 	ARG_UNUSED(param2);
+	// Readings and summaries are inserted without contending with other producers
+	register_buffer_producer(k_current_get());
+	int64_t now = k_uptime_ticks();
+
+	// Every sensor is read right away
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		last_deadlines[i] = now - k_ms_to_ticks_ceil64(get_sensor_sampling_interval(i));
+	}
+	schedule_sensors();
 
 	while (1)
 	{
-		// Calls read function for each registered API
-		for (int i = 0; i < MAX_SENSORS; i++)
+		if (atomic_cas(&schedule_changed, 1, 0))
+		{
+			schedule_sensors();
+		}
+		if (scheduled_sensors == 0)
+		{
+			LOG_WRN("No sensors to read");
+			k_sem_take(&schedule_sem, K_FOREVER);
+			continue;
+		}
+		// Waits for the earliest event, which may be
+		// moved earlier if woken up by an interval change
+		enum SensorType sensor = deadline_heap[0];
+		k_sem_take(&schedule_sem, K_TIMEOUT_ABS_TICKS(get_event_time(sensor)));
+		if (k_uptime_ticks() < get_event_time(sensor))
+		{
+			continue;
+		}
+		if (start_due_measurements(k_uptime_ticks()))
+		{
+			heapify_events();
+			continue;
+		}
+		read_scheduled_sensor(sensor);
+		sift_down_deadline(0);
+	}
+}
+
+void read_scheduled_sensor(enum SensorType sensor)
+{
+	SamplingStats *stats = &sampling_stats[sensor];
+	int64_t interval = k_ms_to_ticks_ceil64(get_sensor_sampling_interval(sensor));
+	int64_t start = k_uptime_ticks();
+
+	if (!measuring[sensor])
+	{
+		start_times[sensor] = start;
+	}
+	uint32_t jitter = k_ticks_to_us_floor32(start_times[sensor] - next_deadlines[sensor]);
+
+	sensor_apis[sensor]->read_sensor_values();
+
+	int64_t end = k_uptime_ticks();
+	measuring[sensor] = false;
+	stats->readings++;
+	stats->total_jitter_us += jitter;
+	stats->max_jitter_us = MAX(stats->max_jitter_us, jitter);
+	stats->max_read_time_us = MAX(stats->max_read_time_us, k_ticks_to_us_floor32(end - start));
+
+	last_deadlines[sensor] = next_deadlines[sensor];
+	next_deadlines[sensor] += interval;
+	// Skips deadlines that already passed, keeping the phase of the following ones
+	if (next_deadlines[sensor] <= end)
+	{
+		int64_t missed = (end - next_deadlines[sensor]) / interval + 1;
+		next_deadlines[sensor] += missed * interval;
+		stats->missed_deadlines += missed;
+		LOG_WRN("Sensor %d missed %d deadlines", sensor, (int)missed);
+	}
+}
+
+void schedule_sensors()
+{
+	int64_t now = k_uptime_ticks();
+
+	scheduled_sensors = 0;
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		if (sensor_apis[i] == NULL || sensor_apis[i]->read_sensor_values == NULL)
 		{
-			if (sensor_apis[i] != NULL)
-			{
-				sensor_apis[i]->read_sensor_values();
-			}
+			continue;
 		}
-		// Waits to measure again
-		k_sleep(K_MSEC(current_sampling_interval));
+		next_deadlines[i] = MAX(last_deadlines[i] + k_ms_to_ticks_ceil64(get_sensor_sampling_interval(i)),
+								now);
+		deadline_heap[scheduled_sensors++] = i;
 	}
+	heapify_events();
 }
 
-// Set the interval in milliseconds between samples
-void set_sampling_interval(int new_interval)
+bool start_due_measurements(int64_t now)
 {
+	bool started = false;
+
+	for (int i = 0; i < scheduled_sensors; i++)
+	{
+		enum SensorType sensor = deadline_heap[i];
+		if (measuring[sensor] || sensor_apis[sensor]->start_measurement == NULL ||
+			next_deadlines[sensor] > now)
+		{
+			continue;
+		}
+		start_times[sensor] = k_uptime_ticks();
+		int conversion_time = sensor_apis[sensor]->start_measurement();
+		// Sensor is read synchronously instead
+		if (conversion_time < 0)
+		{
+			continue;
+		}
+		ready_times[sensor] = start_times[sensor] + k_ms_to_ticks_ceil64(conversion_time);
+		measuring[sensor] = true;
+		started = true;
+	}
+	return started;
+}
+
+int64_t get_event_time(enum SensorType sensor)
+{
+	return measuring[sensor] ? ready_times[sensor] : next_deadlines[sensor];
+}
+
+void heapify_events()
+{
+	for (int i = scheduled_sensors / 2 - 1; i >= 0; i--)
+	{
+		sift_down_deadline(i);
+	}
+}
+
+void sift_down_deadline(int position)
+{
+	while (true)
+	{
+		int earliest = position;
+		int left = 2 * position + 1, right = 2 * position + 2;
+
+		if (left < scheduled_sensors &&
+			get_event_time(deadline_heap[left]) < get_event_time(deadline_heap[earliest]))
+		{
+			earliest = left;
+		}
+		if (right < scheduled_sensors &&
+			get_event_time(deadline_heap[right]) < get_event_time(deadline_heap[earliest]))
+		{
+			earliest = right;
+		}
+		if (earliest == position)
+		{
+			return;
+		}
+		uint8_t swapped = deadline_heap[position];
+		deadline_heap[position] = deadline_heap[earliest];
+		deadline_heap[earliest] = swapped;
+		position = earliest;
+	}
+}
+
+void reschedule_sensors()
+{
+	atomic_set(&schedule_changed, 1);
+	// Thread may be waiting until a deadline computed with the old interval
+	k_sem_give(&schedule_sem);
+}
+
+// Set the interval in milliseconds between samples of every sensor
+int set_sampling_interval(int new_interval)
+{
+	if (new_interval <= 0)
+	{
+		return -EINVAL;
+	}
+	k_spinlock_key_t key = k_spin_lock(&intervals_lock);
 	current_sampling_interval = new_interval;
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		sensor_sampling_intervals[i] = new_interval;
+	}
+	k_spin_unlock(&intervals_lock, key);
+	// Sensors may talk to the device to apply it, so it's done out of the lock
+	for (int i = 0; i < MAX_SENSORS; i++)
+	{
+		update_sensor_interval(i);
+	}
+	reschedule_sensors();
 	LOG_DBG("Sampling interval set to %dms", new_interval);
+	return 0;
 }
 
 // Get the interval in milliseconds between samples
 int get_sampling_interval()
 {
-	return current_sampling_interval;
+	k_spinlock_key_t key = k_spin_lock(&intervals_lock);
+	int interval = current_sampling_interval;
+	k_spin_unlock(&intervals_lock, key);
+	return interval;
+}
+
+int set_sensor_sampling_interval(enum SensorType sensor, int new_interval)
+{
+	if (sensor >= MAX_SENSORS || new_interval <= 0)
+	{
+		return -EINVAL;
+	}
+	k_spinlock_key_t key = k_spin_lock(&intervals_lock);
+	sensor_sampling_intervals[sensor] = new_interval;
+	k_spin_unlock(&intervals_lock, key);
+	reschedule_sensors();
+	LOG_DBG("Sampling interval of sensor %d set to %dms", sensor, new_interval);
+	return update_sensor_interval(sensor);
+}
+
+int update_sensor_interval(enum SensorType sensor)
+{
+	if (sensor_apis[sensor] == NULL || sensor_apis[sensor]->set_sampling_interval == NULL)
+	{
+		return 0;
+	}
+	int error = sensor_apis[sensor]->set_sampling_interval(get_sensor_sampling_interval(sensor));
+	if (error)
+	{
+		LOG_ERR("Failed to set sampling interval of sensor %d: %d", sensor, error);
+	}
+	return error;
+}
+
+int get_sensor_sampling_interval(enum SensorType sensor)
+{
+	if (sensor >= MAX_SENSORS)
+	{
+		return -EINVAL;
+	}
+	k_spinlock_key_t key = k_spin_lock(&intervals_lock);
+	int interval = sensor_sampling_intervals[sensor];
+	k_spin_unlock(&intervals_lock, key);
+	return interval;
+}
+
+int get_sampling_stats(enum SensorType sensor, SamplingStats *stats)
+{
+	if (sensor >= MAX_SENSORS || sensor_apis[sensor] == NULL)
+	{
+		return -ENODEV;
+	}
+	*stats = sampling_stats[sensor];
+	return 0;
+}
+
+int32_t sensor_value_to_fixed32(const struct sensor_value *value, int32_t scale)
+{
+	int64_t fractional = (int64_t)value->val2 * scale;
+	// Rounds to the nearest unit, away from zero on ties
+	fractional += fractional < 0 ? -500000 : 500000;
+	int64_t fixed = (int64_t)value->val1 * scale + fractional / 1000000;
+	return CLAMP(fixed, INT32_MIN, INT32_MAX);
+}
+
+int16_t sensor_value_to_fixed16(const struct sensor_value *value, int32_t scale)
+{
+	return CLAMP(sensor_value_to_fixed32(value, scale), INT16_MIN, INT16_MAX);
+}
+
+uint16_t sensor_value_to_ufixed16(const struct sensor_value *value, int32_t scale)
+{
+	return CLAMP(sensor_value_to_fixed32(value, scale), 0, UINT16_MAX);
+}
+
+void fixed_to_sensor_value(int32_t fixed, int32_t scale, struct sensor_value *value)
+{
+	// Both parts keep the sign of the value, as in the sensor drivers
+	value->val1 = fixed / scale;
+	value->val2 = fixed % scale * (1000000 / scale);
 }
\ No newline at end of file
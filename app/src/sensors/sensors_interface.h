@@ -1,6 +1,7 @@
 #ifndef SENSORS_INTERFACE_H
 #define SENSORS_INTERFACE_H
 
+#include <zephyr/drivers/sensor.h>
 #include <integration/data_abstraction/abstraction_service.h>
 
 /*
@@ -28,12 +29,34 @@ typedef struct
 {
 	// Initializes sensor
 	int (*init_sensor)();
-	// Reads sensor values and stores them in buffer
+	// Optional. Starts a conversion without waiting for it, returning the time in
+	// milliseconds until read_sensor_values can collect it, or an error if the sensor
+	// must be read synchronously. Conversions overlap with the reading of other sensors
+	int (*start_measurement)();
+	// Reads sensor values and stores them in buffer. NULL for sensors
+	// that measure by themselves and store readings when they are ready
 	void (*read_sensor_values)();
+	// Optional. Sets the interval in milliseconds of sensors that measure by
+	// themselves, as they aren't scheduled by the sampling thread
+	int (*set_sampling_interval)(int interval);
 	// Data processing API
 	DataAPI *data_model_api;
 } SensorAPI;
 
+// Metrics of how close to their deadlines the readings of a sensor started
+typedef struct
+{
+	// Readings performed since boot
+	uint32_t readings;
+	// Deadlines skipped because a reading was late by a whole interval
+	uint32_t missed_deadlines;
+	// Delay from deadline to start of reading, in microseconds
+	uint32_t max_jitter_us;
+	uint64_t total_jitter_us;
+	// Longest time spent reading, in microseconds
+	uint32_t max_read_time_us;
+} SamplingStats;
+
 // List of registered sensor APIs
 extern SensorAPI *sensor_apis[MAX_SENSORS];
 
@@ -41,10 +64,27 @@ extern SensorAPI *sensor_apis[MAX_SENSORS];
 int register_sensors_callbacks();
 // Initializes sensors and start reading them
 int read_sensors();
-// #TODO: probably will require sync
-// Set the interval in milliseconds between samples
-void set_sampling_interval(int new_interval);
-// Get the interval in milliseconds between samples
+// Set the interval in milliseconds between samples of every sensor
+int set_sampling_interval(int new_interval);
+// Get the default interval in milliseconds between samples
 int get_sampling_interval();
+// Set the interval in milliseconds between samples of a sensor,
+// counted from the deadline of its last reading
+int set_sensor_sampling_interval(enum SensorType sensor, int new_interval);
+// Get the interval in milliseconds between samples of a sensor
+int get_sensor_sampling_interval(enum SensorType sensor);
+// Gets how late the readings of a sensor were. Returns -ENODEV if it isn't registered
+int get_sampling_stats(enum SensorType sensor, SamplingStats *stats);
+
+// Sensor models store measurements as fixed-point integers in units of 1/scale,
+// instead of sensor values, so the buffer holds more readings.
+// Scales must divide 1000000, the fractional unit of sensor values
+
+// Converts sensor value to fixed-point, saturating at the limits of the type
+int32_t sensor_value_to_fixed32(const struct sensor_value *value, int32_t scale);
+int16_t sensor_value_to_fixed16(const struct sensor_value *value, int32_t scale);
+uint16_t sensor_value_to_ufixed16(const struct sensor_value *value, int32_t scale);
+// Converts fixed-point value back to sensor value, when encoding data
+void fixed_to_sensor_value(int32_t fixed, int32_t scale, struct sensor_value *value);
 
 #endif /* SENSORS_INTERFACE_H */
\ No newline at end of file
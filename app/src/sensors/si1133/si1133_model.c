@@ -1,5 +1,7 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/si1133/si1133_service.h>
+#include <integration/data_abstraction/text_format/text_format.h>
 
 LOG_MODULE_REGISTER(si1133_model, CONFIG_APP_LOG_LEVEL);
 
@@ -18,17 +20,22 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Timestamp: %d; Light: %d lux; Infrared: %d lux; UV: %d; "
-                    "UVIndex: %d.%02d;",
-                    si1133_model->timestamp,
-                    si1133_model->light.val1,
-                    si1133_model->infrared.val1,
-                    si1133_model->uv.val1,
-                    si1133_model->uv_index.val1,
-                    si1133_model->uv_index.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, si1133_model->timestamp);
+    text_append(&text, "; Light: ");
+    text_append_fixed(&text, si1133_model->light, SI1133_LIGHT_SCALE, 0);
+    text_append(&text, " lux; Infrared: ");
+    text_append_fixed(&text, si1133_model->infrared, SI1133_INFRARED_SCALE, 0);
+    text_append(&text, " lux; UV: ");
+    text_append_fixed(&text, si1133_model->uv, SI1133_UV_SCALE, 0);
+    text_append(&text, "; UVIndex: ");
+    text_append_fixed(&text, si1133_model->uv_index, SI1133_UV_INDEX_SCALE, 2);
+    text_append_char(&text, ';');
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a minimalist string
@@ -36,33 +43,74 @@ static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t
 {
     // Converts words into the model
     SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dL%dIR%dUV%dI%d.%02d",
-                    si1133_model->timestamp,
-                    si1133_model->light.val1,
-                    si1133_model->infrared.val1,
-                    si1133_model->uv.val1,
-                    si1133_model->uv_index.val1,
-                    si1133_model->uv_index.val2 / 10000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, si1133_model->timestamp);
+    text_append_char(&text, 'L');
+    text_append_fixed(&text, si1133_model->light, SI1133_LIGHT_SCALE, 0);
+    text_append(&text, "IR");
+    text_append_fixed(&text, si1133_model->infrared, SI1133_INFRARED_SCALE, 0);
+    text_append(&text, "UV");
+    text_append_fixed(&text, si1133_model->uv, SI1133_UV_SCALE, 0);
+    text_append_char(&text, 'I');
+    text_append_fixed(&text, si1133_model->uv_index, SI1133_UV_INDEX_SCALE, 2);
+    return text_finish(&text);
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
 {
-    // Converts words into bytes
-    bytecpy(encoded_data, data_words, encoded_size);
+    // Copies the packed fixed-point model as it is stored
+    bytecpy(encoded_data, data_words, MIN(encoded_size, sizeof(SensorModelSi1133)));
 
     return sizeof(SensorModelSi1133);
 }
 
+// Encodes data model into a binary frame with light and infrared in 3 bytes,
+// UV and UV index in 2 bytes each
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+    int header_size = encode_packed_header(SI1133_MODEL, si1133_model->timestamp, 10,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    sys_put_le24(si1133_model->light, &encoded_data[header_size]);
+    sys_put_le24(si1133_model->infrared, &encoded_data[header_size + 3]);
+    sys_put_le16(si1133_model->uv, &encoded_data[header_size + 6]);
+    sys_put_le16(si1133_model->uv_index, &encoded_data[header_size + 8]);
+
+    return header_size + 10;
+}
+
+// Gets the measurements of the data model in the order of its binary frame
+static int get_fields(uint32_t *data_words, int32_t *fields)
+{
+    SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+
+    fields[0] = si1133_model->light;
+    fields[1] = si1133_model->infrared;
+    fields[2] = si1133_model->uv;
+    fields[3] = si1133_model->uv_index;
+
+    return 4;
+}
+
 // Registers Si1133 model callbacks
 DataAPI *register_si1133_model_callbacks()
 {
     si1133_model_api.num_data_words = SI1133_MODEL_WORDS;
+    si1133_model_api.retention_class = RETENTION_NORMAL;
     si1133_model_api.encode_verbose = encode_verbose;
     si1133_model_api.encode_minimalist = encode_minimalist;
     si1133_model_api.encode_raw_bytes = encode_raw_bytes;
+    si1133_model_api.encode_packed_binary = encode_packed_binary;
+    si1133_model_api.get_fields = get_fields;
     // si1133_model_api.split_values = split_values;
     return &si1133_model_api;
 }
\ No newline at end of file
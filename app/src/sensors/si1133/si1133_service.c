@@ -1,4 +1,5 @@
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
@@ -14,6 +15,20 @@ LOG_MODULE_REGISTER(si1133_service, CONFIG_APP_LOG_LEVEL);
 static const struct device *si1133;
 static SensorAPI si1133_api = {0};
 
+#ifdef CONFIG_SI1133_TRIGGER
+static const struct sensor_trigger data_ready_trigger = {
+    .type = SENSOR_TRIG_DATA_READY,
+    .chan = SENSOR_CHAN_ALL,
+};
+
+// Starts autonomous measurements of the sensor every `interval` milliseconds
+static int set_autonomous_interval(int interval);
+// Stores each autonomous measurement, called from the system workqueue
+static void data_ready_handler(const struct device *dev, const struct sensor_trigger *trigger);
+#endif /* CONFIG_SI1133_TRIGGER */
+// Reads sensor measurements, or collects the started conversion, and stores them in buffer
+static void read_sensor_values();
+
 /**
  * IMPLEMENTATIONS
  */
@@ -35,37 +50,85 @@ static int init_sensor()
         LOG_ERR("device \"%s\" is not ready", si1133->name);
         return -EAGAIN;
     }
+#ifdef CONFIG_SI1133_TRIGGER
+    int error = sensor_trigger_set(si1133, &data_ready_trigger, data_ready_handler);
+    if (error)
+    {
+        LOG_ERR("Failed to set data ready trigger of \"%s\": %d", si1133->name, error);
+        return error;
+    }
+    return set_autonomous_interval(get_sensor_sampling_interval(SI1133));
+#else
     return 0;
+#endif /* CONFIG_SI1133_TRIGGER */
+}
+
+#ifdef CONFIG_SI1133_TRIGGER
+int set_autonomous_interval(int interval)
+{
+    // Frequency in Hz, with the fractional part in millionths
+    struct sensor_value frequency = {
+        .val1 = MSEC_PER_SEC / interval,
+        .val2 = (int32_t)((USEC_PER_SEC * (uint64_t)MSEC_PER_SEC / interval) % USEC_PER_SEC),
+    };
+
+    return sensor_attr_set(si1133, SENSOR_CHAN_ALL, SENSOR_ATTR_SAMPLING_FREQUENCY, &frequency);
+}
+
+void data_ready_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(trigger);
+    read_sensor_values();
+}
+#else
+// Starts a conversion, collected later by read_sensor_values,
+// so the other sensors are read meanwhile
+static int start_measurement()
+{
+    int error = si1133_start_measurement(si1133);
+    if (error)
+    {
+        LOG_ERR("start measurement on \"%s\" failed: %d", si1133->name, error);
+        return error;
+    }
+    return SI1133_CONVERSION_TIME_MS;
 }
+#endif /* CONFIG_SI1133_TRIGGER */
 
-// Reads sensor measurements and stores them in buffer
-static void read_sensor_values()
+void read_sensor_values()
 {
     LOG_DBG("Reading Si1133");
 
-    SensorModelSi1133 si1133_model;
-    uint32_t si1133_data[MAX_32_WORDS];
+    BufferReservation reservation;
+    SensorModelSi1133 *si1133_model;
+    struct sensor_value light, infrared, uv, uv_index;
     int error = 0;
 
 sample_fetch:
     error = sensor_sample_fetch(si1133);
     if (!error)
     {
-        sensor_channel_get(si1133, SENSOR_CHAN_LIGHT,
-                           &si1133_model.light);
-        sensor_channel_get(si1133, SENSOR_CHAN_IR,
-                           &si1133_model.infrared);
-        sensor_channel_get(si1133, SENSOR_CHAN_UV,
-                           &si1133_model.uv);
-        sensor_channel_get(si1133, SENSOR_CHAN_UVI,
-                           &si1133_model.uv_index);
+        sensor_channel_get(si1133, SENSOR_CHAN_LIGHT, &light);
+        sensor_channel_get(si1133, SENSOR_CHAN_IR, &infrared);
+        sensor_channel_get(si1133, SENSOR_CHAN_UV, &uv);
+        sensor_channel_get(si1133, SENSOR_CHAN_UVI, &uv_index);
+
+        // Model is written in place in the application buffer
+        error = reserve_app_buffer_item(&reservation, SI1133_MODEL, 0, SI1133_MODEL_WORDS);
+        if (!error)
+        {
+            si1133_model = (SensorModelSi1133 *)reservation.data_words;
+            si1133_model->light = sensor_value_to_fixed32(&light, SI1133_LIGHT_SCALE);
+            si1133_model->infrared = sensor_value_to_fixed32(&infrared, SI1133_INFRARED_SCALE);
+            si1133_model->uv = sensor_value_to_ufixed16(&uv, SI1133_UV_SCALE);
+            si1133_model->uv_index = sensor_value_to_ufixed16(&uv_index, SI1133_UV_INDEX_SCALE);
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-        si1133_model.timestamp = get_current_timestamp();
+            si1133_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-
-        memcpy(&si1133_data, &si1133_model, sizeof(SensorModelSi1133));
-
-        if (insert_in_buffer(&app_buffer, si1133_data, SI1133_MODEL, error, SI1133_MODEL_WORDS) != 0)
+            error = commit_sensor_data(&reservation);
+        }
+        if (error)
         {
             LOG_ERR("Failed to insert data in ring buffer.");
         }
@@ -88,7 +151,13 @@ SensorAPI *register_si1133_callbacks()
 {
     LOG_DBG("Registering Si1133 callbacks");
     si1133_api.init_sensor = init_sensor;
+#ifdef CONFIG_SI1133_TRIGGER
+    // Sensor measures by itself and stores readings from its trigger
+    si1133_api.set_sampling_interval = set_autonomous_interval;
+#else
+    si1133_api.start_measurement = start_measurement;
     si1133_api.read_sensor_values = read_sensor_values;
+#endif /* CONFIG_SI1133_TRIGGER */
     si1133_api.data_model_api = register_si1133_model_callbacks();
     return &si1133_api;
 }
\ No newline at end of file
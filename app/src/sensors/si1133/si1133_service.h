@@ -5,17 +5,28 @@
 #include <sensors/sensors_interface.h>
 #include <integration/data_buffer/buffer_service.h>
 
+// Fixed-point scales of the measurements
+#define SI1133_LIGHT_SCALE 1      // 1 lux
+#define SI1133_INFRARED_SCALE 1   // 1 lux
+#define SI1133_UV_SCALE 1         // 1 count
+#define SI1133_UV_INDEX_SCALE 100 // 0.01
+
+// Time for the sensor to convert the three channels, dominated by the
+// UV channel, which integrates 512 times for 24.4 us with its gain
+#define SI1133_CONVERSION_TIME_MS 15
+
 typedef struct
 {
-    struct sensor_value light;
-    struct sensor_value infrared;
-    struct sensor_value uv;
-    struct sensor_value uv_index;
     uint32_t timestamp;
+    // Light channels are 24-bit wide
+    int32_t light;
+    int32_t infrared;
+    uint16_t uv;
+    uint16_t uv_index;
 } SensorModelSi1133;
 
 // Number of 32-bit words in each data item (model)
-// Each sensor_value has 2 words, si1133 has 4 measurements
+// Light and infrared take one word each, UV and UV index share another
 #define SI1133_MODEL_WORDS SIZE_BYTES_TO_32_BIT_WORDS(sizeof(SensorModelSi1133))
 
 // Registers Si1133 model callbacks
@@ -1,5 +1,7 @@
 #include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
 #include <sensors/vbatt/vbatt_service.h>
+#include <integration/data_abstraction/text_format/text_format.h>
 
 LOG_MODULE_REGISTER(vbatt_model, CONFIG_APP_LOG_LEVEL);
 
@@ -9,6 +11,9 @@ LOG_MODULE_REGISTER(vbatt_model, CONFIG_APP_LOG_LEVEL);
 
 static DataAPI vbatt_model_api;
 
+// Fixed-point scale of the voltage written by the encoders, in millivolts
+#define VBATT_MILLIVOLT_SCALE 1000
+
 /**
  * IMPLEMENTATIONS
  */
@@ -18,13 +23,17 @@ static int encode_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t en
 {
     // Converts words into the model
     SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+    int32_t millivolts = vbatt_model->voltage.val1 * 1000 + vbatt_model->voltage.val2 / 1000;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "Timestamp: %d; Voltage: %d.%03d V;",
-                    vbatt_model->timestamp,
-                    vbatt_model->voltage.val1,
-                    vbatt_model->voltage.val2 / 1000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "Timestamp: ");
+    text_append_uint(&text, vbatt_model->timestamp);
+    text_append(&text, "; Voltage: ");
+    text_append_fixed(&text, millivolts, VBATT_MILLIVOLT_SCALE, 3);
+    text_append(&text, " V;");
+    return text_finish(&text);
 }
 
 // Encodes all values of data model into a minimal string
@@ -32,13 +41,16 @@ static int encode_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t
 {
     // Converts words into the model
     SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+    int32_t millivolts = vbatt_model->voltage.val1 * 1000 + vbatt_model->voltage.val2 / 1000;
+    TextWriter text;
 
     // Formats the string
-    return snprintf(encoded_data, encoded_size,
-                    "TS%dmV%d",
-                    vbatt_model->timestamp,
-                    vbatt_model->voltage.val1 * 1000 +
-                        vbatt_model->voltage.val2 / 1000);
+    text_init(&text, encoded_data, encoded_size);
+    text_append(&text, "TS");
+    text_append_uint(&text, vbatt_model->timestamp);
+    text_append(&text, "mV");
+    text_append_int(&text, millivolts);
+    return text_finish(&text);
 }
 
 static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
@@ -49,13 +61,42 @@ static int encode_raw_bytes(uint32_t *data_words, uint8_t *encoded_data, size_t
     return sizeof(SensorModelVbatt);
 }
 
+// Encodes data model into a binary frame with voltage in mV in 2 bytes
+static int encode_packed_binary(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+    int header_size = encode_packed_header(VBATT_MODEL, vbatt_model->timestamp, 2,
+                                           encoded_data, encoded_size);
+    if (header_size < 0)
+    {
+        return header_size;
+    }
+
+    sys_put_le16(sensor_value_to_milli(&vbatt_model->voltage), &encoded_data[header_size]);
+
+    return header_size + 2;
+}
+
+// Gets the measurements of the data model in the order of its binary frame
+static int get_fields(uint32_t *data_words, int32_t *fields)
+{
+    SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+
+    fields[0] = sensor_value_to_milli(&vbatt_model->voltage);
+
+    return 1;
+}
+
 // Registers vbatt model callbacks
 DataAPI *register_vbatt_model_callbacks()
 {
     vbatt_model_api.num_data_words = VBATT_MODEL_WORDS;
+    vbatt_model_api.retention_class = RETENTION_CRITICAL;
     vbatt_model_api.encode_verbose = encode_verbose;
     vbatt_model_api.encode_minimalist = encode_minimalist;
     vbatt_model_api.encode_raw_bytes = encode_raw_bytes;
+    vbatt_model_api.encode_packed_binary = encode_packed_binary;
+    vbatt_model_api.get_fields = get_fields;
     // vbatt_model_api.split_values = split_values;
     return &vbatt_model_api;
 }
\ No newline at end of file
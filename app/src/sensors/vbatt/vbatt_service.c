@@ -1,6 +1,7 @@
 #include <zephyr/logging/log.h>
 #include <sensors/vbatt/vbatt_service.h>
 #include <integration/timestamp/timestamp_service.h>
+#include <integration/data_aggregation/aggregation_service.h>
 
 LOG_MODULE_REGISTER(vbatt_service, CONFIG_APP_LOG_LEVEL);
 
@@ -54,8 +55,9 @@ static void read_sensor_values()
 {
     LOG_DBG("Reading %s", divider->name);
 
-    SensorModelVbatt vbatt_model = {0};
-    uint32_t vbatt_data[MAX_32_WORDS];
+    BufferReservation reservation;
+    SensorModelVbatt *vbatt_model;
+    struct sensor_value voltage;
 
     // Fetch measurements to driver
     int error = sensor_sample_fetch(divider);
@@ -71,26 +73,31 @@ static void read_sensor_values()
     }
 
     // Get voltage from driver
-    error = sensor_channel_get(divider, SENSOR_CHAN_VOLTAGE, &vbatt_model.voltage);
+    error = sensor_channel_get(divider, SENSOR_CHAN_VOLTAGE, &voltage);
     if (error)
     {
         LOG_ERR("getting sample from \"%s\" failed: %d", divider->name, error);
         return;
     }
 
+    // Load battery data to application buffer, writing the model in place
+    error = reserve_app_buffer_item(&reservation, VBATT_MODEL, 0, VBATT_MODEL_WORDS);
+    if (!error)
+    {
+        vbatt_model = (SensorModelVbatt *)reservation.data_words;
+        vbatt_model->voltage = voltage;
 #ifndef CONFIG_EVENT_TIMESTAMP_NONE
-    vbatt_model.timestamp = get_current_timestamp();
+        vbatt_model->timestamp = get_current_timestamp();
 #endif /* CONFIG_EVENT_TIMESTAMP_NONE */
-
-    // Load battery data to application buffer
-    memcpy(&vbatt_data, &vbatt_model, sizeof(SensorModelVbatt));
-    if (insert_in_buffer(&app_buffer, vbatt_data, VBATT_MODEL, 0, VBATT_MODEL_WORDS) != 0)
+        error = commit_sensor_data(&reservation);
+    }
+    if (error)
     {
         LOG_ERR("Failed to insert data in ring buffer.");
     }
 
     // low-battery trigger
-    int16_t value = (int16_t)sensor_value_to_milli(&vbatt_model.voltage);
+    int16_t value = (int16_t)sensor_value_to_milli(&voltage);
     if (value < CONFIG_LOW_BATT_THRESH && !k_work_is_pending(&low_battery_work))
     {
         struct battery_trigger_info low_battery = {
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT quectel_l86
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(emul_quectel_l86, CONFIG_GNSS_LOG_LEVEL);
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) == 1,
+	     "NMEA replay supports a single L86 module");
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(DT_INST_BUS(0), zephyr_uart_emul),
+	     "NMEA replay needs the L86 module on an emulated UART");
+
+#define EMUL_QUECTEL_L86_COMMAND_SIZE 96
+#define EMUL_QUECTEL_L86_DEFAULT_FIX_INTERVAL_MS 1000
+
+/*
+ * Recorded fixes of a module walking on a campus, one epoch per fix
+ * interval, replayed in a loop. Satellites are reported with every epoch.
+ */
+static const char *const emul_quectel_l86_recording[] = {
+	"$GPGGA,120000.000,2333.6720,S,04644.1420,W,1,08,0.95,745.0,M,-5.6,M,,*7B\r\n"
+	"$GPRMC,120000.000,A,2333.6720,S,04644.1420,W,0.12,54.70,151024,,,A*53\r\n",
+	"$GPGGA,120001.000,2333.6732,S,04644.1438,W,1,08,0.95,745.1,M,-5.6,M,,*71\r\n"
+	"$GPRMC,120001.000,A,2333.6732,S,04644.1438,W,0.12,54.70,151024,,,A*58\r\n",
+	"$GPGGA,120002.000,2333.6744,S,04644.1456,W,1,08,0.95,745.2,M,-5.6,M,,*78\r\n"
+	"$GPRMC,120002.000,A,2333.6744,S,04644.1456,W,0.12,54.70,151024,,,A*52\r\n",
+	"$GPGGA,120003.000,2333.6756,S,04644.1474,W,1,08,0.95,745.3,M,-5.6,M,,*7B\r\n"
+	"$GPRMC,120003.000,A,2333.6756,S,04644.1474,W,0.12,54.70,151024,,,A*50\r\n",
+	"$GPGGA,120004.000,2333.6768,S,04644.1492,W,1,08,0.95,745.4,M,-5.6,M,,*7E\r\n"
+	"$GPRMC,120004.000,A,2333.6768,S,04644.1492,W,0.12,54.70,151024,,,A*52\r\n",
+	"$GPGGA,120005.000,2333.6780,S,04644.1510,W,1,08,0.95,745.5,M,-5.6,M,,*73\r\n"
+	"$GPRMC,120005.000,A,2333.6780,S,04644.1510,W,0.12,54.70,151024,,,A*5E\r\n",
+	"$GPGGA,120006.000,2333.6792,S,04644.1528,W,1,08,0.95,745.6,M,-5.6,M,,*7B\r\n"
+	"$GPRMC,120006.000,A,2333.6792,S,04644.1528,W,0.12,54.70,151024,,,A*55\r\n",
+	"$GPGGA,120007.000,2333.6804,S,04644.1546,W,1,08,0.95,745.7,M,-5.6,M,,*73\r\n"
+	"$GPRMC,120007.000,A,2333.6804,S,04644.1546,W,0.12,54.70,151024,,,A*5C\r\n",
+	"$GPGGA,120008.000,2333.6816,S,04644.1564,W,1,08,0.95,745.8,M,-5.6,M,,*70\r\n"
+	"$GPRMC,120008.000,A,2333.6816,S,04644.1564,W,0.12,54.70,151024,,,A*50\r\n",
+	"$GPGGA,120009.000,2333.6828,S,04644.1582,W,1,08,0.95,745.9,M,-5.6,M,,*75\r\n"
+	"$GPRMC,120009.000,A,2333.6828,S,04644.1582,W,0.12,54.70,151024,,,A*54\r\n",
+};
+
+static const char emul_quectel_l86_satellites[] =
+	"$GPGSV,2,1,08,02,74,042,45,04,18,190,36,07,67,279,42,08,12,323,38*7A\r\n"
+	"$GPGSV,2,2,08,09,40,115,44,16,21,061,33,21,08,152,30,27,55,229,41*7D\r\n";
+
+struct emul_quectel_l86_data {
+	const struct device *uart;
+	// Parses the PMTK commands written by the driver, out of the UART context
+	struct k_work command_work;
+	// Sends the next recorded epoch every fix interval, while the module runs
+	struct k_work_delayable fix_work;
+	uint32_t fix_interval_ms;
+	size_t epoch;
+	char command[EMUL_QUECTEL_L86_COMMAND_SIZE];
+	size_t command_len;
+};
+
+static struct emul_quectel_l86_data emul_quectel_l86_data;
+
+static void emul_quectel_l86_send(struct emul_quectel_l86_data *data, const char *text)
+{
+	size_t len = strlen(text);
+
+	if (uart_emul_put_rx_data(data->uart, (const uint8_t *)text, len) != len) {
+		LOG_WRN("UART RX FIFO full, NMEA output truncated");
+	}
+}
+
+// Sends a sentence with its checksum, the XOR of the characters between $ and *
+static void emul_quectel_l86_send_sentence(struct emul_quectel_l86_data *data,
+					   const char *body)
+{
+	char sentence[EMUL_QUECTEL_L86_COMMAND_SIZE];
+	uint8_t checksum = 0;
+
+	for (const char *c = body; *c != '\0'; c++) {
+		checksum ^= *c;
+	}
+	snprintf(sentence, sizeof(sentence), "$%s*%02X\r\n", body, checksum);
+	emul_quectel_l86_send(data, sentence);
+}
+
+static void emul_quectel_l86_fix_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct emul_quectel_l86_data *data =
+		CONTAINER_OF(dwork, struct emul_quectel_l86_data, fix_work);
+
+	emul_quectel_l86_send(data, emul_quectel_l86_recording[data->epoch]);
+	emul_quectel_l86_send(data, emul_quectel_l86_satellites);
+	data->epoch = (data->epoch + 1) % ARRAY_SIZE(emul_quectel_l86_recording);
+	k_work_schedule(dwork, K_MSEC(data->fix_interval_ms));
+}
+
+/*
+ * Acknowledges a PMTK command as the driver expects. Commands that set
+ * values are acknowledged with them, and the module starts and stops
+ * sending fixes when it is resumed and put in standby.
+ */
+static void emul_quectel_l86_handle_command(struct emul_quectel_l86_data *data, char *line)
+{
+	char ack[EMUL_QUECTEL_L86_COMMAND_SIZE];
+	char *args, *end;
+	int type;
+
+	if (strncmp(line, "$PMTK", 5) != 0) {
+		LOG_WRN("Ignored command %s", line);
+		return;
+	}
+	type = strtol(&line[5], &end, 10);
+	args = (*end == ',') ? end + 1 : "";
+	end = strchr(args, '*');
+	if (end != NULL) {
+		*end = '\0';
+	}
+
+	switch (type) {
+	case 10:
+		// Startup message, after which fixes are sent
+		snprintf(ack, sizeof(ack), "PMTK001,10,1");
+		k_work_reschedule(&data->fix_work, K_MSEC(data->fix_interval_ms));
+		break;
+	case 161:
+		snprintf(ack, sizeof(ack), "PMTK001,161,3");
+		k_work_cancel_delayable(&data->fix_work);
+		break;
+	case 220:
+		data->fix_interval_ms = MAX(strtoul(args, NULL, 10), 100);
+		snprintf(ack, sizeof(ack), "PMTK001,220,3,%s", args);
+		break;
+	case 353:
+		snprintf(ack, sizeof(ack), "PMTK001,353,3,%s", args);
+		break;
+	default:
+		snprintf(ack, sizeof(ack), "PMTK001,%d,3", type);
+		break;
+	}
+	emul_quectel_l86_send_sentence(data, ack);
+}
+
+static void emul_quectel_l86_command_handler(struct k_work *work)
+{
+	struct emul_quectel_l86_data *data =
+		CONTAINER_OF(work, struct emul_quectel_l86_data, command_work);
+	uint8_t byte;
+
+	while (uart_emul_get_tx_data(data->uart, &byte, 1) == 1) {
+		if (byte == '\r' || byte == '\n') {
+			if (data->command_len > 0) {
+				data->command[data->command_len] = '\0';
+				emul_quectel_l86_handle_command(data, data->command);
+			}
+			data->command_len = 0;
+		} else if (data->command_len < sizeof(data->command) - 1) {
+			data->command[data->command_len++] = byte;
+		}
+	}
+}
+
+static void emul_quectel_l86_tx_ready(const struct device *dev, size_t size, void *user_data)
+{
+	struct emul_quectel_l86_data *data = user_data;
+
+	ARG_UNUSED(dev);
+	ARG_UNUSED(size);
+
+	k_work_submit(&data->command_work);
+}
+
+static int emul_quectel_l86_init(void)
+{
+	struct emul_quectel_l86_data *data = &emul_quectel_l86_data;
+
+	data->uart = DEVICE_DT_GET(DT_INST_BUS(0));
+	data->fix_interval_ms = EMUL_QUECTEL_L86_DEFAULT_FIX_INTERVAL_MS;
+	k_work_init(&data->command_work, emul_quectel_l86_command_handler);
+	k_work_init_delayable(&data->fix_work, emul_quectel_l86_fix_handler);
+	uart_emul_callback_tx_data_ready_set(data->uart, emul_quectel_l86_tx_ready, data);
+	return 0;
+}
+
+SYS_INIT(emul_quectel_l86_init, POST_KERNEL, CONFIG_GNSS_INIT_PRIORITY);
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT bosch_bme280
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <drivers/emul_bme280.h>
+
+LOG_MODULE_REGISTER(EMUL_BME280, CONFIG_SENSOR_LOG_LEVEL);
+
+#define EMUL_BME280_REG_CALIB_TP		(0x88)
+#define EMUL_BME280_REG_CALIB_H1		(0xA1)
+#define EMUL_BME280_REG_ID				(0xD0)
+#define EMUL_BME280_REG_RESET			(0xE0)
+#define EMUL_BME280_REG_CALIB_H2		(0xE1)
+#define EMUL_BME280_REG_CTRL_HUM		(0xF2)
+#define EMUL_BME280_REG_CTRL_MEAS		(0xF4)
+#define EMUL_BME280_REG_CONFIG			(0xF5)
+#define EMUL_BME280_REG_PRESS			(0xF7)
+#define EMUL_BME280_REG_TEMP			(0xFA)
+#define EMUL_BME280_REG_HUM				(0xFD)
+#define EMUL_BME280_REG_DATA_END		(0xFE)
+
+#define EMUL_BME280_CHIP_ID				(0x60)
+#define EMUL_BME280_CMD_SOFT_RESET		(0xB6)
+
+/*
+ * Calibration chosen so the compensation formulas of the datasheet are
+ * easy to invert: the quadratic terms are 0, so temperature, pressure and
+ * humidity are linear on their ADC values.
+ */
+#define EMUL_BME280_DIG_T1				(26000)
+#define EMUL_BME280_DIG_T2				(8192)
+#define EMUL_BME280_DIG_P1				(32768)
+#define EMUL_BME280_DIG_H2				(256)
+
+// Temperatures the calibration above can encode, in hundredths of degree
+#define EMUL_BME280_MIN_TEMPERATURE		(-4000)
+#define EMUL_BME280_MAX_TEMPERATURE		(6000)
+
+// Around 25 °C, 1013 hPa and 50 %RH, slowly changing as indoors
+static const struct emul_waveform emul_bme280_default_waveforms[EMUL_BME280_CHANNELS] = {
+	[EMUL_BME280_TEMPERATURE] = { .offset = 2500, .amplitude = 150, .period_ms = 900000,
+	                              .noise = 2 },
+	[EMUL_BME280_PRESSURE] = { .offset = 101325, .amplitude = 100, .period_ms = 1800000,
+	                           .noise = 3 },
+	[EMUL_BME280_HUMIDITY] = { .offset = 5000, .amplitude = 500, .period_ms = 900000,
+	                           .noise = 20 },
+};
+
+struct emul_bme280_data {
+	struct emul_waveform waveforms[EMUL_BME280_CHANNELS];
+	uint32_t seed;
+	uint8_t regs[UINT8_MAX + 1];
+};
+
+static void emul_bme280_reset(struct emul_bme280_data *data)
+{
+	uint8_t *calib = &data->regs[EMUL_BME280_REG_CALIB_TP];
+
+	memset(data->regs, 0, sizeof(data->regs));
+	data->regs[EMUL_BME280_REG_ID] = EMUL_BME280_CHIP_ID;
+	// dig_T1, dig_T2 and dig_P1, the other coefficients are 0
+	sys_put_le16(EMUL_BME280_DIG_T1, &calib[0]);
+	sys_put_le16(EMUL_BME280_DIG_T2, &calib[2]);
+	sys_put_le16(EMUL_BME280_DIG_P1, &calib[6]);
+	sys_put_le16(EMUL_BME280_DIG_H2, &data->regs[EMUL_BME280_REG_CALIB_H2]);
+}
+
+// Writes 20-bit ADC values as MSB, LSB and the 4 bits of XLSB
+static void emul_bme280_put_adc20(uint8_t *regs, uint32_t adc)
+{
+	regs[0] = (adc >> 12) & 0xFF;
+	regs[1] = (adc >> 4) & 0xFF;
+	regs[2] = (adc & 0xF) << 4;
+}
+
+// Converts the waveforms to the ADC values that compensate to them
+static void emul_bme280_measure(struct emul_bme280_data *data)
+{
+	int64_t now = k_uptime_get();
+	int32_t temperature, pressure, humidity, t_fine;
+
+	temperature = emul_waveform_value(&data->waveforms[EMUL_BME280_TEMPERATURE], now,
+	                                  &data->seed);
+	pressure = emul_waveform_value(&data->waveforms[EMUL_BME280_PRESSURE], now, &data->seed);
+	humidity = emul_waveform_value(&data->waveforms[EMUL_BME280_HUMIDITY], now, &data->seed);
+
+	// Temperature is (t_fine * 5 + 128) >> 8, with t_fine = ((adc >> 3) - 2 * T1) * T2 >> 11
+	temperature = CLAMP(temperature, EMUL_BME280_MIN_TEMPERATURE, EMUL_BME280_MAX_TEMPERATURE);
+	t_fine = temperature * 256 / 5;
+	emul_bme280_put_adc20(&data->regs[EMUL_BME280_REG_TEMP],
+	                      (t_fine / (EMUL_BME280_DIG_T2 >> 11) + 2 * EMUL_BME280_DIG_T1) << 3);
+
+	// Pressure in Pa is (2^20 - adc) * 3125 * 2^31 / (P1 * 2^14) / 2^16
+	pressure = CLAMP(pressure, 0, 200000);
+	emul_bme280_put_adc20(&data->regs[EMUL_BME280_REG_PRESS],
+	                      BIT(20) - (uint32_t)((int64_t)pressure * 65536 / 12500));
+
+	// Humidity in %RH is adc * H2 * 2^7 / 2^22, so adc / 256
+	humidity = CLAMP(humidity, 0, 10000);
+	sys_put_be16(humidity * 256 / 100, &data->regs[EMUL_BME280_REG_HUM]);
+}
+
+static int emul_bme280_transfer(const struct emul *target, struct i2c_msg *msgs,
+                                int num_msgs, int addr)
+{
+	struct emul_bme280_data *data = target->data;
+	uint8_t reg;
+
+	ARG_UNUSED(addr);
+
+	// Transfers start with the register address, followed by the values
+	// written to it or by a read from it, maybe in separate messages
+	if (num_msgs < 1 || (msgs[0].flags & I2C_MSG_READ) || msgs[0].len < 1) {
+		return -EIO;
+	}
+	reg = msgs[0].buf[0];
+
+	for (int i = 0; i < num_msgs; i++) {
+		uint8_t *buf = msgs[i].buf;
+		uint32_t len = msgs[i].len;
+
+		if (i == 0) {
+			buf++;
+			len--;
+		}
+		if (reg + len > sizeof(data->regs)) {
+			return -EIO;
+		}
+		if (msgs[i].flags & I2C_MSG_READ) {
+			// Every read of the outputs sees a new conversion
+			if (reg <= EMUL_BME280_REG_DATA_END && EMUL_BME280_REG_PRESS < reg + len) {
+				emul_bme280_measure(data);
+			}
+			memcpy(buf, &data->regs[reg], len);
+			continue;
+		}
+		// Control registers are written one at a time, with the address
+		// of each one before its value
+		for (uint32_t j = 0; j < len; j++) {
+			if (reg == EMUL_BME280_REG_RESET) {
+				if (buf[j] == EMUL_BME280_CMD_SOFT_RESET) {
+					emul_bme280_reset(data);
+				}
+			} else if (reg == EMUL_BME280_REG_CTRL_HUM || reg == EMUL_BME280_REG_CTRL_MEAS ||
+			           reg == EMUL_BME280_REG_CONFIG) {
+				data->regs[reg] = buf[j];
+			} else {
+				LOG_WRN("Write to read-only register 0x%02x", reg);
+			}
+			if (j + 1 < len) {
+				reg = buf[++j];
+			}
+		}
+	}
+	return 0;
+}
+
+int emul_bme280_set_waveform(const struct emul *target, enum emul_bme280_channel channel,
+                             const struct emul_waveform *waveform)
+{
+	struct emul_bme280_data *data = target->data;
+
+	if (channel >= EMUL_BME280_CHANNELS || waveform == NULL) {
+		return -EINVAL;
+	}
+	data->waveforms[channel] = *waveform;
+	return 0;
+}
+
+static const struct i2c_emul_api emul_bme280_api = {
+	.transfer = emul_bme280_transfer,
+};
+
+static int emul_bme280_init(const struct emul *target, const struct device *parent)
+{
+	struct emul_bme280_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->seed = (uint32_t)(uintptr_t)target;
+	memcpy(data->waveforms, emul_bme280_default_waveforms, sizeof(data->waveforms));
+	emul_bme280_reset(data);
+	return 0;
+}
+
+#define EMUL_BME280_DEFINE(inst) \
+	static struct emul_bme280_data emul_bme280_data_##inst; \
+	EMUL_DT_INST_DEFINE(inst, emul_bme280_init, &emul_bme280_data_##inst, NULL, \
+	                    &emul_bme280_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(EMUL_BME280_DEFINE)
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT sensirion_scd30
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <drivers/emul_scd30.h>
+
+#include "scd30_priv.h"
+
+LOG_MODULE_REGISTER(EMUL_SCD30, CONFIG_SENSOR_LOG_LEVEL);
+
+// Around 600 ppm, 25 °C and 50 %RH, slowly changing as in a ventilated room
+static const struct emul_waveform emul_scd30_default_waveforms[EMUL_SCD30_CHANNELS] = {
+	[EMUL_SCD30_CO2] = {.offset = 600, .amplitude = 200, .period_ms = 600000, .noise = 5},
+	[EMUL_SCD30_TEMPERATURE] = {.offset = 2500, .amplitude = 150, .period_ms = 900000, .noise = 5},
+	[EMUL_SCD30_HUMIDITY] = {.offset = 5000, .amplitude = 500, .period_ms = 900000, .noise = 20},
+};
+
+struct emul_scd30_cfg
+{
+	struct gpio_dt_spec rdy_gpios;
+};
+
+struct emul_scd30_data
+{
+	const struct emul *target;
+	struct emul_waveform waveforms[EMUL_SCD30_CHANNELS];
+	uint32_t seed;
+	// Command written last, which selects what is read next
+	uint16_t command;
+	bool measuring;
+	bool data_ready;
+	uint16_t sample_time;
+	uint16_t temperature_offset;
+	uint16_t altitude;
+	uint16_t frc_reference;
+	uint16_t asc_enabled;
+	// Ends each measurement interval, while periodic measurements run
+	struct k_work_delayable measurement_work;
+};
+
+/**
+ * @brief Drive the RDY pin, if the node declares it on an emulated GPIO.
+ *
+ * @param target Emulator of the sensor.
+ *
+ * @param level Physical level of the pin.
+ */
+static void emul_scd30_set_rdy(const struct emul *target, int level)
+{
+	const struct emul_scd30_cfg *cfg = target->cfg;
+
+	if (IS_ENABLED(CONFIG_GPIO_EMUL) && cfg->rdy_gpios.port != NULL)
+	{
+		gpio_emul_input_set(cfg->rdy_gpios.port, cfg->rdy_gpios.pin, level);
+	}
+}
+
+static void emul_scd30_measurement_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct emul_scd30_data *data = CONTAINER_OF(dwork, struct emul_scd30_data, measurement_work);
+
+	data->data_ready = true;
+	emul_scd30_set_rdy(data->target, 1);
+	k_work_schedule(dwork, K_SECONDS(data->sample_time));
+}
+
+// Appends a 16-bit word and its CRC, as the sensor sends them
+static uint8_t *emul_scd30_put_word(uint8_t *buf, uint16_t word)
+{
+	sys_put_be16(word, buf);
+	buf[SCD30_WORD_SIZE] = crc8(buf, SCD30_WORD_SIZE, SCD30_CRC8_POLYNOMIAL, SCD30_CRC8_INIT, false);
+	return buf + SCD30_WORD_SIZE + SCD30_CRC8_LEN;
+}
+
+// Appends a float as two words in big endian order
+static uint8_t *emul_scd30_put_float(uint8_t *buf, float value)
+{
+	uint32_t bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+	buf = emul_scd30_put_word(buf, bits >> 16);
+	return emul_scd30_put_word(buf, bits & 0xFFFF);
+}
+
+static int emul_scd30_read_measurement(const struct emul *target, uint8_t *buf, size_t len)
+{
+	struct emul_scd30_data *data = target->data;
+	uint8_t frame[SCD30_MEASUREMENT_DATA_WORDS * (SCD30_WORD_SIZE + SCD30_CRC8_LEN)];
+	int64_t now = k_uptime_get();
+	uint8_t *pos = frame;
+
+	if (!data->data_ready)
+	{
+		LOG_WRN("Measurement read before it was ready");
+	}
+	pos = emul_scd30_put_float(pos, emul_waveform_value(&data->waveforms[EMUL_SCD30_CO2], now,
+														&data->seed));
+	pos = emul_scd30_put_float(
+		pos, emul_waveform_value(&data->waveforms[EMUL_SCD30_TEMPERATURE], now, &data->seed) /
+				 100.0f);
+	pos = emul_scd30_put_float(
+		pos, emul_waveform_value(&data->waveforms[EMUL_SCD30_HUMIDITY], now, &data->seed) /
+				 100.0f);
+
+	memcpy(buf, frame, MIN(len, sizeof(frame)));
+	data->data_ready = false;
+	emul_scd30_set_rdy(target, 0);
+	return 0;
+}
+
+static int emul_scd30_read(const struct emul *target, uint8_t *buf, size_t len)
+{
+	struct emul_scd30_data *data = target->data;
+	uint8_t word[SCD30_WORD_SIZE + SCD30_CRC8_LEN];
+	uint16_t value;
+
+	switch (data->command)
+	{
+	case SCD30_CMD_READ_MEASUREMENT:
+		return emul_scd30_read_measurement(target, buf, len);
+	case SCD30_CMD_GET_DATA_READY:
+		value = data->data_ready;
+		break;
+	case SCD30_CMD_SET_MEASUREMENT_INTERVAL:
+		value = data->sample_time;
+		break;
+	case SCD30_CMD_SET_TEMPERATURE_OFFSET:
+		value = data->temperature_offset;
+		break;
+	case SCD30_CMD_SET_ALTITUDE:
+		value = data->altitude;
+		break;
+	case SCD30_CMD_SET_FORCED_RECALIBRATION:
+		value = data->frc_reference;
+		break;
+	case SCD30_CMD_AUTO_SELF_CALIBRATION:
+		value = data->asc_enabled;
+		break;
+	default:
+		LOG_ERR("Read after unsupported command 0x%04x", data->command);
+		return -EIO;
+	}
+
+	emul_scd30_put_word(word, value);
+	memcpy(buf, word, MIN(len, sizeof(word)));
+	return 0;
+}
+
+static int emul_scd30_write(const struct emul *target, const uint8_t *buf, size_t len)
+{
+	struct emul_scd30_data *data = target->data;
+	uint16_t value = 0;
+
+	if (len < SCD30_COMMAND_SIZE)
+	{
+		return -EIO;
+	}
+	data->command = sys_get_be16(buf);
+
+	// Commands with an argument carry one word and its CRC
+	if (len >= SCD30_CMD_SINGLE_WORD_BUF_LEN)
+	{
+		if (crc8(&buf[SCD30_COMMAND_SIZE], SCD30_WORD_SIZE, SCD30_CRC8_POLYNOMIAL,
+				 SCD30_CRC8_INIT, false) != buf[SCD30_COMMAND_SIZE + SCD30_WORD_SIZE])
+		{
+			LOG_ERR("Wrong CRC of argument of command 0x%04x", data->command);
+			return -EIO;
+		}
+		value = sys_get_be16(&buf[SCD30_COMMAND_SIZE]);
+	}
+	else if (data->command == SCD30_CMD_STOP_PERIODIC_MEASUREMENT)
+	{
+		data->measuring = false;
+		data->data_ready = false;
+		k_work_cancel_delayable(&data->measurement_work);
+		emul_scd30_set_rdy(target, 0);
+		return 0;
+	}
+	else
+	{
+		// Other writes without argument only select what is read next
+		return 0;
+	}
+
+	switch (data->command)
+	{
+	case SCD30_CMD_START_PERIODIC_MEASUREMENT:
+		data->measuring = true;
+		k_work_schedule(&data->measurement_work, K_SECONDS(data->sample_time));
+		break;
+	case SCD30_CMD_SET_MEASUREMENT_INTERVAL:
+		if (value < SCD30_MIN_SAMPLE_TIME || value > SCD30_MAX_SAMPLE_TIME)
+		{
+			return -EIO;
+		}
+		data->sample_time = value;
+		if (data->measuring)
+		{
+			k_work_reschedule(&data->measurement_work, K_SECONDS(value));
+		}
+		break;
+	case SCD30_CMD_SET_TEMPERATURE_OFFSET:
+		data->temperature_offset = value;
+		break;
+	case SCD30_CMD_SET_ALTITUDE:
+		data->altitude = value;
+		break;
+	case SCD30_CMD_SET_FORCED_RECALIBRATION:
+		data->frc_reference = value;
+		break;
+	case SCD30_CMD_AUTO_SELF_CALIBRATION:
+		data->asc_enabled = value;
+		break;
+	default:
+		LOG_ERR("Unsupported command 0x%04x", data->command);
+		return -EIO;
+	}
+	return 0;
+}
+
+static int emul_scd30_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+							   int addr)
+{
+	int rc;
+
+	ARG_UNUSED(addr);
+
+	for (int i = 0; i < num_msgs; i++)
+	{
+		if (msgs[i].flags & I2C_MSG_READ)
+		{
+			rc = emul_scd30_read(target, msgs[i].buf, msgs[i].len);
+		}
+		else
+		{
+			rc = emul_scd30_write(target, msgs[i].buf, msgs[i].len);
+		}
+		if (rc != 0)
+		{
+			return rc;
+		}
+	}
+	return 0;
+}
+
+int emul_scd30_set_waveform(const struct emul *target, enum emul_scd30_channel channel,
+							const struct emul_waveform *waveform)
+{
+	struct emul_scd30_data *data = target->data;
+
+	if (channel >= EMUL_SCD30_CHANNELS || waveform == NULL)
+	{
+		return -EINVAL;
+	}
+	data->waveforms[channel] = *waveform;
+	return 0;
+}
+
+static const struct i2c_emul_api emul_scd30_api = {
+	.transfer = emul_scd30_transfer,
+};
+
+static int emul_scd30_init(const struct emul *target, const struct device *parent)
+{
+	struct emul_scd30_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->target = target;
+	memcpy(data->waveforms, emul_scd30_default_waveforms, sizeof(data->waveforms));
+	data->sample_time = SCD30_MIN_SAMPLE_TIME;
+	data->seed = (uint32_t)(uintptr_t)target;
+	k_work_init_delayable(&data->measurement_work, emul_scd30_measurement_handler);
+	emul_scd30_set_rdy(target, 0);
+	return 0;
+}
+
+#define EMUL_SCD30_DEFINE(inst)                                                         \
+	static struct emul_scd30_data emul_scd30_data_##inst;                               \
+	static const struct emul_scd30_cfg emul_scd30_cfg_##inst = {                        \
+		.rdy_gpios = GPIO_DT_SPEC_INST_GET_OR(inst, rdy_gpios, {0}),                    \
+	};                                                                                  \
+	EMUL_DT_INST_DEFINE(inst, emul_scd30_init, &emul_scd30_data_##inst,                 \
+						&emul_scd30_cfg_##inst, &emul_scd30_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(EMUL_SCD30_DEFINE)
@@ -37,6 +37,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/sys/__assert.h>
 #include <zephyr/sys/byteorder.h>
@@ -54,6 +55,28 @@
 
 LOG_MODULE_REGISTER(SCD30, CONFIG_SENSOR_LOG_LEVEL);
 
+/*
+ * Workqueue shared by the driver instances, where measurements signaled
+ * by the RDY pin are read, so they don't hold the system workqueue
+ */
+static K_THREAD_STACK_DEFINE(scd30_workq_stack, CONFIG_SCD30_WORKQUEUE_STACK_SIZE);
+static struct k_work_q scd30_workq;
+static bool scd30_workq_started;
+
+/**
+ * @brief Wait until the SCD30 sensor has a measurement ready.
+ *
+ * The RDY pin is checked first, which costs no I2C transaction. If it isn't
+ * asserted, the sensor is queried, sleeping between queries, for at most one
+ * measurement interval.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ *
+ * @return 0 if a measurement is ready, -ETIMEDOUT if none came in time,
+ * or another negative error code on failure.
+ */
+static int scd30_wait_data_ready(const struct device *dev);
+
 /**
  * @brief Fetch a sample from the SCD30 sensor.
  *
@@ -86,6 +109,7 @@ static int scd30_write_command(const struct device *dev, uint16_t cmd)
 	sys_put_be16(cmd, tx_buf);
 
 	// Write the command to the I2C bus
+	((struct scd30_data *)dev->data)->stats.i2c_transactions++;
 	return i2c_write_dt(&cfg->bus, tx_buf, sizeof(tx_buf));
 }
 
@@ -152,6 +176,7 @@ static int scd30_write_register(const struct device *dev, uint16_t cmd, uint16_t
 	sys_put_be16(val, &tx_buf[2]);
 	tx_buf[4] = scd30_compute_crc(&tx_buf[2], sizeof(val));
 
+	((struct scd30_data *)dev->data)->stats.i2c_transactions++;
 	return i2c_write_dt(&cfg->bus, tx_buf, sizeof(tx_buf));
 }
 
@@ -184,6 +209,7 @@ static int scd30_read_register(const struct device *dev, uint16_t reg, uint16_t
 	k_sleep(K_MSEC(3)); // Wait for the sensor to process the command
 
 	// Read the response from the sensor
+	((struct scd30_data *)dev->data)->stats.i2c_transactions++;
 	rc = i2c_read_dt(&cfg->bus, (uint8_t *)&rx_word, sizeof(rx_word));
 	if (rc != 0)
 	{
@@ -585,7 +611,9 @@ static void scd30_data_ready_handler(const struct device *dev, struct gpio_callb
 	ARG_UNUSED(pins);
 
 	struct scd30_data *data = CONTAINER_OF(cb, struct scd30_data, callback_data_ready);
-	k_work_submit(&data->data_ready_work); // Triggers work schedule to be executed in due time
+	data->interrupt_cycles = k_cycle_get_32();
+	// Triggers work schedule to be executed in due time, on the driver workqueue
+	k_work_submit_to_queue(&scd30_workq, &data->data_ready_work);
 }
 
 /**
@@ -603,6 +631,12 @@ void trigger_application_callback(struct k_work *work)
 	int rc = 0;
 
 	struct scd30_data *data = CONTAINER_OF(work, struct scd30_data, data_ready_work);
+	uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->interrupt_cycles);
+
+	data->stats.interrupts++;
+	data->stats.total_work_latency_us += latency_us;
+	data->stats.max_work_latency_us = MAX(data->stats.max_work_latency_us, latency_us);
+
 	rc = scd30_sample_fetch(data->dev, SENSOR_CHAN_ALL);
 	if (rc != 0)
 	{
@@ -639,6 +673,12 @@ void scd30_register_callback(const struct device *dev, scd30_callback_t cb)
 	data->registered_callback = cb;
 	k_work_init(&data->data_ready_work, trigger_application_callback);
 
+	// Without RDY pin, fetches poll the sensor until a measurement is ready
+	if (cfg->rdy_gpios.port == NULL)
+	{
+		LOG_WRN("%s: no RDY pin, measurements won't be signaled", dev->name);
+		return;
+	}
 	if (!gpio_is_ready_dt(&cfg->rdy_gpios))
 	{
 		LOG_ERR("Error: ready_pin device %s is not ready\n",
@@ -652,6 +692,7 @@ void scd30_register_callback(const struct device *dev, scd30_callback_t cb)
 		LOG_ERR("%s: failed to initialize GPIO for data ready", dev->name);
 		return;
 	}
+	data->rdy_configured = true;
 
 	rc = gpio_pin_interrupt_configure_dt(&cfg->rdy_gpios, GPIO_INT_EDGE_TO_ACTIVE);
 	if (rc != 0)
@@ -674,9 +715,42 @@ void scd30_register_callback(const struct device *dev, scd30_callback_t cb)
 	rc = scd30_sample_fetch(dev, SENSOR_CHAN_ALL);
 }
 
+static int scd30_wait_data_ready(const struct device *dev)
+{
+	const struct scd30_config *cfg = dev->config;
+	struct scd30_data *data = dev->data;
+	uint16_t data_ready = 0;
+	int64_t deadline;
+	int rc;
+
+	// RDY pin stays high while a measurement is waiting to be read
+	if (data->rdy_configured && gpio_pin_get_dt(&cfg->rdy_gpios) == 1)
+	{
+		return 0;
+	}
+
+	// A new measurement comes at most one measurement interval later
+	deadline = k_uptime_get() + (int64_t)MAX(data->sample_time, SCD30_MIN_SAMPLE_TIME) * MSEC_PER_SEC +
+			   CONFIG_SCD30_DATA_READY_POLL_INTERVAL;
+	while (true)
+	{
+		data->stats.data_ready_polls++;
+		rc = scd30_read_register(dev, SCD30_CMD_GET_DATA_READY, &data_ready);
+		if (rc != 0 || data_ready)
+		{
+			return rc;
+		}
+		if (k_uptime_get() >= deadline)
+		{
+			LOG_WRN("%s: no measurement ready after %d seconds", dev->name, data->sample_time);
+			return -ETIMEDOUT;
+		}
+		k_sleep(K_MSEC(CONFIG_SCD30_DATA_READY_POLL_INTERVAL));
+	}
+}
+
 static int scd30_sample_fetch(const struct device *dev, enum sensor_channel chan)
 {
-	uint16_t data_ready;
 	struct scd30_data *data = dev->data;
 	const struct scd30_config *cfg = dev->config;
 	int rc = 0;
@@ -713,20 +787,12 @@ static int scd30_sample_fetch(const struct device *dev, enum sensor_channel chan
 		return -ENOTSUP;
 	}
 
-	rc = scd30_read_register(dev, SCD30_CMD_GET_DATA_READY, &data_ready);
+	data->stats.fetches++;
+	rc = scd30_wait_data_ready(dev);
 	if (rc != 0)
 	{
 		goto return_clause;
 	}
-	while (!data_ready)
-	{
-		rc = scd30_read_register(dev, SCD30_CMD_GET_DATA_READY, &data_ready);
-
-		if (rc != 0)
-		{
-			goto return_clause;
-		}
-	}
 	LOG_DBG("SCD30 data ready");
 
 	rc = scd30_write_command(dev, SCD30_CMD_READ_MEASUREMENT);
@@ -739,6 +805,7 @@ static int scd30_sample_fetch(const struct device *dev, enum sensor_channel chan
 	/* delay for 3 msec as per datasheet. */
 	k_sleep(K_MSEC(3));
 
+	data->stats.i2c_transactions++;
 	rc = i2c_read_dt(&cfg->bus, (uint8_t *)&raw_rx_data, sizeof(raw_rx_data));
 	if (rc != 0)
 	{
@@ -851,6 +918,27 @@ int scd30_stop_periodic_measurement(const struct device *dev)
 	return 0;
 }
 
+/**
+ * @brief Get the activity counters of the SCD30 driver.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ *
+ * @param stats Pointer where the counters are copied.
+ *
+ * @return 0 if successful, or a negative error code on failure.
+ */
+int scd30_get_stats(const struct device *dev, struct scd30_stats *stats)
+{
+	struct scd30_data *data = dev->data;
+
+	if (stats == NULL)
+	{
+		return -EINVAL;
+	}
+	*stats = data->stats;
+	return 0;
+}
+
 // Sensor driver API structure for the SCD30 sensor
 static const struct sensor_driver_api scd30_driver_api = {
 	.sample_fetch = scd30_sample_fetch,
@@ -871,14 +959,25 @@ static int scd30_init(const struct device *dev)
 
 	k_sem_init(&data->lock, 0, 1);
 
+	if (!scd30_workq_started)
+	{
+		struct k_work_queue_config workq_cfg = {.name = "scd30_workq"};
+
+		k_work_queue_start(&scd30_workq, scd30_workq_stack, K_THREAD_STACK_SIZEOF(scd30_workq_stack),
+						   CONFIG_SCD30_WORKQUEUE_PRIORITY, &workq_cfg);
+		scd30_workq_started = true;
+	}
+
 	if (!device_is_ready(cfg->bus.bus))
 	{
 		LOG_ERR("Failed to get pointer to %s device!", cfg->bus.bus->name);
 		return -ENODEV;
 	}
 
+#if defined(CONFIG_SOC_FAMILY_NORDIC_NRF)
 	// Really ugly workaround to make I2C1 work at 50KHz
 	((NRF_TWIM_Type *)NRF_TWIM1_BASE)->FREQUENCY = 0x00500000UL;
+#endif /* CONFIG_SOC_FAMILY_NORDIC_NRF */
 
 	rc = scd30_get_sample_time(dev);
 	if (rc != 0)
@@ -895,7 +994,7 @@ static int scd30_init(const struct device *dev)
 	static struct scd30_data scd30_data_##inst = {};                                        \
 	static const struct scd30_config scd30_config_##inst = {                                \
 		.bus = I2C_DT_SPEC_INST_GET(inst),                                                  \
-		.rdy_gpios = GPIO_DT_SPEC_INST_GET(inst, rdy_gpios),                                \
+		.rdy_gpios = GPIO_DT_SPEC_INST_GET_OR(inst, rdy_gpios, {0}),                        \
 	};                                                                                      \
                                                                                             \
 	DEVICE_DT_INST_DEFINE(inst, scd30_init, NULL, &scd30_data_##inst, &scd30_config_##inst, \
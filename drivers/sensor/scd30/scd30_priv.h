@@ -45,6 +45,7 @@ extern "C"
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/drivers/gpio.h>
+#include <drivers/scd30.h>
 
 #define SCD30_CMD_START_PERIODIC_MEASUREMENT 0x0010
 #define SCD30_CMD_STOP_PERIODIC_MEASUREMENT 0x0104
@@ -106,6 +107,11 @@ struct scd30_data
 	 * for the SCD30 sensor driver.
 	 */
 	struct k_work data_ready_work;
+	/* Cycle count when the RDY interrupt fired, to measure the workqueue latency */
+	uint32_t interrupt_cycles;
+	/* RDY pin is configured, so its level tells if a measurement is ready */
+	bool rdy_configured;
+	struct scd30_stats stats;
 	/**
 	 * @brief Callback function pointer for SCD30 sensor events.
 	 *
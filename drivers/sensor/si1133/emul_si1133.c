@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define DT_DRV_COMPAT silabs_si1133
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+#include <drivers/emul_si1133.h>
+
+#include "si1133_priv.h"
+
+LOG_MODULE_REGISTER(EMUL_SI1133, CONFIG_SENSOR_LOG_LEVEL);
+
+#define EMUL_SI1133_NUM_REGS					(0x2C)
+#define EMUL_SI1133_NUM_PARAMS					(0x40)
+#define EMUL_SI1133_NUM_CHANNELS				(6)
+#define EMUL_SI1133_PRM_MSK						(0x3F)
+// Parameter address of the ADCPOST of each channel, as ADCPOST0 + 4 * channel
+#define EMUL_SI1133_PRM_ADCPOST_STEP			(4)
+
+// Counts of an indoor light slowly changing along the day
+static const struct emul_waveform emul_si1133_default_waveforms[EMUL_SI1133_CHANNELS] = {
+	[EMUL_SI1133_LIGHT] = { .offset = 600, .amplitude = 400, .period_ms = 600000, .noise = 10 },
+	[EMUL_SI1133_IR] = { .offset = 300, .amplitude = 200, .period_ms = 600000, .noise = 5 },
+	[EMUL_SI1133_UV] = { .offset = 20, .amplitude = 15, .period_ms = 600000, .noise = 2 },
+};
+
+struct emul_si1133_cfg {
+	struct gpio_dt_spec int_gpio;
+};
+
+struct emul_si1133_data {
+	const struct emul *target;
+	struct emul_waveform waveforms[EMUL_SI1133_CHANNELS];
+	uint32_t seed;
+	uint8_t regs[EMUL_SI1133_NUM_REGS];
+	uint8_t params[EMUL_SI1133_NUM_PARAMS];
+	uint8_t cmd_counter;
+	// Ends each period of autonomous measurements, between START and PAUSE
+	struct k_work_delayable measurement_work;
+};
+
+// Drives the INT pin, active low, if the node declares it on an emulated GPIO
+static void emul_si1133_set_int(const struct emul *target, bool active)
+{
+	const struct emul_si1133_cfg *cfg = target->cfg;
+
+	if (IS_ENABLED(CONFIG_GPIO_EMUL) && cfg->int_gpio.port != NULL) {
+		gpio_emul_input_set(cfg->int_gpio.port, cfg->int_gpio.pin, active ? 0 : 1);
+	}
+}
+
+// Writes the enabled channels to HOSTOUT, 24-bit when set in their ADCPOST
+static void emul_si1133_measure(const struct emul *target)
+{
+	struct emul_si1133_data *data = target->data;
+	uint8_t chan_list = data->params[SI1133_PRM_TBL_CHAN_LIST];
+	uint8_t *out = &data->regs[SI1133_I2C_REG_HOSTOUT_BASE];
+	int64_t now = k_uptime_get();
+
+	for (int chan = 0; chan < EMUL_SI1133_NUM_CHANNELS; chan++) {
+		uint8_t adcpost = data->params[SI1133_PRM_TBL_ADCPOST0 +
+		                               chan * EMUL_SI1133_PRM_ADCPOST_STEP];
+		int32_t value = 0;
+
+		if (!(chan_list & BIT(chan))) {
+			continue;
+		}
+		if (chan < EMUL_SI1133_CHANNELS) {
+			value = emul_waveform_value(&data->waveforms[chan], now, &data->seed);
+		}
+		if (adcpost & SI1133_CFG_ADCPOSTX_24BIT_OUT) {
+			value = CLAMP(value, -0x800000, 0x7FFFFF);
+			*out++ = (value >> 16) & 0xFF;
+		} else {
+			value = CLAMP(value, 0, UINT16_MAX);
+		}
+		*out++ = (value >> 8) & 0xFF;
+		*out++ = value & 0xFF;
+	}
+	data->regs[SI1133_I2C_REG_IRQ_STATUS] |= chan_list;
+	if (data->regs[SI1133_I2C_REG_IRQ_STATUS] & data->regs[SI1133_I2C_REG_IRQ_ENABLE]) {
+		emul_si1133_set_int(target, true);
+	}
+}
+
+// Period of autonomous measurements, MEASCOUNT0 * MEASRATE units of 800 us
+static k_timeout_t emul_si1133_period(struct emul_si1133_data *data)
+{
+	uint32_t rate = (data->params[SI1133_PRM_TBL_MEASRATE_H] << 8) |
+	                data->params[SI1133_PRM_TBL_MEASRATE_L];
+	uint32_t count = MAX(data->params[SI1133_PRM_TBL_MEASCOUNT0], 1);
+
+	return K_USEC(MAX(rate, 1) * count * SI1133_VAL_MEASRATE_UNIT_US);
+}
+
+static void emul_si1133_measurement_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct emul_si1133_data *data = CONTAINER_OF(dwork, struct emul_si1133_data,
+	                                             measurement_work);
+
+	emul_si1133_measure(data->target);
+	k_work_schedule(dwork, emul_si1133_period(data));
+}
+
+static void emul_si1133_command(const struct emul *target, uint8_t cmd)
+{
+	struct emul_si1133_data *data = target->data;
+	uint8_t *rsp0 = &data->regs[SI1133_I2C_REG_RESPONSE0];
+
+	if (cmd & SI1133_CMD_REG_PRM_SET_PRFX) {
+		data->params[cmd & EMUL_SI1133_PRM_MSK] = data->regs[SI1133_I2C_REG_HOSTIN0];
+		data->regs[SI1133_I2C_REG_RESPONSE1] = data->regs[SI1133_I2C_REG_HOSTIN0];
+	} else if (cmd & SI1133_CMD_REG_PRM_QRY_PRFX) {
+		data->regs[SI1133_I2C_REG_RESPONSE1] = data->params[cmd & EMUL_SI1133_PRM_MSK];
+	} else {
+		switch (cmd) {
+		case SI1133_CMD_REG_RST_CMD_CTR:
+			data->cmd_counter = 0;
+			*rsp0 = SI1133_RESPONSE0_BIT_SLEEP;
+			return;
+		case SI1133_CMD_REG_RST_SW:
+			k_work_cancel_delayable(&data->measurement_work);
+			memset(data->params, 0, sizeof(data->params));
+			data->regs[SI1133_I2C_REG_IRQ_ENABLE] = 0;
+			data->regs[SI1133_I2C_REG_IRQ_STATUS] = 0;
+			data->cmd_counter = 0;
+			*rsp0 = SI1133_RESPONSE0_BIT_SLEEP;
+			emul_si1133_set_int(target, false);
+			return;
+		case SI1133_CMD_REG_FORCE:
+			emul_si1133_measure(target);
+			break;
+		case SI1133_CMD_REG_PAUSE:
+			k_work_cancel_delayable(&data->measurement_work);
+			break;
+		case SI1133_CMD_REG_START:
+			k_work_reschedule(&data->measurement_work, emul_si1133_period(data));
+			break;
+		default:
+			LOG_ERR("Unsupported command 0x%02x", cmd);
+			*rsp0 = SI1133_RESPONSE0_BIT_CMD_ERR;
+			return;
+		}
+	}
+	data->cmd_counter = (data->cmd_counter + 1) & SI1133_RESPONSE0_MSK_CMD_CTR;
+	*rsp0 = SI1133_RESPONSE0_BIT_SLEEP | data->cmd_counter;
+}
+
+static int emul_si1133_transfer(const struct emul *target, struct i2c_msg *msgs,
+                                int num_msgs, int addr)
+{
+	struct emul_si1133_data *data = target->data;
+	uint8_t reg;
+
+	ARG_UNUSED(addr);
+
+	// Transfers start with the register address, followed by the values
+	// written from it or by a read from it, maybe in separate messages
+	if (num_msgs < 1 || (msgs[0].flags & I2C_MSG_READ) || msgs[0].len < 1) {
+		return -EIO;
+	}
+	reg = msgs[0].buf[0];
+
+	for (int i = 0; i < num_msgs; i++) {
+		uint8_t *buf = msgs[i].buf;
+		uint32_t len = msgs[i].len;
+
+		if (i == 0) {
+			buf++;
+			len--;
+		}
+		if (reg + len > EMUL_SI1133_NUM_REGS) {
+			return -EIO;
+		}
+		if (msgs[i].flags & I2C_MSG_READ) {
+			memcpy(buf, &data->regs[reg], len);
+			// Reading the status clears it and releases the INT pin
+			if (reg <= SI1133_I2C_REG_IRQ_STATUS &&
+			    SI1133_I2C_REG_IRQ_STATUS < reg + len) {
+				data->regs[SI1133_I2C_REG_IRQ_STATUS] = 0;
+				emul_si1133_set_int(target, false);
+			}
+			continue;
+		}
+		for (uint32_t j = 0; j < len; j++, reg++) {
+			data->regs[reg] = buf[j];
+			if (reg == SI1133_I2C_REG_COMMAND) {
+				emul_si1133_command(target, buf[j]);
+			}
+		}
+	}
+	return 0;
+}
+
+int emul_si1133_set_waveform(const struct emul *target, enum emul_si1133_channel channel,
+                             const struct emul_waveform *waveform)
+{
+	struct emul_si1133_data *data = target->data;
+
+	if (channel >= EMUL_SI1133_CHANNELS || waveform == NULL) {
+		return -EINVAL;
+	}
+	data->waveforms[channel] = *waveform;
+	return 0;
+}
+
+static const struct i2c_emul_api emul_si1133_api = {
+	.transfer = emul_si1133_transfer,
+};
+
+static int emul_si1133_init(const struct emul *target, const struct device *parent)
+{
+	struct emul_si1133_data *data = target->data;
+
+	ARG_UNUSED(parent);
+
+	data->target = target;
+	data->seed = (uint32_t)(uintptr_t)target;
+	memcpy(data->waveforms, emul_si1133_default_waveforms, sizeof(data->waveforms));
+	data->regs[SI1133_I2C_REG_PART_ID] = SI1133_VAL_PART_ID;
+	data->regs[SI1133_I2C_REG_RESPONSE0] = SI1133_RESPONSE0_BIT_SLEEP;
+	k_work_init_delayable(&data->measurement_work, emul_si1133_measurement_handler);
+	emul_si1133_set_int(target, false);
+	return 0;
+}
+
+#define EMUL_SI1133_DEFINE(inst) \
+	static struct emul_si1133_data emul_si1133_data_##inst; \
+	static const struct emul_si1133_cfg emul_si1133_cfg_##inst = { \
+		.int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0}), \
+	}; \
+	EMUL_DT_INST_DEFINE(inst, emul_si1133_init, &emul_si1133_data_##inst, \
+	                    &emul_si1133_cfg_##inst, &emul_si1133_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(EMUL_SI1133_DEFINE)
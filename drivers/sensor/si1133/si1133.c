@@ -7,6 +7,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/logging/log.h>
@@ -58,10 +59,12 @@ static int si1133_cmd_counter_wait_increment(const struct device *dev)
 	int ret, retry;
 	uint8_t rsp0; // RESPONSE0 register
 	
-	// Repeatedly waits and tries to read rsp0
+	// Repeatedly tries to read rsp0 and waits, as commands usually finish right away
 	for (retry = 0; retry < SI1133_VAL_RETRY; retry++)
 	{
-		k_sleep(K_MSEC(SI1133_VAL_DELAY_MS));
+		if (retry > 0) {
+			k_sleep(K_MSEC(SI1133_VAL_DELAY_MS));
+		}
 		
 		if ((ret = si1133_rsp0_read(dev, &rsp0)) < 0) {
 			LOG_DBG("rsp0 read failed");
@@ -102,8 +105,8 @@ static int si1133_param_query(const struct device *dev,
 	return si1133_rsp1_read(dev, val);
 }
 
-static int si1133_param_set(const struct device *dev,
-                            uint8_t addr, uint8_t val)
+int si1133_param_set(const struct device *dev,
+                     uint8_t addr, uint8_t val)
 {
 	uint8_t rsp1;
 	int ret;
@@ -143,7 +146,7 @@ static int si1133_param_update(const struct device *dev,
 	return 0;
 }
 
-static int si1133_set_bl_mode(const struct device *dev, uint8_t enable)
+int si1133_set_bl_mode(const struct device *dev, uint8_t enable)
 {
 	uint8_t msk = SI1133_CFG_ADCPOSTX_24BIT_OUT;
 	uint8_t val = enable ? msk : 0x0;
@@ -160,14 +163,14 @@ static int si1133_set_bl_mode(const struct device *dev, uint8_t enable)
 	return 0;
 }
 
-static int si1133_start_meas(const struct device *dev)
+int si1133_cmd_send(const struct device *dev, uint8_t cmd)
 {
 	int ret;
 	
 	if ((ret = si1133_cmd_counter_clear(dev)) < 0) {
 		return ret;
 	}
-	if ((ret = si1133_cmd_write(dev, SI1133_CMD_REG_FORCE)) < 0) {
+	if ((ret = si1133_cmd_write(dev, cmd)) < 0) {
 		return ret;
 	}
 	if ((ret = si1133_cmd_counter_wait_increment(dev)) < 0) {
@@ -176,6 +179,11 @@ static int si1133_start_meas(const struct device *dev)
 	return 0;
 }
 
+static int si1133_start_meas(const struct device *dev)
+{
+	return si1133_cmd_send(dev, SI1133_CMD_REG_FORCE);
+}
+
 static int si1133_wait_meas(const struct device *dev)
 {
 	const uint8_t irq_status = SI1133_IRQ_CHANNEL_0 | SI1133_IRQ_CHANNEL_1 | 
@@ -183,20 +191,39 @@ static int si1133_wait_meas(const struct device *dev)
 	uint8_t status;
 	int ret, retry;
 	
+	// Checks before sleeping, as the measurement may have been started long before
 	for (retry = 0; retry < SI1133_VAL_RETRY; retry++)
 	{
-		k_sleep(K_MSEC(SI1133_VAL_DELAY_MS));
-		
 		if ((ret = si1133_irq_read(dev, &status)) < 0) {
 			return ret;
 		}
 		if ((status & irq_status) == irq_status) {
 			return 0;
 		}
+		k_sleep(K_MSEC(SI1133_VAL_DELAY_MS));
 	}
 	return -ETIMEDOUT;
 }
 
+int si1133_start_measurement(const struct device *dev)
+{
+	struct si1133_data *data = dev->data;
+	int ret;
+	
+	// Outputs are already refreshed by autonomous measurements
+	if (data->autonomous) {
+		return -EBUSY;
+	}
+	if ((ret = si1133_set_bl_mode(dev, data->bl_mode_enabled)) < 0) {
+		return ret;
+	}
+	if ((ret = si1133_start_meas(dev)) < 0) {
+		return ret;
+	}
+	data->meas_started = 1;
+	return 0;
+}
+
 /**
 * Returns the value multiplied by 100 ("centi" UV index) 
 */
@@ -261,12 +288,15 @@ static int si1133_sample_fetch(const struct device *dev,
 		return -EIO;
 #endif
 	
-	if ((ret = si1133_set_bl_mode(dev, data->bl_mode_enabled)) < 0) {
-		return ret;
+	// Outputs hold the last autonomous measurement, signaled by the trigger
+	if (data->autonomous) {
+		return si1133_fetch_meas(dev);
 	}
-	if ((ret = si1133_start_meas(dev)) < 0) {
+	// Collects measurement started by si1133_start_measurement, if any
+	if (!data->meas_started && (ret = si1133_start_measurement(dev)) < 0) {
 		return ret;
 	}
+	data->meas_started = 0;
 	if ((ret = si1133_wait_meas(dev)) < 0) {
 		return ret;
 	}
@@ -314,6 +344,11 @@ static int si1133_attr_set(const struct device *dev, enum sensor_channel chan,
 		        data->bl_mode_enabled ? "enabled" : "disabled");
 		return 0;
 	}
+#ifdef CONFIG_SI1133_TRIGGER
+	if (attr == SENSOR_ATTR_SAMPLING_FREQUENCY) {
+		return si1133_set_sampling_frequency(dev, val);
+	}
+#endif /* CONFIG_SI1133_TRIGGER */
 	return -ENOTSUP;
 }
 
@@ -497,8 +532,27 @@ static const struct sensor_driver_api si1133_api_funcs = {
 	.attr_get = si1133_attr_get,
 	.sample_fetch = si1133_sample_fetch,
 	.channel_get = si1133_channel_get,
+#ifdef CONFIG_SI1133_TRIGGER
+	.trigger_set = si1133_trigger_set,
+#endif /* CONFIG_SI1133_TRIGGER */
 };
 
+static int si1133_init(const struct device *dev)
+{
+	int ret;
+	
+	if ((ret = si1133_chip_init(dev)) < 0) {
+		return ret;
+	}
+#ifdef CONFIG_SI1133_TRIGGER
+	if ((ret = si1133_init_interrupt(dev)) < 0) {
+		LOG_DBG("interrupt setup failed: %d", ret);
+		return ret;
+	}
+#endif /* CONFIG_SI1133_TRIGGER */
+	return 0;
+}
+
 #ifdef CONFIG_PM_DEVICE
 static int si1133_pm_action(const struct device *dev,
                             enum pm_device_action action)
@@ -516,6 +570,7 @@ static int si1133_pm_action(const struct device *dev,
 			LOG_DBG("suspend failed: %d", ret);
 			return ret;
 		}
+		((struct si1133_data *)dev->data)->autonomous = 0;
 		break;
 	default:
 		return -ENOTSUP;
@@ -530,12 +585,14 @@ static int si1133_pm_action(const struct device *dev,
 	}; \
 	static const struct si1133_config si1133_config_##inst = { \
 		.i2c = I2C_DT_SPEC_INST_GET(inst), \
+		IF_ENABLED(CONFIG_SI1133_TRIGGER, \
+			(.int_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, int_gpios, {0}),)) \
 	}; \
 	\
 	PM_DEVICE_DT_INST_DEFINE(inst, si1133_pm_action); \
 	\
 	SENSOR_DEVICE_DT_INST_DEFINE(inst, \
-		si1133_chip_init, \
+		si1133_init, \
 		PM_DEVICE_DT_INST_GET(inst), \
 		&si1133_data_##inst, \
 		&si1133_config_##inst, \
@@ -20,6 +20,7 @@
 #define SI1133_I2C_REG_RESPONSE0				(0x11)
 #define SI1133_I2C_REG_RESPONSE1				(0x10)
 #define SI1133_I2C_REG_HOSTIN0					(0x0A)
+#define SI1133_I2C_REG_IRQ_ENABLE				(0x0F)
 #define SI1133_I2C_REG_IRQ_STATUS				(0x12)
 #define SI1133_I2C_REG_HOSTOUT_BASE				(0x13)
 
@@ -30,6 +31,8 @@
 #define SI1133_CMD_REG_RST_CMD_CTR				(0x00)
 #define SI1133_CMD_REG_RST_SW					(0x01)
 #define SI1133_CMD_REG_FORCE					(0x11)
+#define SI1133_CMD_REG_PAUSE					(0x12)
+#define SI1133_CMD_REG_START					(0x13)
 
 #define SI1133_PRM_TBL_CHAN_LIST				(0x01)
 #define SI1133_PRM_TBL_ADCCONFIG0				(0x02)
@@ -41,6 +44,12 @@
 #define SI1133_PRM_TBL_ADCPOST0					(0x04)
 #define SI1133_PRM_TBL_ADCPOST1					(0x08)
 #define SI1133_PRM_TBL_ADCPOST2					(0x0C)
+#define SI1133_PRM_TBL_MEASCONFIG0				(0x05)
+#define SI1133_PRM_TBL_MEASCONFIG1				(0x09)
+#define SI1133_PRM_TBL_MEASCONFIG2				(0x0D)
+#define SI1133_PRM_TBL_MEASRATE_H				(0x1A)
+#define SI1133_PRM_TBL_MEASRATE_L				(0x1B)
+#define SI1133_PRM_TBL_MEASCOUNT0				(0x1C)
 
 #define SI1133_IRQ_CHANNEL_0					(BIT(0))
 #define SI1133_IRQ_CHANNEL_1					(BIT(1))
@@ -67,6 +76,10 @@
 #define SI1133_CFG_ADCSENS2_HW_GAIN				(9)
 
 #define SI1133_CFG_ADCPOSTX_24BIT_OUT			(BIT(6))
+// Autonomous measurements of the channel happen every MEASCOUNT0 * MEASRATE
+#define SI1133_CFG_MEASCONFIGX_COUNTER_0		(0x1 << 6)
+// Unit of MEASRATE, in microseconds
+#define SI1133_VAL_MEASRATE_UNIT_US				(800)
 
 #define SI1133_CFG_TOTAL_OUTPUT_BYTES_LL		(6)
 #define SI1133_CFG_TOTAL_OUTPUT_BYTES_BL		(8)
@@ -89,10 +102,25 @@ struct si1133_data {
 	int64_t chan_uvi;
 	uint8_t bl_mode_enabled;
 	uint8_t cmd_counter;
+	// Measurement forced by si1133_start_measurement and not fetched yet
+	uint8_t meas_started;
+	// Sensor is measuring by itself, so outputs are read without forcing
+	uint8_t autonomous;
+#ifdef CONFIG_SI1133_TRIGGER
+	const struct device *dev;
+	struct gpio_callback gpio_cb;
+	// Clears the interrupt and calls the handler out of the interrupt context
+	struct k_work work;
+	sensor_trigger_handler_t handler;
+	const struct sensor_trigger *trigger;
+#endif /* CONFIG_SI1133_TRIGGER */
 };
 
 struct si1133_config {
 	struct i2c_dt_spec i2c;
+#ifdef CONFIG_SI1133_TRIGGER
+	struct gpio_dt_spec int_gpio;
+#endif /* CONFIG_SI1133_TRIGGER */
 };
 
 static inline int si1133_bus_check(const struct device *dev) {
@@ -128,6 +156,10 @@ static inline int si1133_irq_read(const struct device *dev, uint8_t *val) {
 	return si1133_reg_read(dev, SI1133_I2C_REG_IRQ_STATUS, val, 1);
 }
 
+static inline int si1133_irq_enable_write(const struct device *dev, uint8_t val) {
+	return si1133_reg_write(dev, SI1133_I2C_REG_IRQ_ENABLE, &val, 1);
+}
+
 // Read RESPONSE0 register
 static inline int si1133_rsp0_read(const struct device *dev, uint8_t *val) {
 	return si1133_reg_read(dev, SI1133_I2C_REG_RESPONSE0, val, 1);
@@ -138,4 +170,19 @@ static inline int si1133_rsp1_read(const struct device *dev, uint8_t *val) {
 	return si1133_reg_read(dev, SI1133_I2C_REG_RESPONSE1, val, 1);
 }
 
+// Sends command and waits for the sensor to accept it
+int si1133_cmd_send(const struct device *dev, uint8_t cmd);
+int si1133_param_set(const struct device *dev, uint8_t addr, uint8_t val);
+int si1133_set_bl_mode(const struct device *dev, uint8_t enable);
+
+#ifdef CONFIG_SI1133_TRIGGER
+int si1133_trigger_set(const struct device *dev,
+                       const struct sensor_trigger *trig,
+                       sensor_trigger_handler_t handler);
+// Starts autonomous measurements at the given frequency, or pauses them if it is 0
+int si1133_set_sampling_frequency(const struct device *dev,
+                                  const struct sensor_value *val);
+int si1133_init_interrupt(const struct device *dev);
+#endif /* CONFIG_SI1133_TRIGGER */
+
 #endif /* _SI1133_PRIV_H_ */
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024 Edgar Bernardi Righi
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+#include <drivers/si1133.h>
+
+#include "si1133_priv.h"
+
+LOG_MODULE_DECLARE(SI1133, CONFIG_SENSOR_LOG_LEVEL);
+
+// Channels measured autonomously, in the order they are measured
+static const uint8_t si1133_measconfig_addrs[] = {
+	SI1133_PRM_TBL_MEASCONFIG0,
+	SI1133_PRM_TBL_MEASCONFIG1,
+	SI1133_PRM_TBL_MEASCONFIG2,
+};
+
+static void si1133_gpio_callback(const struct device *port,
+                                 struct gpio_callback *cb, uint32_t pins)
+{
+	struct si1133_data *data = CONTAINER_OF(cb, struct si1133_data, gpio_cb);
+
+	ARG_UNUSED(port);
+	ARG_UNUSED(pins);
+
+	k_work_submit(&data->work);
+}
+
+static void si1133_work_handler(struct k_work *work)
+{
+	struct si1133_data *data = CONTAINER_OF(work, struct si1133_data, work);
+	uint8_t status;
+
+	// Reading the status clears it, releasing the INT pin for the next measurement
+	if (si1133_irq_read(data->dev, &status) < 0) {
+		LOG_DBG("irq status read failed");
+		return;
+	}
+	if (data->autonomous && data->handler != NULL) {
+		data->handler(data->dev, data->trigger);
+	}
+}
+
+int si1133_trigger_set(const struct device *dev,
+                       const struct sensor_trigger *trig,
+                       sensor_trigger_handler_t handler)
+{
+	const struct si1133_config *cfg = dev->config;
+	struct si1133_data *data = dev->data;
+
+	if (trig->type != SENSOR_TRIG_DATA_READY) {
+		return -ENOTSUP;
+	}
+	if (cfg->int_gpio.port == NULL) {
+		return -ENOTSUP;
+	}
+	data->handler = handler;
+	data->trigger = trig;
+	return gpio_pin_interrupt_configure_dt(&cfg->int_gpio, handler != NULL ?
+	                                       GPIO_INT_EDGE_TO_ACTIVE : GPIO_INT_DISABLE);
+}
+
+int si1133_set_sampling_frequency(const struct device *dev,
+                                  const struct sensor_value *val)
+{
+	struct si1133_data *data = dev->data;
+	uint64_t micro_hz = (uint64_t)val->val1 * 1000000 + val->val2;
+	uint32_t units, count;
+	uint16_t rate;
+	int ret;
+
+	// Parameters can only be changed while autonomous measurements are paused
+	if (data->autonomous) {
+		if ((ret = si1133_cmd_send(dev, SI1133_CMD_REG_PAUSE)) < 0) {
+			return ret;
+		}
+		data->autonomous = 0;
+	}
+	if ((ret = si1133_irq_enable_write(dev, 0)) < 0) {
+		return ret;
+	}
+	if (micro_hz == 0) {
+		return 0;
+	}
+
+	/*
+	 * The period is MEASCOUNT0 * MEASRATE units of 800 us. MEASRATE is
+	 * 16-bit, so longer periods are split among MEASCOUNT0 counts.
+	 */
+	units = DIV_ROUND_CLOSEST(UINT64_C(1000000000000) / micro_hz,
+	                         SI1133_VAL_MEASRATE_UNIT_US);
+	units = MAX(units, 1);
+	count = DIV_ROUND_UP(units, UINT16_MAX);
+	if (count > UINT8_MAX) {
+		return -EINVAL;
+	}
+	rate = units / count;
+
+	if ((ret = si1133_param_set(dev, SI1133_PRM_TBL_MEASRATE_H, rate >> 8)) < 0) {
+		return ret;
+	}
+	if ((ret = si1133_param_set(dev, SI1133_PRM_TBL_MEASRATE_L, rate & 0xFF)) < 0) {
+		return ret;
+	}
+	if ((ret = si1133_param_set(dev, SI1133_PRM_TBL_MEASCOUNT0, count)) < 0) {
+		return ret;
+	}
+	for (int i = 0; i < ARRAY_SIZE(si1133_measconfig_addrs); i++) {
+		ret = si1133_param_set(dev, si1133_measconfig_addrs[i],
+		                       SI1133_CFG_MEASCONFIGX_COUNTER_0);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+	if ((ret = si1133_set_bl_mode(dev, data->bl_mode_enabled)) < 0) {
+		return ret;
+	}
+
+	// Channels are measured in order, so the last one signals the whole set
+	if ((ret = si1133_irq_enable_write(dev, SI1133_IRQ_CHANNEL_2)) < 0) {
+		return ret;
+	}
+	if ((ret = si1133_cmd_send(dev, SI1133_CMD_REG_START)) < 0) {
+		return ret;
+	}
+	data->meas_started = 0;
+	data->autonomous = 1;
+	LOG_DBG("autonomous measurements every %u x %u us", count,
+	        rate * SI1133_VAL_MEASRATE_UNIT_US);
+	return 0;
+}
+
+int si1133_init_interrupt(const struct device *dev)
+{
+	const struct si1133_config *cfg = dev->config;
+	struct si1133_data *data = dev->data;
+	int ret;
+
+	data->dev = dev;
+	k_work_init(&data->work, si1133_work_handler);
+
+	// Instances without INT pin keep working with forced measurements
+	if (cfg->int_gpio.port == NULL) {
+		return 0;
+	}
+	if (!gpio_is_ready_dt(&cfg->int_gpio)) {
+		LOG_DBG("INT gpio %s is not ready", cfg->int_gpio.port->name);
+		return -ENODEV;
+	}
+	if ((ret = gpio_pin_configure_dt(&cfg->int_gpio, GPIO_INPUT)) < 0) {
+		return ret;
+	}
+	gpio_init_callback(&data->gpio_cb, si1133_gpio_callback, BIT(cfg->int_gpio.pin));
+	return gpio_add_callback(cfg->int_gpio.port, &data->gpio_cb);
+}
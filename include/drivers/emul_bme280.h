@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _EMUL_BME280_H_
+#define _EMUL_BME280_H_
+
+#include <zephyr/drivers/emul.h>
+#include <drivers/emul_waveform.h>
+
+/* Measurements of the BME280 emulator */
+enum emul_bme280_channel {
+	/* In hundredths of degree Celsius, from -40 to 60 */
+	EMUL_BME280_TEMPERATURE,
+	/* In pascals */
+	EMUL_BME280_PRESSURE,
+	/* In hundredths of %RH */
+	EMUL_BME280_HUMIDITY,
+	EMUL_BME280_CHANNELS,
+};
+
+/* Sets the signal returned by the next measurements of a channel */
+int emul_bme280_set_waveform(const struct emul *target, enum emul_bme280_channel channel,
+                             const struct emul_waveform *waveform);
+
+#endif /* _EMUL_BME280_H_ */
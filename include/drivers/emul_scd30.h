@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _EMUL_SCD30_H_
+#define _EMUL_SCD30_H_
+
+#include <zephyr/drivers/emul.h>
+#include <drivers/emul_waveform.h>
+
+/* Measurements of the SCD30 emulator */
+enum emul_scd30_channel
+{
+	/* In ppm */
+	EMUL_SCD30_CO2,
+	/* In hundredths of degree Celsius */
+	EMUL_SCD30_TEMPERATURE,
+	/* In hundredths of %RH */
+	EMUL_SCD30_HUMIDITY,
+	EMUL_SCD30_CHANNELS,
+};
+
+/* Sets the signal returned by the next measurements of a channel */
+int emul_scd30_set_waveform(const struct emul *target, enum emul_scd30_channel channel,
+							const struct emul_waveform *waveform);
+
+#endif /* _EMUL_SCD30_H_ */
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _EMUL_SI1133_H_
+#define _EMUL_SI1133_H_
+
+#include <zephyr/drivers/emul.h>
+#include <drivers/emul_waveform.h>
+
+/* Channels of the Si1133 emulator, in raw ADC counts */
+enum emul_si1133_channel {
+	EMUL_SI1133_LIGHT,
+	EMUL_SI1133_IR,
+	EMUL_SI1133_UV,
+	EMUL_SI1133_CHANNELS,
+};
+
+/* Sets the signal returned by the next measurements of a channel */
+int emul_si1133_set_waveform(const struct emul *target, enum emul_si1133_channel channel,
+                             const struct emul_waveform *waveform);
+
+#endif /* _EMUL_SI1133_H_ */
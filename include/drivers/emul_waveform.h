@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2024 LSI-TEC
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _EMUL_WAVEFORM_H_
+#define _EMUL_WAVEFORM_H_
+
+#include <zephyr/kernel.h>
+
+/*
+ * Signal measured by a sensor emulator, in the unit documented by each
+ * emulator. It is either a scripted triangle wave around offset or, when
+ * samples is set, a recording replayed in a loop and added to offset.
+ */
+struct emul_waveform {
+	int32_t offset;
+	/* Peak deviation of the triangle wave from offset */
+	int32_t amplitude;
+	/* Period of the triangle wave, 0 for a constant signal */
+	uint32_t period_ms;
+	/* Peak deviation of the pseudo-random noise added to every value */
+	int32_t noise;
+	/* Recording, linearly interpolated between samples */
+	const int32_t *samples;
+	size_t num_samples;
+	uint32_t sample_interval_ms;
+};
+
+// Pseudo-random number from a xorshift generator, so runs are reproducible
+static inline uint32_t emul_waveform_rand(uint32_t *seed) {
+	uint32_t x = *seed ? *seed : 0x2545F491;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*seed = x;
+	return x;
+}
+
+// Value of the waveform at the given uptime
+static inline int32_t emul_waveform_value(const struct emul_waveform *wf,
+                                          int64_t time_ms, uint32_t *seed) {
+	int64_t value = wf->offset;
+
+	if (wf->samples != NULL && wf->num_samples > 0) {
+		uint32_t interval = MAX(wf->sample_interval_ms, 1);
+		size_t index = (time_ms / interval) % wf->num_samples;
+		int32_t from = wf->samples[index];
+		int32_t to = wf->samples[(index + 1) % wf->num_samples];
+
+		value += from + ((int64_t)to - from) * (time_ms % interval) / interval;
+	} else if (wf->period_ms > 0) {
+		// Rises from -amplitude to amplitude in the first half of the period
+		int64_t phase = time_ms % wf->period_ms;
+		int64_t half = wf->period_ms / 2;
+		int64_t ramp = phase < half ? phase : wf->period_ms - phase;
+
+		value += (int64_t)wf->amplitude * (2 * ramp - half) / MAX(half, 1);
+	}
+	if (wf->noise > 0) {
+		value += (int32_t)(emul_waveform_rand(seed) % (2 * (uint32_t)wf->noise + 1)) -
+		         wf->noise;
+	}
+	return (int32_t)CLAMP(value, INT32_MIN, INT32_MAX);
+}
+
+#endif /* _EMUL_WAVEFORM_H_ */
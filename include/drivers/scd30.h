@@ -18,6 +18,22 @@ int scd30_start_periodic_measurement(const struct device *dev, int ambient_press
 
 int scd30_stop_periodic_measurement(const struct device *dev);
 
+/* Counters of the driver activity, to evaluate how measurements are signaled */
+struct scd30_stats
+{
+	uint32_t fetches;
+	uint32_t i2c_transactions;
+	/* GET_DATA_READY queries, only sent while the RDY pin isn't asserted */
+	uint32_t data_ready_polls;
+	/* RDY interrupts handled on the driver workqueue */
+	uint32_t interrupts;
+	/* Delay from RDY interrupt to its handling, in microseconds */
+	uint32_t max_work_latency_us;
+	uint64_t total_work_latency_us;
+};
+
+int scd30_get_stats(const struct device *dev, struct scd30_stats *stats);
+
 /* Additional custom attributes */
 enum scd30_attribute
 {
@@ -24,5 +24,11 @@ enum sensor_attribute_si1133 {
 	SENSOR_ATTR_BRIGHT_LIGHT_MODE = SENSOR_ATTR_PRIV_START,
 };
 
+/*
+ * Forces a measurement without waiting for the conversion. The next
+ * sensor_sample_fetch collects it, only waiting if it's still running.
+ */
+int si1133_start_measurement(const struct device *dev);
+
 #endif
 
@@ -0,0 +1,286 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file block compression tests
+ *
+ * This suite encodes records in Gorilla-style blocks and checks that they
+ * are decoded back unchanged: constant, increasing and random readings,
+ * timestamps whose delta of delta falls on every edge of the encoded
+ * ranges or needs the full 32-bit delta, XORs that reuse the window of
+ * the previous one, and blocks that fill up, which must be left as they
+ * were by the record that didn't fit.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <integration/data_buffer/block_compression/block_compression.h>
+
+/* Timestamp, pressure, temperature and humidity, as a BME280 record */
+#define RECORD_WORDS 4
+/* Records of a block are counted in a byte */
+#define MAX_RECORDS 255
+#define SAMPLE_PERIOD 1000
+
+static CompressedBlock block;
+static uint32_t records[MAX_RECORDS][RECORD_WORDS];
+/* Records are decoded one after the other, whatever their size */
+static uint32_t decoded[MAX_RECORDS * RECORD_WORDS];
+
+/* Deterministic pseudo-random words, so failures can be reproduced */
+static uint32_t random_word(void)
+{
+	static uint32_t state = 0x12345678;
+
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+/* Adds records until one doesn't fit and returns how many were added */
+static int fill_block(int num_records, uint8_t record_words)
+{
+	start_compressed_block(&block, record_words);
+	for (int i = 0; i < num_records; i++) {
+		if (add_compressed_record(&block, records[i]) == -ENOSPC) {
+			return i;
+		}
+	}
+	return num_records;
+}
+
+static void assert_roundtrip(int num_records, uint8_t record_words)
+{
+	int decoded_records;
+
+	zassert_equal(block.num_records, num_records, "%d records in block instead of %d",
+		      block.num_records, num_records);
+	memset(decoded, 0, sizeof(decoded));
+	decoded_records = decompress_block(block.words, get_compressed_block_words(&block),
+					   block.num_records, record_words, decoded);
+	zassert_equal(decoded_records, num_records, "Decoded %d records instead of %d",
+		      decoded_records, num_records);
+	for (int i = 0; i < num_records; i++) {
+		for (int j = 0; j < record_words; j++) {
+			uint32_t word = decoded[i * record_words + j];
+
+			zassert_equal(word, records[i][j],
+				      "Record %d word %d decoded as 0x%08x instead of 0x%08x", i, j,
+				      word, records[i][j]);
+		}
+	}
+}
+
+/* Checks the bits taken by a record with a timestamp only, after two reference records */
+static void assert_timestamp_bits(uint32_t third_timestamp, uint16_t expected_bits)
+{
+	uint16_t bits_before;
+
+	records[0][0] = 100000;
+	records[1][0] = records[0][0] + SAMPLE_PERIOD;
+	records[2][0] = third_timestamp;
+	zassert_equal(fill_block(2, 1), 2);
+	bits_before = block.num_bits;
+	zassert_ok(add_compressed_record(&block, records[2]));
+	zassert_equal(block.num_bits - bits_before, expected_bits,
+		      "Timestamp 0x%08x took %d bits instead of %d", third_timestamp,
+		      block.num_bits - bits_before, expected_bits);
+	assert_roundtrip(3, 1);
+}
+
+ZTEST(block_compression, test_constant_values)
+{
+	int added;
+
+	for (int i = 0; i < MAX_RECORDS; i++) {
+		records[i][0] = 100000 + i * SAMPLE_PERIOD;
+		records[i][1] = 101325;
+		records[i][2] = 2512;
+		records[i][3] = 4875;
+	}
+	added = fill_block(MAX_RECORDS, RECORD_WORDS);
+
+	/* The second record sets the delta, after which each record takes a bit
+	 * for the timestamp and one per word
+	 */
+	zassert_equal(block.num_bits,
+		      32 * RECORD_WORDS + 4 + 12 + RECORD_WORDS - 1 + (added - 2) * RECORD_WORDS,
+		      "Constant records took %d bits", block.num_bits);
+	assert_roundtrip(added, RECORD_WORDS);
+}
+
+ZTEST(block_compression, test_increasing_values)
+{
+	int added;
+
+	for (int i = 0; i < MAX_RECORDS; i++) {
+		records[i][0] = 100000 + i * SAMPLE_PERIOD;
+		records[i][1] = 101325 + i;
+		records[i][2] = 2500 + i * 3;
+		records[i][3] = 4000 + i * i;
+	}
+	added = fill_block(MAX_RECORDS, RECORD_WORDS);
+
+	zassert_true(added > 2, "Only %d increasing records fit", added);
+	assert_roundtrip(added, RECORD_WORDS);
+}
+
+ZTEST(block_compression, test_random_values)
+{
+	for (int round = 0; round < 100; round++) {
+		int added;
+
+		for (int i = 0; i < MAX_RECORDS; i++) {
+			for (int j = 0; j < RECORD_WORDS; j++) {
+				records[i][j] = random_word();
+			}
+		}
+		added = fill_block(MAX_RECORDS, RECORD_WORDS);
+
+		zassert_true(added >= 1, "Random record didn't fit an empty block");
+		assert_roundtrip(added, RECORD_WORDS);
+	}
+}
+
+ZTEST(block_compression, test_delta_of_delta_edges)
+{
+	/* Delta of delta at each edge of the 7, 9 and 12-bit ranges, and the
+	 * bits its timestamp takes with the prefix
+	 */
+	static const struct {
+		int32_t delta_of_delta;
+		uint16_t bits;
+	} edges[] = {
+		{0, 1},
+		{1, 2 + 7},       {-1, 2 + 7},
+		{63, 2 + 7},      {-64, 2 + 7},
+		{64, 3 + 9},      {-65, 3 + 9},
+		{255, 3 + 9},     {-256, 3 + 9},
+		{256, 4 + 12},    {-257, 4 + 12},
+		{2047, 4 + 12},   {-2048, 4 + 12},
+		{2048, 4 + 32},   {-2049, 4 + 32},
+		{INT32_MAX / 2, 4 + 32},
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(edges); i++) {
+		assert_timestamp_bits(100000 + 2 * SAMPLE_PERIOD + edges[i].delta_of_delta,
+				      edges[i].bits);
+	}
+}
+
+ZTEST(block_compression, test_full_delta_fallback)
+{
+	/* Timestamps going back, wrapping around and jumping by half the range
+	 * only fit as the full 32-bit delta
+	 */
+	static const uint32_t timestamps[] = {0, UINT32_MAX, 100000 + 0x80000000, 0x7FFFFFFF};
+
+	for (int i = 0; i < ARRAY_SIZE(timestamps); i++) {
+		assert_timestamp_bits(timestamps[i], 4 + 32);
+	}
+
+	/* The next delta of delta is relative to the full delta */
+	for (int i = 0; i < 4; i++) {
+		records[i][0] = 100000 + (uint32_t)i * 0x40000000;
+	}
+	records[4][0] = records[3][0] + 0x40000000 + 5;
+	zassert_equal(fill_block(5, 1), 5);
+	assert_roundtrip(5, 1);
+}
+
+ZTEST(block_compression, test_xor_window_reuse)
+{
+	uint16_t bits_before;
+
+	/* The first XOR opens a window of 8 bits, which the second fits in */
+	records[0][0] = 100000;
+	records[0][1] = 0x00001000;
+	records[1][0] = records[0][0] + SAMPLE_PERIOD;
+	records[1][1] = records[0][1] ^ 0x000FF000;
+	records[2][0] = records[1][0] + SAMPLE_PERIOD;
+	records[2][1] = records[1][1] ^ 0x00024000;
+	/* Meaningful bits outside the window open a new one */
+	records[3][0] = records[2][0] + SAMPLE_PERIOD;
+	records[3][1] = records[2][1] ^ 0x80000001;
+
+	zassert_equal(fill_block(2, 2), 2);
+	bits_before = block.num_bits;
+	zassert_ok(add_compressed_record(&block, records[2]));
+	zassert_equal(block.num_bits - bits_before, 1 + 2 + 8, "Reused window took %d bits",
+		      block.num_bits - bits_before);
+	bits_before = block.num_bits;
+	zassert_ok(add_compressed_record(&block, records[3]));
+	zassert_equal(block.num_bits - bits_before, 1 + 2 + 5 + 5 + 32, "New window took %d bits",
+		      block.num_bits - bits_before);
+	assert_roundtrip(4, 2);
+}
+
+ZTEST(block_compression, test_full_block)
+{
+	CompressedBlock full_block;
+	int added;
+
+	for (int i = 0; i < MAX_RECORDS; i++) {
+		records[i][0] = 100000 + i * SAMPLE_PERIOD + random_word() % 5000;
+		for (int j = 1; j < RECORD_WORDS; j++) {
+			records[i][j] = random_word();
+		}
+	}
+	added = fill_block(MAX_RECORDS, RECORD_WORDS);
+	zassert_true(added < MAX_RECORDS, "Block didn't fill up");
+
+	/* The record that didn't fit leaves no trace in the block */
+	memcpy(&full_block, &block, sizeof(block));
+	zassert_equal(add_compressed_record(&block, records[added]), -ENOSPC);
+	zassert_mem_equal(&block, &full_block, sizeof(block), "Block changed by a rejected record");
+	assert_roundtrip(added, RECORD_WORDS);
+}
+
+/* Sets record to the one before it, one sample period later */
+static void repeat_record(int record)
+{
+	memcpy(records[record], records[record - 1], sizeof(records[record]));
+	records[record][0] += SAMPLE_PERIOD;
+}
+
+ZTEST(block_compression, test_rollback_keeps_windows)
+{
+	CompressedBlock full_block;
+	int added = 1;
+
+	/* Records equal to the first one don't open windows, and take a few
+	 * bits each until about 50 are left
+	 */
+	records[0][0] = 100000;
+	for (int j = 1; j < RECORD_WORDS; j++) {
+		records[0][j] = random_word();
+	}
+	start_compressed_block(&block, RECORD_WORDS);
+	zassert_ok(add_compressed_record(&block, records[0]));
+	while (COMPRESSED_BLOCK_WORDS * 32 - block.num_bits > 50 && added < MAX_RECORDS - 2) {
+		repeat_record(added);
+		zassert_ok(add_compressed_record(&block, records[added]));
+		added++;
+	}
+
+	/* The first reading opens a window of 1 bit before the second doesn't fit */
+	zassert_true(COMPRESSED_BLOCK_WORDS * 32 - block.num_bits <= 50, "Block too large to fill");
+	repeat_record(added);
+	records[added][1] ^= 0x00000001;
+	records[added][2] ^= 0xFFFFFFFF;
+	memcpy(&full_block, &block, sizeof(block));
+	zassert_equal(add_compressed_record(&block, records[added]), -ENOSPC);
+	zassert_mem_equal(&block, &full_block, sizeof(block), "Block changed by a rejected record");
+
+	/* A XOR that fits the rejected window must open its own, as the decoder never saw it */
+	records[added][2] = records[added - 1][2];
+	zassert_ok(add_compressed_record(&block, records[added]));
+	assert_roundtrip(added + 1, RECORD_WORDS);
+}
+
+ZTEST_SUITE(block_compression, NULL, NULL, NULL, NULL, NULL);
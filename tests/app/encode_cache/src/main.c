@@ -0,0 +1,283 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file encode cache tests
+ *
+ * This suite gets records encoded for several holders and counts how many
+ * times each is encoded: once for every holder sharing an encoding level
+ * while it stays cached, every time for levels used by a single holder or
+ * for encodings that failed, and never while a holder still uses it. Two
+ * threads check that records are encoded out of the cache lock, and that a
+ * record requested while it's being encoded is encoded only once.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <communication/encode_cache/encode_cache.h>
+
+/* Holders 0 and 1 share a level, holder 2 has one of its own */
+#define SHARED_ENCODING MINIMALIST
+#define OWN_ENCODING RAW_BYTES
+#define OWN_HOLDER 2
+/* First words of records the encoder handles differently */
+#define BLOCKING_WORD 0xB10C
+#define FAILING_WORD 0xFA11
+#define OVERSIZED_WORD 0x0B16
+#define RECORD_WORDS 3
+#define THREAD_STACK_SIZE 2048
+#define THREAD_PRIORITY 0
+
+static atomic_t encode_calls;
+/* Statistics before each test, which counts from them */
+static EncodeCacheStats stats_before;
+/* Taken by the encoder of a blocking record until the test lets it finish */
+static struct k_sem encoding_started;
+static struct k_sem encoding_finished;
+
+static K_THREAD_STACK_DEFINE(first_thread_stack, THREAD_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(second_thread_stack, THREAD_STACK_SIZE);
+static struct k_thread first_thread;
+static struct k_thread second_thread;
+
+/* Request of an encoding made by a thread */
+typedef struct {
+	uint32_t data_words[RECORD_WORDS];
+	int holder;
+	int encoded_size;
+	const uint8_t *encoded_data;
+} EncodingRequest;
+
+/* Encodes a record as its encoding level and first two words */
+int encode_data(uint32_t *data_words, enum DataType data_type, enum EncodingLevel encoding,
+		uint8_t *encoded_data, size_t encoded_size)
+{
+	atomic_inc(&encode_calls);
+	switch (data_words[0]) {
+	case BLOCKING_WORD:
+		k_sem_give(&encoding_started);
+		k_sem_take(&encoding_finished, K_FOREVER);
+		break;
+	case FAILING_WORD:
+		return -EINVAL;
+	case OVERSIZED_WORD:
+		return encoded_size;
+	}
+	return snprintf((char *)encoded_data, encoded_size, "%d:%u:%u", encoding, data_words[0],
+			data_words[1]);
+}
+
+static int get_encoding(uint32_t *data_words, enum EncodingLevel encoding, int holder,
+			const uint8_t **encoded_data)
+{
+	BufferItem data_unit = {
+		.data_words = data_words,
+		.data_type = BME280_MODEL,
+		.num_words = RECORD_WORDS,
+	};
+
+	return get_cached_encoding(&data_unit, encoding, holder, encoded_data);
+}
+
+static void get_requested_encoding(void *request_ptr, void *unused1, void *unused2)
+{
+	EncodingRequest *request = request_ptr;
+
+	ARG_UNUSED(unused1);
+	ARG_UNUSED(unused2);
+	request->encoded_size = get_encoding(request->data_words, SHARED_ENCODING, request->holder,
+					     &request->encoded_data);
+}
+
+static k_tid_t start_request(struct k_thread *thread, k_thread_stack_t *stack,
+			     EncodingRequest *request)
+{
+	return k_thread_create(thread, stack, THREAD_STACK_SIZE, get_requested_encoding, request,
+			       NULL, NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void assert_stats(uint32_t hits, uint32_t misses, uint32_t uncached)
+{
+	EncodeCacheStats stats;
+
+	get_encode_cache_stats(&stats);
+	stats.hits -= stats_before.hits;
+	stats.misses -= stats_before.misses;
+	stats.uncached -= stats_before.uncached;
+	zassert_equal(stats.hits, hits, "%u hits instead of %u", stats.hits, hits);
+	zassert_equal(stats.misses, misses, "%u misses instead of %u", stats.misses, misses);
+	zassert_equal(stats.uncached, uncached, "%u uncached instead of %u", stats.uncached,
+		      uncached);
+}
+
+ZTEST(encode_cache, test_shared_level)
+{
+	uint32_t record[RECORD_WORDS] = {1, 2, 3};
+	uint32_t same_record[RECORD_WORDS] = {1, 2, 3};
+	const uint8_t *first, *second;
+
+	zassert_equal(get_encoding(record, SHARED_ENCODING, 0, &first), 5);
+	zassert_mem_equal(first, "2:1:2", 5);
+	zassert_equal(atomic_get(&encode_calls), 1);
+
+	/* Same content elsewhere in the buffer is found encoded */
+	zassert_equal(get_encoding(same_record, SHARED_ENCODING, 1, &second), 5);
+	zassert_equal_ptr(first, second);
+	zassert_equal(atomic_get(&encode_calls), 1);
+
+	/* Another content is encoded again, and so is the record at a level
+	 * no two holders share, without caching it
+	 */
+	same_record[2] = 4;
+	zassert_equal(get_encoding(same_record, SHARED_ENCODING, 1, &second), 5);
+	zassert_equal(get_encoding(record, VERBOSE, 1, &second), 5);
+	zassert_mem_equal(second, "3:1:2", 5);
+	zassert_equal(atomic_get(&encode_calls), 3);
+	assert_stats(1, 2, 1);
+}
+
+ZTEST(encode_cache, test_own_level)
+{
+	uint32_t record[RECORD_WORDS] = {1, 2, 3};
+	const uint8_t *encoded_data;
+
+	/* No other holder would find the record, so it isn't cached */
+	for (int i = 1; i <= 3; i++) {
+		zassert_equal(get_encoding(record, OWN_ENCODING, OWN_HOLDER, &encoded_data), 5);
+		zassert_mem_equal(encoded_data, "1:1:2", 5);
+		zassert_equal(atomic_get(&encode_calls), i);
+	}
+	assert_stats(0, 0, 3);
+}
+
+ZTEST(encode_cache, test_held_entry_kept)
+{
+	uint32_t record[RECORD_WORDS] = {1, 2, 3};
+	uint32_t other_record[RECORD_WORDS] = {4, 5, 6};
+	const uint8_t *held, *other;
+
+	zassert_equal(get_encoding(record, SHARED_ENCODING, 0, &held), 5);
+
+	/* Holder 1 goes through more records than fit in the cache */
+	for (int i = 0; i < 2 * CONFIG_ENCODE_CACHE_ENTRIES; i++) {
+		other_record[2] = i;
+		zassert_true(get_encoding(other_record, SHARED_ENCODING, 1, &other) > 0);
+	}
+	zassert_mem_equal(held, "2:1:2", 5, "Held encoding was replaced");
+	zassert_equal(get_encoding(record, SHARED_ENCODING, 1, &other), 5);
+	zassert_equal_ptr(held, other);
+	assert_stats(1, 1 + 2 * CONFIG_ENCODE_CACHE_ENTRIES, 0);
+
+	/* Once released, it's replaced by later records */
+	release_cached_encoding(0);
+	release_cached_encoding(1);
+	for (int i = 0; i < CONFIG_ENCODE_CACHE_ENTRIES; i++) {
+		other_record[2] = 100 + i;
+		zassert_true(get_encoding(other_record, SHARED_ENCODING, 1, &other) > 0);
+	}
+	zassert_equal(get_encoding(record, SHARED_ENCODING, 0, &held), 5);
+	assert_stats(1, 2 + 3 * CONFIG_ENCODE_CACHE_ENTRIES, 0);
+}
+
+ZTEST(encode_cache, test_failed_encoding)
+{
+	uint32_t failing_record[RECORD_WORDS] = {FAILING_WORD, 2, 3};
+	uint32_t oversized_record[RECORD_WORDS] = {OVERSIZED_WORD, 2, 3};
+	const uint8_t *encoded_data;
+
+	/* Errors aren't cached, so every request encodes the record */
+	zassert_equal(get_encoding(failing_record, SHARED_ENCODING, 0, &encoded_data), -EINVAL);
+	zassert_equal(get_encoding(failing_record, SHARED_ENCODING, 1, &encoded_data), -EINVAL);
+	zassert_equal(get_encoding(oversized_record, SHARED_ENCODING, 0, &encoded_data), -ENOMEM);
+	zassert_equal(get_encoding(oversized_record, OWN_ENCODING, OWN_HOLDER, &encoded_data),
+		      -ENOMEM);
+	zassert_equal(atomic_get(&encode_calls), 4);
+	assert_stats(0, 3, 1);
+}
+
+ZTEST(encode_cache, test_encoding_out_of_lock)
+{
+	EncodingRequest blocked = {.data_words = {BLOCKING_WORD, 2, 3}, .holder = 0};
+	EncodingRequest other = {.data_words = {7, 8, 9}, .holder = 1};
+	k_tid_t blocked_thread, other_thread;
+	int other_joined;
+
+	blocked_thread = start_request(&first_thread, first_thread_stack, &blocked);
+	zassert_ok(k_sem_take(&encoding_started, K_SECONDS(1)));
+
+	/* Another record is encoded while the first one still is */
+	other_thread = start_request(&second_thread, second_thread_stack, &other);
+	other_joined = k_thread_join(other_thread, K_SECONDS(1));
+	k_sem_give(&encoding_finished);
+	zassert_ok(k_thread_join(blocked_thread, K_SECONDS(1)));
+	zassert_ok(other_joined, "Encoding waited for another one");
+	zassert_equal(other.encoded_size, 5);
+	zassert_mem_equal(other.encoded_data, "2:7:8", 5);
+	zassert_equal(blocked.encoded_size, 9);
+	zassert_equal(atomic_get(&encode_calls), 2);
+	assert_stats(0, 2, 0);
+}
+
+ZTEST(encode_cache, test_concurrent_request)
+{
+	EncodingRequest first = {.data_words = {BLOCKING_WORD, 2, 3}, .holder = 0};
+	EncodingRequest second = {.data_words = {BLOCKING_WORD, 2, 3}, .holder = 1};
+	k_tid_t first_id, second_id;
+
+	first_id = start_request(&first_thread, first_thread_stack, &first);
+	zassert_ok(k_sem_take(&encoding_started, K_SECONDS(1)));
+
+	/* Request for the record being encoded waits for it instead of encoding it */
+	second_id = start_request(&second_thread, second_thread_stack, &second);
+	zassert_equal(k_thread_join(second_id, K_MSEC(100)), -EAGAIN,
+		      "Request didn't wait for the record being encoded");
+
+	k_sem_give(&encoding_finished);
+	zassert_ok(k_thread_join(first_id, K_SECONDS(1)));
+	zassert_ok(k_thread_join(second_id, K_SECONDS(1)));
+	zassert_equal(first.encoded_size, 9);
+	zassert_equal(second.encoded_size, 9);
+	zassert_equal_ptr(first.encoded_data, second.encoded_data);
+	zassert_equal(atomic_get(&encode_calls), 1);
+	assert_stats(1, 1, 0);
+}
+
+static void *encode_cache_setup(void)
+{
+	register_cache_holder(0, SHARED_ENCODING);
+	register_cache_holder(1, SHARED_ENCODING);
+	register_cache_holder(OWN_HOLDER, OWN_ENCODING);
+	return NULL;
+}
+
+static void encode_cache_before(void *fixture)
+{
+	static uint32_t test_runs;
+	uint32_t unused_record[RECORD_WORDS] = {0xFFFFFFFF, 0, test_runs++};
+	const uint8_t *encoded_data;
+
+	ARG_UNUSED(fixture);
+	k_sem_init(&encoding_started, 0, 1);
+	k_sem_init(&encoding_finished, 0, 1);
+	release_cached_encoding(0);
+	release_cached_encoding(1);
+	release_cached_encoding(OWN_HOLDER);
+
+	/* Records of earlier tests are replaced, so each test starts with no cached
+	 * record it uses, and its counts start from zero
+	 */
+	for (int i = 0; i < CONFIG_ENCODE_CACHE_ENTRIES; i++) {
+		unused_record[1] = i;
+		get_encoding(unused_record, SHARED_ENCODING, 0, &encoded_data);
+	}
+	release_cached_encoding(0);
+	get_encode_cache_stats(&stats_before);
+	atomic_set(&encode_calls, 0);
+}
+
+ZTEST_SUITE(encode_cache, NULL, encode_cache_setup, encode_cache_before, NULL, NULL);
@@ -0,0 +1,251 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file encoder benchmark
+ *
+ * This suite compares the verbose and minimalist encoders of every data
+ * type, written with the text formatter, against the snprintf encoders
+ * they replaced. Both must produce the same text for the sample records,
+ * which avoid the negative fractions the snprintf encoders got wrong.
+ *
+ * Results are printed as one JSON object per line, after BENCHMARK_PREFIX,
+ * so runs can be compared by the compare_benchmark.py script of the
+ * pipeline benchmark. Cycles are counted with the timing functions when
+ * they are enabled, as on pulga, and on native_sim, where time doesn't
+ * advance while the CPU runs, they are only meaningful as a smoke test.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#if defined(CONFIG_TIMING_FUNCTIONS)
+#include <zephyr/timing/timing.h>
+#endif
+
+#include <integration/data_abstraction/text_model/text_model.h>
+#include <integration/data_aggregation/aggregation_service.h>
+#include <sensors/bme280/bme280_service.h>
+#include <sensors/bmi160/bmi160_service.h>
+#include <sensors/l86_m33/l86_m33_service.h>
+#include <sensors/scd30/scd30_service.h>
+#include <sensors/si1133/si1133_service.h>
+#include <sensors/vbatt/vbatt_service.h>
+
+#include "snprintf_encoders.h"
+
+#define BENCHMARK_PREFIX "BENCHMARK "
+
+#define ENCODED_SIZE 512
+#define ENCODER_RECORDS 1000
+
+static uint32_t text_words[MAX_32_WORDS] = {0};
+
+static SensorModelBMI160Batch bmi160_batch_model = {
+	.timestamp = 123456,
+	.first_sample_ms = 42,
+	.sample_period_us = 10000,
+	.num_samples = BMI160_BATCH_SAMPLES,
+	.samples = {
+		{981, 12, 5, 7, 250, 3},
+		{980, 11, 6, 8, 251, 4},
+		{979, 10, 7, 9, 252, 5},
+		{978, 9, 8, 10, 253, 6},
+	},
+};
+
+static SummaryModel summary_model = {
+	.timestamp = 123456,
+	.source_type = BME280_MODEL,
+	.field = 1,
+	.count = 60,
+	.min = 2490,
+	.max = 2530,
+	.mean = 2512,
+	.std_dev = 11,
+};
+
+static SensorModelBME280 bme280_model = {
+	.timestamp = 123456,
+	.pressure = 101325,
+	.temperature = 2512,
+	.humidity = 4875,
+};
+
+static SensorModelBMI160 bmi160_model = {
+	.timestamp = 123456,
+	.acceleration = {981, 12, 5},
+	.rotation = {7, 250, 3},
+};
+
+static SensorModelSi1133 si1133_model = {
+	.timestamp = 123456,
+	.light = 1520,
+	.infrared = 340,
+	.uv = 87,
+	.uv_index = 315,
+};
+
+static SensorModelVbatt vbatt_model = {
+	.voltage = {.val1 = 3, .val2 = 712000},
+	.timestamp = 123456,
+};
+
+static SensorModelSCD30 scd30_model = {
+	.timestamp = 123456,
+	.co2 = 612,
+	.temperature = 2345,
+	.humidity = 4710,
+};
+
+/* Fractions of the coordinates without leading zeros, and of the others
+ * with 3 digits, which the snprintf encoder didn't pad
+ */
+static SensorModelGNSS gnss_model = {
+	.navigation = {
+		.latitude = -23561200000,
+		.longitude = -46735700000,
+		.bearing = 54700,
+		.speed = 120,
+		.altitude = 745100,
+	},
+	.real_time = {
+		.hour = 12,
+		.minute = 0,
+		.millisecond = 5250,
+		.month_day = 15,
+		.month = 10,
+		.century_year = 24,
+	},
+	.timestamp = 123456,
+};
+
+static const struct {
+	enum DataType data_type;
+	const char *name;
+	DataAPI *(*register_model)(void);
+	uint32_t *data_words;
+} samples[] = {
+	{TEXT_DATA, "text", register_text_model_callbacks, text_words},
+	{BMI160_BATCH_DATA, "bmi160_batch", register_bmi160_batch_model_callbacks,
+	 (uint32_t *)&bmi160_batch_model},
+	{SUMMARY_DATA, "summary", register_summary_model_callbacks, (uint32_t *)&summary_model},
+	{BME280_MODEL, "bme280", register_bme280_model_callbacks, (uint32_t *)&bme280_model},
+	{BMI160_MODEL, "bmi160", register_bmi160_model_callbacks, (uint32_t *)&bmi160_model},
+	{SI1133_MODEL, "si1133", register_si1133_model_callbacks, (uint32_t *)&si1133_model},
+	{VBATT_MODEL, "vbatt", register_vbatt_model_callbacks, (uint32_t *)&vbatt_model},
+	{SCD30_MODEL, "scd30", register_scd30_model_callbacks, (uint32_t *)&scd30_model},
+	{GNSS_MODEL, "gnss", register_gnss_model_callbacks, (uint32_t *)&gnss_model},
+};
+
+static DataAPI *data_apis[ARRAY_SIZE(samples)];
+
+static encoder_t get_encoder(int sample, bool minimalist)
+{
+	return minimalist ? data_apis[sample]->encode_minimalist :
+			    data_apis[sample]->encode_verbose;
+}
+
+static encoder_t get_snprintf_encoder(int sample, bool minimalist)
+{
+	const struct snprintf_encoder *encoder = &snprintf_encoders[samples[sample].data_type];
+
+	return minimalist ? encoder->minimalist : encoder->verbose;
+}
+
+static void encode_records(encoder_t encoder, uint32_t *data_words, uint8_t *encoded_data)
+{
+	for (int record = 0; record < ENCODER_RECORDS; record++) {
+		encoder(data_words, encoded_data, ENCODED_SIZE);
+	}
+}
+
+/* Cycles taken to encode ENCODER_RECORDS records */
+static uint64_t measure_encoder(encoder_t encoder, uint32_t *data_words, uint8_t *encoded_data)
+{
+#if defined(CONFIG_TIMING_FUNCTIONS)
+	timing_t start, end;
+
+	start = timing_counter_get();
+	encode_records(encoder, data_words, encoded_data);
+	end = timing_counter_get();
+	return timing_cycles_get(&start, &end);
+#else
+	uint32_t start = k_cycle_get_32();
+
+	encode_records(encoder, data_words, encoded_data);
+	return k_cycle_get_32() - start;
+#endif
+}
+
+ZTEST(encoder_benchmark, test_same_output)
+{
+	uint8_t expected[ENCODED_SIZE], encoded[ENCODED_SIZE];
+	/* Whole records, and records cut by small buffers */
+	static const size_t sizes[] = {ENCODED_SIZE, 40, 5, 1};
+
+	for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+		for (int minimalist = 0; minimalist <= 1; minimalist++) {
+			for (int j = 0; j < ARRAY_SIZE(sizes); j++) {
+				int expected_size = get_snprintf_encoder(i, minimalist)(
+					samples[i].data_words, expected, sizes[j]);
+				int size = get_encoder(i, minimalist)(samples[i].data_words,
+								      encoded, sizes[j]);
+
+				zassert_equal(size, expected_size, "%s: %d bytes instead of %d",
+					      samples[i].name, size, expected_size);
+				zassert_mem_equal(encoded, expected, MIN(size + 1, sizes[j]),
+						  "%s: \"%s\" instead of \"%s\"", samples[i].name,
+						  encoded, expected);
+			}
+		}
+	}
+}
+
+ZTEST(encoder_benchmark, test_cycles_per_record)
+{
+	static const struct {
+		const char *name;
+		encoder_t (*get)(int sample, bool minimalist);
+	} formatters[] = {
+		{"snprintf", get_snprintf_encoder},
+		{"text_format", get_encoder},
+	};
+	uint8_t encoded_data[ENCODED_SIZE];
+
+	for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+		for (int minimalist = 0; minimalist <= 1; minimalist++) {
+			for (int j = 0; j < ARRAY_SIZE(formatters); j++) {
+				encoder_t encoder = formatters[j].get(i, minimalist);
+				int size = encoder(samples[i].data_words, encoded_data,
+						   sizeof(encoded_data));
+				uint64_t cycles = measure_encoder(encoder, samples[i].data_words,
+								  encoded_data);
+
+				printk(BENCHMARK_PREFIX "{\"encoder\":\"%s\",\"data_type\":\"%s\","
+				       "\"formatter\":\"%s\",\"bytes\":%d,"
+				       "\"cycles_per_record\":%u}\n",
+				       minimalist ? "minimalist" : "verbose", samples[i].name,
+				       formatters[j].name, size,
+				       (uint32_t)(cycles / ENCODER_RECORDS));
+			}
+		}
+	}
+}
+
+static void *encoder_benchmark_setup(void)
+{
+	strcpy((char *)text_words, "Sensor started");
+	for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+		data_apis[i] = samples[i].register_model();
+	}
+#if defined(CONFIG_TIMING_FUNCTIONS)
+	timing_init();
+	timing_start();
+#endif
+	return NULL;
+}
+
+ZTEST_SUITE(encoder_benchmark, NULL, encoder_benchmark_setup, NULL, NULL, NULL);
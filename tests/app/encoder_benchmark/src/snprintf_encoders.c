@@ -0,0 +1,389 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Verbose and minimalist encoders of every data type as they were written
+ * with snprintf, before the models moved to the text formatter. They are
+ * kept unchanged as the reference the formatter is measured against.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <integration/data_aggregation/aggregation_service.h>
+#include <sensors/bme280/bme280_service.h>
+#include <sensors/bmi160/bmi160_service.h>
+#include <sensors/l86_m33/l86_m33_service.h>
+#include <sensors/scd30/scd30_service.h>
+#include <sensors/si1133/si1133_service.h>
+#include <sensors/vbatt/vbatt_service.h>
+
+#include "snprintf_encoders.h"
+
+static int text_snprintf_encode(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+  return snprintf(encoded_data, encoded_size, "%s\n", (char *)data_words);
+}
+
+static int bmi160_batch_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160Batch *batch_model = (SensorModelBMI160Batch *)data_words;
+    struct sensor_value acceleration[3], rotation[3];
+    int encoded_length = 0, written;
+
+    encoded_length = snprintf(encoded_data, encoded_size,
+                              "Timestamp: %d.%03d; Samples: %d; Period [us]: %d;",
+                              batch_model->timestamp, batch_model->first_sample_ms,
+                              batch_model->num_samples, batch_model->sample_period_us);
+    for (int i = 0; i < MIN(batch_model->num_samples, BMI160_BATCH_SAMPLES); i++)
+    {
+        if (encoded_length >= encoded_size)
+        {
+            break;
+        }
+        for (int axis = 0; axis < 3; axis++)
+        {
+            fixed_to_sensor_value(batch_model->samples[i][axis], BMI160_ACCELERATION_SCALE,
+                                  &acceleration[axis]);
+            fixed_to_sensor_value(batch_model->samples[i][3 + axis], BMI160_ROTATION_SCALE,
+                                  &rotation[axis]);
+        }
+        written = snprintf(&encoded_data[encoded_length], encoded_size - encoded_length,
+                           "\n  Acceleration [m/s²]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z); "
+                           "Rotation [radian/s]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z);",
+                           acceleration[0].val1, acceleration[0].val2 / 10000,
+                           acceleration[1].val1, acceleration[1].val2 / 10000,
+                           acceleration[2].val1, acceleration[2].val2 / 10000,
+                           rotation[0].val1, rotation[0].val2 / 10000,
+                           rotation[1].val1, rotation[1].val2 / 10000,
+                           rotation[2].val1, rotation[2].val2 / 10000);
+        encoded_length += written;
+    }
+
+    return encoded_length;
+}
+
+static int bmi160_batch_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SensorModelBMI160Batch *batch_model = (SensorModelBMI160Batch *)data_words;
+    int encoded_length = snprintf(encoded_data, encoded_size, "TS%d.%03dP%dB",
+                                  batch_model->timestamp, batch_model->first_sample_ms,
+                                  batch_model->sample_period_us);
+
+    for (int i = 0; i < MIN(batch_model->num_samples, BMI160_BATCH_SAMPLES); i++)
+    {
+        int16_t *sample = batch_model->samples[i];
+
+        if (encoded_length >= encoded_size)
+        {
+            break;
+        }
+        encoded_length += snprintf(&encoded_data[encoded_length], encoded_size - encoded_length,
+                                   " %d,%d,%d,%d,%d,%d", sample[0], sample[1], sample[2],
+                                   sample[3], sample[4], sample[5]);
+    }
+
+    return encoded_length;
+}
+
+static int summary_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SummaryModel *summary_model = (SummaryModel *)data_words;
+
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; Summary of data type %d, field %d; Readings: %d; "
+                    "Min: %d; Max: %d; Mean: %d; Standard deviation: %u;",
+                    summary_model->timestamp, summary_model->source_type, summary_model->field,
+                    summary_model->count, summary_model->min, summary_model->max,
+                    summary_model->mean, summary_model->std_dev);
+}
+
+static int summary_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    SummaryModel *summary_model = (SummaryModel *)data_words;
+
+    return snprintf(encoded_data, encoded_size, "TS%dS%d.%dN%dL%dH%dM%dD%u",
+                    summary_model->timestamp, summary_model->source_type, summary_model->field,
+                    summary_model->count, summary_model->min, summary_model->max,
+                    summary_model->mean, summary_model->std_dev);
+}
+
+static void bme280_get_measurements(SensorModelBME280 *bme280_model, struct sensor_value *temperature,
+                                    struct sensor_value *pressure, struct sensor_value *humidity)
+{
+    fixed_to_sensor_value(bme280_model->temperature, BME280_TEMPERATURE_SCALE, temperature);
+    fixed_to_sensor_value(bme280_model->pressure, BME280_PRESSURE_SCALE, pressure);
+    fixed_to_sensor_value(bme280_model->humidity, BME280_HUMIDITY_SCALE, humidity);
+}
+
+static int bme280_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+    struct sensor_value temperature, pressure, humidity;
+    bme280_get_measurements(bme280_model, &temperature, &pressure, &humidity);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; Temperature: %d.%02d°C; Pressure: %d.%02d kPa; "
+                    "Humidity: %d.%02d %%RH;",
+                    bme280_model->timestamp,
+                    temperature.val1, temperature.val2 / 10000,
+                    pressure.val1, pressure.val2 / 10000,
+                    humidity.val1, humidity.val2 / 10000);
+}
+
+static int bme280_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelBME280 *bme280_model = (SensorModelBME280 *)data_words;
+    struct sensor_value temperature, pressure, humidity;
+    bme280_get_measurements(bme280_model, &temperature, &pressure, &humidity);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dT%d.%02dP%d.%02dH%d.%02d",
+                    bme280_model->timestamp,
+                    temperature.val1, temperature.val2 / 10000,
+                    pressure.val1, pressure.val2 / 10000,
+                    humidity.val1, humidity.val2 / 10000);
+}
+
+static void bmi160_get_measurements(SensorModelBMI160 *bmi160_model, struct sensor_value *acceleration,
+                                    struct sensor_value *rotation)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        fixed_to_sensor_value(bmi160_model->acceleration[i], BMI160_ACCELERATION_SCALE,
+                              &acceleration[i]);
+        fixed_to_sensor_value(bmi160_model->rotation[i], BMI160_ROTATION_SCALE, &rotation[i]);
+    }
+}
+
+static int bmi160_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+    struct sensor_value acceleration[3], rotation[3];
+    bmi160_get_measurements(bmi160_model, acceleration, rotation);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; "
+                    "Acceleration [m/s²]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z); "
+                    "Rotation [radian/s]: %d.%02d (X) %d.%02d (Y) %d.%02d (Z);",
+                    bmi160_model->timestamp,
+                    acceleration[0].val1,
+                    acceleration[0].val2 / 10000,
+                    acceleration[1].val1,
+                    acceleration[1].val2 / 10000,
+                    acceleration[2].val1,
+                    acceleration[2].val2 / 10000,
+                    rotation[0].val1,
+                    rotation[0].val2 / 10000,
+                    rotation[1].val1,
+                    rotation[1].val2 / 10000,
+                    rotation[2].val1,
+                    rotation[2].val2 / 10000);
+}
+
+static int bmi160_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelBMI160 *bmi160_model = (SensorModelBMI160 *)data_words;
+    struct sensor_value acceleration[3], rotation[3];
+    bmi160_get_measurements(bmi160_model, acceleration, rotation);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dAC%d.%02d %d.%02d %d.%02dR%d.%02d %d.%02d %d.%02d",
+                    bmi160_model->timestamp,
+                    acceleration[0].val1,
+                    acceleration[0].val2 / 10000,
+                    acceleration[1].val1,
+                    acceleration[1].val2 / 10000,
+                    acceleration[2].val1,
+                    acceleration[2].val2 / 10000,
+                    rotation[0].val1,
+                    rotation[0].val2 / 10000,
+                    rotation[1].val1,
+                    rotation[1].val2 / 10000,
+                    rotation[2].val1,
+                    rotation[2].val2 / 10000);
+}
+
+static void si1133_get_measurements(SensorModelSi1133 *si1133_model, struct sensor_value *light,
+                                    struct sensor_value *infrared, struct sensor_value *uv,
+                                    struct sensor_value *uv_index)
+{
+    fixed_to_sensor_value(si1133_model->light, SI1133_LIGHT_SCALE, light);
+    fixed_to_sensor_value(si1133_model->infrared, SI1133_INFRARED_SCALE, infrared);
+    fixed_to_sensor_value(si1133_model->uv, SI1133_UV_SCALE, uv);
+    fixed_to_sensor_value(si1133_model->uv_index, SI1133_UV_INDEX_SCALE, uv_index);
+}
+
+static int si1133_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+    struct sensor_value light, infrared, uv, uv_index;
+    si1133_get_measurements(si1133_model, &light, &infrared, &uv, &uv_index);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; Light: %d lux; Infrared: %d lux; UV: %d; "
+                    "UVIndex: %d.%02d;",
+                    si1133_model->timestamp,
+                    light.val1,
+                    infrared.val1,
+                    uv.val1,
+                    uv_index.val1, uv_index.val2 / 10000);
+}
+
+static int si1133_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelSi1133 *si1133_model = (SensorModelSi1133 *)data_words;
+    struct sensor_value light, infrared, uv, uv_index;
+    si1133_get_measurements(si1133_model, &light, &infrared, &uv, &uv_index);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dL%dIR%dUV%dI%d.%02d",
+                    si1133_model->timestamp,
+                    light.val1,
+                    infrared.val1,
+                    uv.val1,
+                    uv_index.val1, uv_index.val2 / 10000);
+}
+
+static int vbatt_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; Voltage: %d.%03d V;",
+                    vbatt_model->timestamp,
+                    vbatt_model->voltage.val1,
+                    vbatt_model->voltage.val2 / 1000);
+}
+
+static int vbatt_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelVbatt *vbatt_model = (SensorModelVbatt *)data_words;
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dmV%d",
+                    vbatt_model->timestamp,
+                    vbatt_model->voltage.val1 * 1000 +
+                        vbatt_model->voltage.val2 / 1000);
+}
+
+static void scd30_get_measurements(SensorModelSCD30 *scd30_model, struct sensor_value *co2,
+                                   struct sensor_value *temperature, struct sensor_value *humidity)
+{
+    fixed_to_sensor_value(scd30_model->co2, SCD30_CO2_SCALE, co2);
+    fixed_to_sensor_value(scd30_model->temperature, SCD30_TEMPERATURE_SCALE, temperature);
+    fixed_to_sensor_value(scd30_model->humidity, SCD30_HUMIDITY_SCALE, humidity);
+}
+
+static int scd30_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+    struct sensor_value co2, temperature, humidity;
+    scd30_get_measurements(scd30_model, &co2, &temperature, &humidity);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Timestamp: %d; CO2: %d ppm; Temperature: %d.%02d oC; "
+                    "Humidity: %d.%02d %% RH;",
+                    scd30_model->timestamp,
+                    co2.val1,
+                    temperature.val1, temperature.val2 / 10000,
+                    humidity.val1, humidity.val2 / 10000);
+}
+
+static int scd30_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelSCD30 *scd30_model = (SensorModelSCD30 *)data_words;
+    struct sensor_value co2, temperature, humidity;
+    scd30_get_measurements(scd30_model, &co2, &temperature, &humidity);
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dCO2%dT%d.%02dH%d.%02d",
+                    scd30_model->timestamp,
+                    co2.val1,
+                    temperature.val1, temperature.val2 / 10000,
+                    humidity.val1, humidity.val2 / 10000);
+}
+
+static int gnss_snprintf_verbose(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelGNSS *gnss_model = (SensorModelGNSS *)data_words;
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "Latitude: %lld.%lld o; Longitude: %lld.%lld o; Bearing angle: %d.%d o; "
+                    "Speed: %d.%d m/s; Altitude: %d.%d m;\n\t"
+                    "Timestamp: %02dh %02dmin %02d.%ds - %02d/%02d/20%02d",
+                    gnss_model->navigation.latitude / 1000000000,
+                    llabs(gnss_model->navigation.latitude % 1000000000) / 100, // Gets 7 digits
+                    gnss_model->navigation.longitude / 1000000000,
+                    llabs(gnss_model->navigation.longitude % 1000000000) / 100, // Gets 7 digits
+                    gnss_model->navigation.bearing / 1000,
+                    gnss_model->navigation.bearing % 1000,
+                    gnss_model->navigation.speed / 1000,
+                    gnss_model->navigation.speed % 1000,
+                    gnss_model->navigation.altitude / 1000,
+                    gnss_model->navigation.altitude % 1000,
+                    gnss_model->real_time.hour,
+                    gnss_model->real_time.minute,
+                    gnss_model->real_time.millisecond / 1000,
+                    gnss_model->real_time.millisecond % 1000,
+                    gnss_model->real_time.month_day,
+                    gnss_model->real_time.month,
+                    gnss_model->real_time.century_year);
+}
+
+static int gnss_snprintf_minimalist(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size)
+{
+    // Converts words into the model
+    SensorModelGNSS *gnss_model = (SensorModelGNSS *)data_words;
+
+    // Formats the string
+    return snprintf(encoded_data, encoded_size,
+                    "TS%dLT%lldLG%lldB%dS%dAL%dTU%02d%02d%dD%02d%02d%02d",
+                    gnss_model->timestamp,
+                    gnss_model->navigation.latitude / 100,
+                    gnss_model->navigation.longitude / 100,
+                    gnss_model->navigation.bearing,
+                    gnss_model->navigation.speed,
+                    gnss_model->navigation.altitude / 100,
+                    gnss_model->real_time.hour,
+                    gnss_model->real_time.minute,
+                    gnss_model->real_time.millisecond / 1000,
+                    gnss_model->real_time.month_day,
+                    gnss_model->real_time.month,
+                    gnss_model->real_time.century_year);
+}
+
+const struct snprintf_encoder snprintf_encoders[MAX_DATA_TYPE] = {
+	[TEXT_DATA] = {text_snprintf_encode, text_snprintf_encode},
+	[BMI160_BATCH_DATA] = {bmi160_batch_snprintf_verbose, bmi160_batch_snprintf_minimalist},
+	[SUMMARY_DATA] = {summary_snprintf_verbose, summary_snprintf_minimalist},
+	[BME280_MODEL] = {bme280_snprintf_verbose, bme280_snprintf_minimalist},
+	[BMI160_MODEL] = {bmi160_snprintf_verbose, bmi160_snprintf_minimalist},
+	[SI1133_MODEL] = {si1133_snprintf_verbose, si1133_snprintf_minimalist},
+	[VBATT_MODEL] = {vbatt_snprintf_verbose, vbatt_snprintf_minimalist},
+	[SCD30_MODEL] = {scd30_snprintf_verbose, scd30_snprintf_minimalist},
+	[GNSS_MODEL] = {gnss_snprintf_verbose, gnss_snprintf_minimalist},
+};
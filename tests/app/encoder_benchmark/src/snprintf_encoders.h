@@ -0,0 +1,20 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SNPRINTF_ENCODERS_H
+#define SNPRINTF_ENCODERS_H
+
+#include <integration/data_abstraction/abstraction_service.h>
+
+typedef int (*encoder_t)(uint32_t *data_words, uint8_t *encoded_data, size_t encoded_size);
+
+struct snprintf_encoder {
+	encoder_t verbose;
+	encoder_t minimalist;
+};
+
+/* Reference encoders of each data type, indexed by DataType */
+extern const struct snprintf_encoder snprintf_encoders[MAX_DATA_TYPE];
+
+#endif /* SNPRINTF_ENCODERS_H */
@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file LoRaWAN buffer tests
+ *
+ * This suite inserts encoded items of each retention class in the LoRaWAN
+ * buffer and checks the order they are packed and taken in: most critical
+ * class first, oldest first within a class, and the space left filled by
+ * less critical items, unless an item waited longer than the maximum age,
+ * which then goes before the others even under a steady flow of critical
+ * items. Encoding is replaced by an item holding its data type and a
+ * sequence number, of the size the test asks for.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <communication/lorawan/lorawan_buffer/lorawan_buffer.h>
+
+/* Data types standing for items of each retention class */
+#define BULK_TYPE BME280_MODEL
+#define NORMAL_TYPE SCD30_MODEL
+#define CRITICAL_TYPE VBATT_MODEL
+
+#define ITEM_SIZE 10
+#define MAX_PACKAGE_SIZE 51
+
+static DataAPI data_apis[MAX_DATA_TYPE];
+static uint8_t encoded_item[LORAWAN_MAX_ITEM_SIZE];
+
+/* Items are encoded as their data type and sequence number, padded to the size
+ * kept in the custom value of the unit
+ */
+int get_encoded_unit(enum ChannelType channel, CommunicationUnit *unit,
+		     const uint8_t **encoded_data)
+{
+	ARG_UNUSED(channel);
+
+	memset(encoded_item, 0xAA, unit->custom_value);
+	encoded_item[0] = unit->data_type;
+	encoded_item[1] = unit->data_words[0];
+	*encoded_data = encoded_item;
+	return unit->custom_value;
+}
+
+DataAPI *get_data_api(enum DataType data_type)
+{
+	return &data_apis[data_type];
+}
+
+static void insert_item(enum DataType data_type, uint8_t sequence, uint8_t size)
+{
+	uint32_t data_word = sequence;
+	CommunicationUnit unit = {
+		.data_words = &data_word,
+		.data_type = data_type,
+		.num_words = 1,
+		.custom_value = size,
+	};
+
+	zassert_ok(encode_and_insert(&unit), "Failed to insert item %d", sequence);
+}
+
+/* Checks the data type and sequence number of the item at `offset` of a package */
+static void assert_packed_item(uint8_t *package, int offset, enum DataType data_type,
+			       uint8_t sequence)
+{
+	zassert_equal(package[offset], data_type, "Item at %d has type %d instead of %d", offset,
+		      package[offset], data_type);
+	zassert_equal(package[offset + 1], sequence, "Item at %d is %d instead of %d", offset,
+		      package[offset + 1], sequence);
+}
+
+/* Packs a package with room for a single item and checks which one it is */
+static void assert_next_packed(enum DataType data_type, uint8_t sequence)
+{
+	uint8_t package[ITEM_SIZE], num_records;
+
+	zassert_equal(pack_lorawan_items(package, sizeof(package), &num_records), ITEM_SIZE);
+	zassert_equal(num_records, 1);
+	assert_packed_item(package, 0, data_type, sequence);
+}
+
+ZTEST(lorawan_buffer, test_class_order)
+{
+	uint8_t package[MAX_PACKAGE_SIZE], num_records;
+
+	insert_item(BULK_TYPE, 1, ITEM_SIZE);
+	insert_item(NORMAL_TYPE, 2, ITEM_SIZE);
+	insert_item(CRITICAL_TYPE, 3, ITEM_SIZE);
+	insert_item(BULK_TYPE, 4, ITEM_SIZE);
+	insert_item(CRITICAL_TYPE, 5, ITEM_SIZE);
+
+	zassert_equal(get_buffer_to_package_size(), 5 * ITEM_SIZE);
+	zassert_equal(pack_lorawan_items(package, sizeof(package), &num_records), 5 * ITEM_SIZE);
+	zassert_equal(num_records, 5);
+	assert_packed_item(package, 0 * ITEM_SIZE, CRITICAL_TYPE, 3);
+	assert_packed_item(package, 1 * ITEM_SIZE, CRITICAL_TYPE, 5);
+	assert_packed_item(package, 2 * ITEM_SIZE, NORMAL_TYPE, 2);
+	assert_packed_item(package, 3 * ITEM_SIZE, BULK_TYPE, 1);
+	assert_packed_item(package, 4 * ITEM_SIZE, BULK_TYPE, 4);
+	zassert_true(lorawan_buffer_empty());
+}
+
+ZTEST(lorawan_buffer, test_fills_space_left)
+{
+	uint8_t package[30], num_records;
+
+	/* The normal item doesn't fit after the critical one, the bulk one does */
+	insert_item(CRITICAL_TYPE, 1, 20);
+	insert_item(NORMAL_TYPE, 2, 15);
+	insert_item(BULK_TYPE, 3, 5);
+
+	zassert_equal(pack_lorawan_items(package, sizeof(package), &num_records), 25);
+	zassert_equal(num_records, 2);
+	assert_packed_item(package, 0, CRITICAL_TYPE, 1);
+	assert_packed_item(package, 20, BULK_TYPE, 3);
+	zassert_equal(get_buffer_to_package_size(), 15);
+}
+
+ZTEST(lorawan_buffer, test_oversized_item_discarded)
+{
+	uint8_t package[ITEM_SIZE], num_records;
+
+	insert_item(CRITICAL_TYPE, 1, ITEM_SIZE + 1);
+	insert_item(BULK_TYPE, 2, ITEM_SIZE);
+
+	zassert_equal(pack_lorawan_items(package, sizeof(package), &num_records), ITEM_SIZE);
+	zassert_equal(num_records, 1);
+	assert_packed_item(package, 0, BULK_TYPE, 2);
+	zassert_true(lorawan_buffer_empty());
+}
+
+ZTEST(lorawan_buffer, test_age_bound)
+{
+	/* Packages are sent at this interval, each fitting one item */
+	const int period = CONFIG_LORAWAN_MAX_ITEM_AGE / 4;
+	int64_t bulk_inserted;
+	uint8_t sequence = 1;
+
+	insert_item(BULK_TYPE, 0, ITEM_SIZE);
+	bulk_inserted = k_uptime_get();
+
+	/* A steady flow of critical items keeps the package full */
+	while (k_uptime_get() - bulk_inserted < CONFIG_LORAWAN_MAX_ITEM_AGE) {
+		insert_item(CRITICAL_TYPE, sequence, ITEM_SIZE);
+		assert_next_packed(CRITICAL_TYPE, sequence);
+		sequence++;
+		k_sleep(K_MSEC(period));
+	}
+
+	/* Once past the maximum age, the bulk item goes in the next package */
+	insert_item(CRITICAL_TYPE, sequence, ITEM_SIZE);
+	assert_next_packed(BULK_TYPE, 0);
+	assert_next_packed(CRITICAL_TYPE, sequence);
+	zassert_true(lorawan_buffer_empty());
+}
+
+ZTEST(lorawan_buffer, test_oldest_overdue_first)
+{
+	uint8_t size;
+	uint8_t item[ITEM_SIZE];
+
+	insert_item(BULK_TYPE, 1, ITEM_SIZE);
+	k_sleep(K_MSEC(CONFIG_LORAWAN_MAX_ITEM_AGE / 2));
+	insert_item(NORMAL_TYPE, 2, ITEM_SIZE);
+	k_sleep(K_MSEC(CONFIG_LORAWAN_MAX_ITEM_AGE));
+	insert_item(CRITICAL_TYPE, 3, ITEM_SIZE);
+
+	/* Both overdue items go before the critical one, from the oldest */
+	zassert_ok(get_lorawan_item(item, &size));
+	assert_packed_item(item, 0, BULK_TYPE, 1);
+	assert_next_packed(NORMAL_TYPE, 2);
+	zassert_ok(get_lorawan_item(item, &size));
+	zassert_equal(size, ITEM_SIZE);
+	assert_packed_item(item, 0, CRITICAL_TYPE, 3);
+	zassert_equal(get_lorawan_item(item, &size), -ENODATA);
+}
+
+static void *lorawan_buffer_setup(void)
+{
+	data_apis[BULK_TYPE].retention_class = RETENTION_BULK;
+	data_apis[NORMAL_TYPE].retention_class = RETENTION_NORMAL;
+	data_apis[CRITICAL_TYPE].retention_class = RETENTION_CRITICAL;
+	return NULL;
+}
+
+static void lorawan_buffer_before(void *fixture)
+{
+	uint8_t size;
+
+	ARG_UNUSED(fixture);
+	while (get_lorawan_item(NULL, &size) == 0) {
+	}
+}
+
+ZTEST_SUITE(lorawan_buffer, NULL, lorawan_buffer_setup, lorawan_buffer_before, NULL, NULL);
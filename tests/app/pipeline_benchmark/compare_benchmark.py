@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: Apache-2.0
+"""Compares two runs of the pipeline benchmark.
+
+Reads the BENCHMARK lines of the console output of each run, such as the
+handler.log twister writes, and lists the metrics that got worse by more
+than the tolerance. Exits with 1 if any did, so it can gate CI.
+
+    compare_benchmark.py baseline/handler.log current/handler.log
+"""
+
+import argparse
+import json
+import sys
+
+PREFIX = "BENCHMARK "
+
+# Fields that identify a result, the others are metrics
+KEYS = ("rate", "encoder", "producer", "data_type", "formatter", "thread")
+# Metrics where higher values are better, for the others lower is better
+HIGHER_IS_BETTER = {"records_per_s", "received"}
+# Metrics that only describe the run
+IGNORED = {"produced", "stack_size"}
+
+
+def read_results(path):
+    results = {}
+    with open(path, encoding="utf-8", errors="replace") as log:
+        for line in log:
+            start = line.find(PREFIX)
+            if start < 0:
+                continue
+            result = json.loads(line[start + len(PREFIX):])
+            key = tuple((k, result[k]) for k in KEYS if k in result)
+            results[key] = result
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--tolerance", type=float, default=10.0,
+                        help="allowed change in percent (default: %(default)s)")
+    args = parser.parse_args()
+
+    baseline = read_results(args.baseline)
+    current = read_results(args.current)
+    regressions = 0
+
+    for key, result in sorted(current.items()):
+        name = " ".join(f"{k}={v}" for k, v in key)
+        if key not in baseline:
+            print(f"new: {name}")
+            continue
+        for metric, value in result.items():
+            old = baseline[key].get(metric)
+            if metric in KEYS or metric in IGNORED or not isinstance(old, (int, float)):
+                continue
+            change = value - old if metric not in HIGHER_IS_BETTER else old - value
+            # Small absolute values, such as a few dropped records, use the tolerance as a floor
+            if change > max(abs(old), 1) * args.tolerance / 100:
+                print(f"regression: {name} {metric} {old} -> {value}")
+                regressions += 1
+
+    for key in baseline.keys() - current.keys():
+        print("missing: " + " ".join(f"{k}={v}" for k, v in key))
+        regressions += 1
+
+    print(f"{len(current)} results compared, {regressions} regressions")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
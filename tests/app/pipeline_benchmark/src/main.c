@@ -0,0 +1,405 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file pipeline benchmark
+ *
+ * This suite drives the data pipeline of the application, from the
+ * producers' lanes through the application buffer to a channel that
+ * encodes every record, with synthetic producers at increasing rates.
+ *
+ * Results are printed as one JSON object per line, after BENCHMARK_PREFIX,
+ * so runs can be compared by compare_benchmark.py. On native_sim, time
+ * only advances while threads wait, so latencies and rates reflect how
+ * the pipeline schedules records and the modeled link, and cycle counts
+ * of the encoders are only meaningful on hardware.
+ */
+
+#include <stdlib.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <communication/comm_interface.h>
+#include <communication/uart/uart_interface.h>
+#include <sensors/sensors_interface.h>
+#include <sensors/bme280/bme280_service.h>
+
+#define BENCHMARK_PREFIX "BENCHMARK "
+
+#define NUM_PRODUCERS 2
+#define PRODUCER_STACK_SIZE 1024
+#define PRODUCER_PERIOD_MS 1
+
+/* The benchmark channel registers the only cursor of the buffer */
+#define BENCHMARK_CURSOR 0
+#define ENCODED_SIZE 256
+#define UART_BITS_PER_BYTE 10
+
+#define DRAIN_TIMEOUT_MS 60000
+#define DRAIN_POLL_MS 10
+#define ENCODER_RECORDS 1000
+/* Records inserted before the lane is drained, well within half a lane */
+#define PRODUCER_BURST 16
+#define PRODUCER_BURSTS 64
+
+/* Total rates of the producers at each stage, in records per second */
+static const uint32_t stage_rates[] = {50, 100, 200, 400, 800, 1600};
+
+struct producer {
+	struct k_thread thread;
+	struct k_sem start;
+	/* Records per second inserted during the current stage */
+	uint32_t rate;
+	uint32_t produced;
+};
+
+struct stage_result {
+	uint32_t rate;
+	uint32_t produced;
+	uint32_t received;
+	/* Records received before the producers stopped */
+	uint32_t received_in_stage;
+	uint32_t dropped;
+	uint32_t skipped;
+	uint32_t p50_us;
+	uint32_t p99_us;
+	uint32_t max_us;
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(producer_stacks, NUM_PRODUCERS, PRODUCER_STACK_SIZE);
+static struct producer producers[NUM_PRODUCERS];
+static K_SEM_DEFINE(producers_done, 0, NUM_PRODUCERS);
+
+static K_THREAD_STACK_DEFINE(channel_stack, UART_THREAD_STACK_SIZE);
+static struct k_thread channel_thread;
+static ChannelAPI benchmark_channel_api;
+
+/* Written by the channel thread, read by the test once the stage is drained */
+static atomic_t received_records;
+static atomic_t num_latencies;
+static uint32_t latencies_us[CONFIG_BENCHMARK_MAX_LATENCY_SAMPLES];
+
+/* Writes a record in place in the producer's lane, as the sensor services do */
+static int produce_record(uint32_t sequence)
+{
+	BufferReservation reservation;
+	SensorModelBME280 *model;
+	int error = reserve_app_buffer_item(&reservation, BME280_MODEL, 0, BME280_MODEL_WORDS);
+
+	if (error) {
+		return error;
+	}
+	/* Readings change slowly, as the ones of a real sensor */
+	model = (SensorModelBME280 *)reservation.data_words;
+	model->timestamp = k_cycle_get_32();
+	model->pressure = 101325;
+	model->temperature = 2500 + sequence % 100;
+	model->humidity = 5000 + sequence % 50;
+	commit_app_buffer_item(&reservation);
+	return 0;
+}
+
+/* Builds the record on the stack and copies it into the lane */
+static int produce_copied_record(uint32_t sequence)
+{
+	SensorModelBME280 model = {
+		.timestamp = k_cycle_get_32(),
+		.pressure = 101325,
+		.temperature = 2500 + sequence % 100,
+		.humidity = 5000 + sequence % 50,
+	};
+
+	return insert_in_app_buffer((uint32_t *)&model, BME280_MODEL, 0, BME280_MODEL_WORDS);
+}
+
+static void produce(void *param0, void *param1, void *param2)
+{
+	struct producer *producer = param0;
+
+	ARG_UNUSED(param1);
+	ARG_UNUSED(param2);
+
+	register_buffer_producer(k_current_get());
+	while (1) {
+		k_sem_take(&producer->start, K_FOREVER);
+
+		int64_t start = k_uptime_get();
+		int64_t elapsed = 0;
+
+		while (elapsed < CONFIG_BENCHMARK_STAGE_DURATION) {
+			k_sleep(K_TIMEOUT_ABS_MS(start + elapsed + PRODUCER_PERIOD_MS));
+			elapsed = MIN(k_uptime_get() - start, CONFIG_BENCHMARK_STAGE_DURATION);
+
+			/* Inserts every record due since the stage started, so the
+			 * rate doesn't depend on the tick or on late wake-ups
+			 */
+			uint32_t due = (uint64_t)producer->rate * elapsed / MSEC_PER_SEC;
+
+			while (producer->produced < due) {
+				produce_record(producer->produced);
+				producer->produced++;
+			}
+		}
+		k_sem_give(&producers_done);
+	}
+}
+
+/* Holds the records for as long as the modeled link takes to send them */
+static void transmit(void *param0, void *param1, void *param2)
+{
+	const uint8_t *encoded_data;
+	CommunicationUnit units[CONFIG_TRANSMISSION_BATCH_SIZE];
+
+	ARG_UNUSED(param0);
+	ARG_UNUSED(param1);
+	ARG_UNUSED(param2);
+
+	while (1) {
+		int num_units = get_channel_data(UART, units, CONFIG_TRANSMISSION_BATCH_SIZE);
+		uint32_t now = k_cycle_get_32();
+
+		for (int i = 0; i < num_units; i++) {
+			if (units[i].data_type != BME280_MODEL) {
+				continue;
+			}
+
+			SensorModelBME280 *model = (SensorModelBME280 *)units[i].data_words;
+			uint32_t sample = atomic_inc(&num_latencies);
+
+			if (sample < ARRAY_SIZE(latencies_us)) {
+				latencies_us[sample] = k_cyc_to_us_floor32(now - model->timestamp);
+			}
+
+			int size = get_encoded_unit(UART, &units[i], &encoded_data);
+			if (size > 0) {
+				k_busy_wait((uint64_t)size * UART_BITS_PER_BYTE * USEC_PER_SEC /
+					    CONFIG_BENCHMARK_LINK_BAUDRATE);
+			}
+			atomic_inc(&received_records);
+		}
+		release_channel_data(UART);
+	}
+}
+
+static int start_channel(void)
+{
+	k_tid_t channel_id = k_thread_create(&channel_thread, channel_stack,
+					     K_THREAD_STACK_SIZEOF(channel_stack), transmit,
+					     NULL, NULL, NULL, UART_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+	k_thread_name_set(channel_id, "benchmark_channel");
+	return 0;
+}
+
+/* Stands in for the UART channel, so the pipeline is built as in the application */
+ChannelAPI *register_uart_callbacks()
+{
+	benchmark_channel_api.init_channel = start_channel;
+	benchmark_channel_api.encoding = VERBOSE;
+	benchmark_channel_api.transmission_interval = CONFIG_TRANSMISSION_INTERVAL;
+	return &benchmark_channel_api;
+}
+
+static int compare_latencies(const void *a, const void *b)
+{
+	uint32_t latency_a = *(const uint32_t *)a;
+	uint32_t latency_b = *(const uint32_t *)b;
+
+	return (latency_a > latency_b) - (latency_a < latency_b);
+}
+
+static void run_stage(uint32_t rate, struct stage_result *result)
+{
+	uint32_t dropped = get_dropped_items(BME280_MODEL);
+	uint32_t skipped = get_cursor_skipped_items(BENCHMARK_CURSOR);
+
+	*result = (struct stage_result){.rate = rate};
+	atomic_set(&received_records, 0);
+	atomic_set(&num_latencies, 0);
+
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		producers[i].rate = rate / NUM_PRODUCERS;
+		producers[i].produced = 0;
+		k_sem_give(&producers[i].start);
+	}
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		k_sem_take(&producers_done, K_FOREVER);
+		result->produced += producers[i].produced;
+	}
+	result->received_in_stage = atomic_get(&received_records);
+
+	/* Every record is either received or counted as dropped by the buffer */
+	for (int waited = 0; waited < DRAIN_TIMEOUT_MS; waited += DRAIN_POLL_MS) {
+		result->received = atomic_get(&received_records);
+		result->dropped = get_dropped_items(BME280_MODEL) - dropped;
+		if (result->received + result->dropped >= result->produced) {
+			break;
+		}
+		k_sleep(K_MSEC(DRAIN_POLL_MS));
+	}
+	result->skipped = get_cursor_skipped_items(BENCHMARK_CURSOR) - skipped;
+
+	size_t samples = MIN((size_t)atomic_get(&num_latencies), ARRAY_SIZE(latencies_us));
+
+	if (samples > 0) {
+		qsort(latencies_us, samples, sizeof(latencies_us[0]), compare_latencies);
+		result->p50_us = latencies_us[samples * 50 / 100];
+		result->p99_us = latencies_us[samples * 99 / 100];
+		result->max_us = latencies_us[samples - 1];
+	}
+}
+
+static void print_stack_usage(const struct k_thread *thread, void *user_data)
+{
+	size_t unused;
+
+	ARG_UNUSED(user_data);
+
+	if (k_thread_stack_space_get(thread, &unused) != 0) {
+		return;
+	}
+	printk(BENCHMARK_PREFIX "{\"thread\":\"%s\",\"stack_size\":%u,\"stack_used\":%u}\n",
+	       k_thread_name_get((k_tid_t)thread), (unsigned int)thread->stack_info.size,
+	       (unsigned int)(thread->stack_info.size - unused));
+}
+
+ZTEST(pipeline_benchmark, test_encoders)
+{
+	static const struct {
+		enum EncodingLevel encoding;
+		const char *name;
+	} encodings[] = {
+		{VERBOSE, "verbose"},
+		{MINIMALIST, "minimalist"},
+		{RAW_BYTES, "raw_bytes"},
+		{PACKED_BINARY, "packed_binary"},
+	};
+	SensorModelBME280 model = {
+		.pressure = 101325,
+		.temperature = 2500,
+		.humidity = 5000,
+	};
+	uint8_t encoded_data[ENCODED_SIZE];
+
+	for (int i = 0; i < ARRAY_SIZE(encodings); i++) {
+		uint32_t start = k_cycle_get_32();
+		int size = 0;
+
+		for (int record = 0; record < ENCODER_RECORDS; record++) {
+			model.timestamp = record;
+			size = encode_data((uint32_t *)&model, BME280_MODEL, encodings[i].encoding,
+					   encoded_data, sizeof(encoded_data));
+			zassert_true(size > 0, "%s encoding failed: %d", encodings[i].name, size);
+		}
+
+		uint32_t cycles = k_cycle_get_32() - start;
+
+		printk(BENCHMARK_PREFIX "{\"encoder\":\"%s\",\"data_type\":\"bme280\","
+		       "\"bytes\":%d,\"cycles_per_record\":%u}\n",
+		       encodings[i].name, size, cycles / ENCODER_RECORDS);
+	}
+}
+
+ZTEST(pipeline_benchmark, test_producers)
+{
+	static const struct {
+		const char *name;
+		int (*produce)(uint32_t sequence);
+	} producer_apis[] = {
+		{"copy", produce_copied_record},
+		{"reserve", produce_record},
+	};
+
+	/* Measures the producer's own lane, as the sensor thread uses */
+	zassert_ok(register_buffer_producer(k_current_get()));
+	for (int i = 0; i < ARRAY_SIZE(producer_apis); i++) {
+		uint32_t dropped = get_dropped_items(BME280_MODEL);
+		uint32_t received = atomic_get(&received_records);
+		uint32_t cycles = 0;
+
+		for (int burst = 0; burst < PRODUCER_BURSTS; burst++) {
+			uint32_t start = k_cycle_get_32();
+
+			for (int record = 0; record < PRODUCER_BURST; record++) {
+				zassert_ok(producer_apis[i].produce(record), "%s producer failed",
+					   producer_apis[i].name);
+			}
+			cycles += k_cycle_get_32() - start;
+
+			/* Lets the channel drain the lane, so the next burst fits in it */
+			for (int waited = 0; waited < DRAIN_TIMEOUT_MS; waited += DRAIN_POLL_MS) {
+				if (atomic_get(&received_records) - received >=
+				    (burst + 1) * PRODUCER_BURST) {
+					break;
+				}
+				k_sleep(K_MSEC(DRAIN_POLL_MS));
+			}
+		}
+
+		zassert_equal(get_dropped_items(BME280_MODEL), dropped,
+			      "%s producer dropped records", producer_apis[i].name);
+		printk(BENCHMARK_PREFIX "{\"producer\":\"%s\",\"data_type\":\"bme280\","
+		       "\"cycles_per_record\":%u}\n",
+		       producer_apis[i].name, cycles / (PRODUCER_BURSTS * PRODUCER_BURST));
+	}
+	unregister_buffer_producer(k_current_get());
+}
+
+ZTEST(pipeline_benchmark, test_rate_sweep)
+{
+	struct stage_result result;
+
+	for (int i = 0; i < ARRAY_SIZE(stage_rates); i++) {
+		run_stage(stage_rates[i], &result);
+
+		printk(BENCHMARK_PREFIX "{\"rate\":%u,\"produced\":%u,\"received\":%u,"
+		       "\"records_per_s\":%u,\"p50_us\":%u,\"p99_us\":%u,\"max_us\":%u,"
+		       "\"dropped\":%u,\"skipped\":%u}\n",
+		       result.rate, result.produced, result.received,
+		       (uint32_t)((uint64_t)result.received_in_stage * MSEC_PER_SEC /
+				  CONFIG_BENCHMARK_STAGE_DURATION),
+		       result.p50_us, result.p99_us, result.max_us, result.dropped,
+		       result.skipped);
+
+		zassert_equal(result.received + result.dropped, result.produced,
+			      "%u records unaccounted for at %u records/s",
+			      result.produced - result.received - result.dropped, result.rate);
+		/* The slowest rate is well within what the link can send */
+		if (i == 0) {
+			zassert_equal(result.dropped, 0, "Records dropped at %u records/s",
+				      result.rate);
+		}
+	}
+
+	k_thread_foreach(print_stack_usage, NULL);
+}
+
+static void *pipeline_benchmark_setup(void)
+{
+	static SensorAPI bme280_api;
+
+	/* Producers stand in for the BME280, of which only the model is built */
+	bme280_api.data_model_api = register_bme280_model_callbacks();
+	sensor_apis[BME280] = &bme280_api;
+	register_data_callbacks();
+	register_comm_callbacks();
+	init_communication();
+
+	for (int i = 0; i < NUM_PRODUCERS; i++) {
+		char name[CONFIG_THREAD_MAX_NAME_LEN];
+		k_tid_t producer_id;
+
+		k_sem_init(&producers[i].start, 0, 1);
+		producer_id = k_thread_create(&producers[i].thread, producer_stacks[i],
+					      K_THREAD_STACK_SIZEOF(producer_stacks[i]), produce,
+					      &producers[i], NULL, NULL, SENSORS_THREAD_PRIORITY, 0,
+					      K_NO_WAIT);
+		snprintk(name, sizeof(name), "producer%d", i);
+		k_thread_name_set(producer_id, name);
+	}
+	return NULL;
+}
+
+ZTEST_SUITE(pipeline_benchmark, NULL, pipeline_benchmark_setup, NULL, NULL, NULL);
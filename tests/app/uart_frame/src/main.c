@@ -0,0 +1,202 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file UART frame tests
+ *
+ * This suite encodes frames of the UART channel and checks them against a
+ * frame encoded by hand and decoded by app/scripts/uart_offload_receiver.py,
+ * and decodes them back with the same COBS decoding as the script: runs of
+ * non-zero bytes around the 254-byte limit of a COBS block, a full frame,
+ * the CRC after the records, and buffers too small for the frame, which
+ * must not be written past their end.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/ztest.h>
+
+#include <communication/uart/uart_frame.h>
+
+#define COBS_MAX_BLOCK 254
+/* Written past the end of the encoding buffer to detect overflows */
+#define GUARD_BYTE 0x55
+
+static UartFrame frame;
+static uint8_t encoded[UART_FRAME_ENCODED_SIZE + 16];
+static uint8_t decoded[UART_FRAME_DATA_SIZE + COBS_MAX_BLOCK];
+
+/* Decodes the bytes between the delimiters as the receiver script does, and
+ * returns the number of bytes decoded, or -EINVAL if the encoding is invalid
+ */
+static int cobs_decode(const uint8_t *data, size_t length)
+{
+	size_t decoded_length = 0;
+	size_t i = 0;
+
+	while (i < length) {
+		uint8_t code = data[i];
+
+		if (code == 0 || i + code > length) {
+			return -EINVAL;
+		}
+		memcpy(&decoded[decoded_length], &data[i + 1], code - 1);
+		decoded_length += code - 1;
+		i += code;
+		if (code < 0xFF && i < length) {
+			decoded[decoded_length++] = 0;
+		}
+	}
+	return decoded_length;
+}
+
+/* Checks the frame is between delimiters, has no other zero bytes, and decodes
+ * to its bytes followed by their CRC
+ */
+static void assert_roundtrip(int encoded_size)
+{
+	int decoded_size;
+
+	zassert_true(encoded_size > 2, "Encoded %d bytes", encoded_size);
+	zassert_equal(encoded[0], 0, "Frame doesn't start with a delimiter");
+	zassert_equal(encoded[encoded_size - 1], 0, "Frame doesn't end with a delimiter");
+	for (int i = 1; i < encoded_size - 1; i++) {
+		zassert_not_equal(encoded[i], 0, "Zero byte at %d of the encoded frame", i);
+	}
+
+	decoded_size = cobs_decode(&encoded[1], encoded_size - 2);
+	zassert_equal(decoded_size, frame.length + UART_FRAME_CRC_SIZE,
+		      "Decoded %d bytes instead of %d", decoded_size,
+		      (int)frame.length + UART_FRAME_CRC_SIZE);
+	zassert_mem_equal(decoded, frame.data, frame.length, "Frame decoded with other bytes");
+	zassert_equal(sys_get_le16(&decoded[frame.length]),
+		      crc16_ccitt(0xFFFF, frame.data, frame.length), "Wrong CRC after the records");
+}
+
+/* Starts a frame whose sequence number and single record have no zero bytes,
+ * so the frame is a run of `run_length` non-zero bytes before the CRC
+ */
+static void make_zero_free_frame(size_t run_length)
+{
+	static uint8_t raw_bytes[UINT8_MAX];
+
+	memset(raw_bytes, 0xAA, sizeof(raw_bytes));
+	start_uart_frame(&frame, 0x0101);
+	zassert_ok(append_uart_frame_record(&frame, VBATT_MODEL, raw_bytes,
+					    run_length - UART_FRAME_SEQUENCE_SIZE - 2));
+	zassert_equal(frame.length, run_length);
+}
+
+ZTEST(uart_frame, test_golden_frame)
+{
+	/* Battery reading of 3600 mV in the frame of sequence number 256, whose
+	 * zero bytes are replaced by COBS. The receiver script decodes these bytes
+	 * to the frame and accepts its CRC
+	 */
+	static const uint8_t raw_bytes[] = {0x10, 0x0E, 0x00, 0x00};
+	static const uint8_t golden[] = {0x00, 0x01, 0x06, 0x01, 0x08, 0x04, 0x10,
+					 0x0E, 0x01, 0x03, 0xAB, 0x3C, 0x00};
+	int size;
+
+	zassert_equal(VBATT_MODEL, 0x08, "Golden frame has another data type");
+	start_uart_frame(&frame, 0x0100);
+	zassert_true(uart_frame_is_empty(&frame));
+	zassert_ok(append_uart_frame_record(&frame, VBATT_MODEL, raw_bytes, sizeof(raw_bytes)));
+	zassert_false(uart_frame_is_empty(&frame));
+
+	size = encode_uart_frame(&frame, encoded, sizeof(encoded));
+	zassert_equal(size, sizeof(golden), "Encoded %d bytes instead of %d", size,
+		      (int)sizeof(golden));
+	zassert_mem_equal(encoded, golden, sizeof(golden), "Frame differs from the golden one");
+	assert_roundtrip(size);
+}
+
+ZTEST(uart_frame, test_crc)
+{
+	/* Check value of the CRC-16/CCITT variant the receiver script computes */
+	zassert_equal(crc16_ccitt(0xFFFF, (const uint8_t *)"123456789", 9), 0x6F91);
+
+	/* CRC covers the sequence number and every record */
+	for (uint16_t sequence = 0; sequence < 4; sequence++) {
+		uint8_t raw_bytes[] = {sequence, 0x00, 0xFF};
+
+		start_uart_frame(&frame, sequence);
+		for (int i = 0; i <= sequence; i++) {
+			zassert_ok(append_uart_frame_record(&frame, BME280_MODEL + i, raw_bytes,
+							    sizeof(raw_bytes)));
+		}
+		assert_roundtrip(encode_uart_frame(&frame, encoded, sizeof(encoded)));
+	}
+}
+
+ZTEST(uart_frame, test_zero_free_run)
+{
+	int size;
+
+	/* 254 non-zero bytes fill a COBS block, which ends without a zero */
+	make_zero_free_frame(COBS_MAX_BLOCK);
+	size = encode_uart_frame(&frame, encoded, sizeof(encoded));
+	zassert_equal(encoded[1], 0xFF, "Full block has code 0x%02x", encoded[1]);
+	zassert_mem_equal(&encoded[2], frame.data, COBS_MAX_BLOCK, "Full block changed");
+	assert_roundtrip(size);
+
+	/* Runs just shorter and longer than a block */
+	for (size_t run_length = COBS_MAX_BLOCK - 3; run_length <= COBS_MAX_BLOCK + 3;
+	     run_length++) {
+		make_zero_free_frame(run_length);
+		assert_roundtrip(encode_uart_frame(&frame, encoded, sizeof(encoded)));
+	}
+}
+
+ZTEST(uart_frame, test_full_frame)
+{
+	static uint8_t raw_bytes[UINT8_MAX];
+	size_t size = UINT8_MAX;
+
+	/* Records without zeros need the most COBS codes */
+	memset(raw_bytes, 0xAA, sizeof(raw_bytes));
+	start_uart_frame(&frame, 0xFFFF);
+	while (size > 0) {
+		if (append_uart_frame_record(&frame, GNSS_MODEL, raw_bytes, size) == -ENOMEM) {
+			size--;
+		}
+	}
+	zassert_equal(frame.length, UART_FRAME_SEQUENCE_SIZE + UART_FRAME_RECORDS_SIZE);
+	zassert_equal(append_uart_frame_record(&frame, GNSS_MODEL, raw_bytes, 0), -ENOMEM);
+	zassert_equal(append_uart_frame_record(&frame, GNSS_MODEL, raw_bytes, UINT8_MAX + 1),
+		      -ENOMEM);
+
+	assert_roundtrip(encode_uart_frame(&frame, encoded, UART_FRAME_ENCODED_SIZE));
+}
+
+ZTEST(uart_frame, test_no_space)
+{
+	uint8_t full_encoding[UART_FRAME_ENCODED_SIZE];
+	int size;
+
+	make_zero_free_frame(COBS_MAX_BLOCK);
+	size = encode_uart_frame(&frame, full_encoding, sizeof(full_encoding));
+	zassert_true(size > 0);
+
+	/* Smaller buffers are rejected without writing past their end */
+	for (int encoded_size = 0; encoded_size < size; encoded_size++) {
+		memset(encoded, GUARD_BYTE, sizeof(encoded));
+		zassert_equal(encode_uart_frame(&frame, encoded, encoded_size), -ENOMEM,
+			      "Frame of %d bytes encoded in %d", size, encoded_size);
+		for (int i = encoded_size; i < sizeof(encoded); i++) {
+			zassert_equal(encoded[i], GUARD_BYTE, "Byte %d written in buffer of %d", i,
+				      encoded_size);
+		}
+	}
+
+	/* The frame is left as it was, so it's encoded again in a larger buffer */
+	zassert_equal(encode_uart_frame(&frame, encoded, size), size);
+	zassert_mem_equal(encoded, full_encoding, size, "Frame encoded again differs");
+	assert_roundtrip(size);
+}
+
+ZTEST_SUITE(uart_frame, NULL, NULL, NULL, NULL, NULL);